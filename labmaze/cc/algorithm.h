@@ -16,16 +16,28 @@
 #ifndef LABMAZE_CC_ALGORITHM_H_
 #define LABMAZE_CC_ALGORITHM_H_
 
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <random>
+#include <utility>
 #include <vector>
 
+#include "labmaze/cc/bitboard.h"
 #include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/connected_components.h"
+#include "labmaze/cc/flood_fill.h"
 #include "labmaze/cc/text_maze.h"
 
 namespace deepmind {
 namespace labmaze {
 
+// The functions below that take a maze are templates over its type 'Maze',
+// which is either TextMaze or StaticTextMaze. Both provide the cell, id and
+// visitor interface of TextMaze used here.
+
 // Creates a TextMaze setting the entity layer from a CharGrid.
 TextMaze FromCharGrid(const CharGrid& entity_layer);
 
@@ -37,9 +49,20 @@ TextMaze FromCharGrid(const CharGrid& entity_layer,
 // are not corridors, dead-ends or T-junctions.
 // 'text_maze' entity layer is examined for rooms.
 // 'wall_chars' are characters in text maze that are non-traversable.
-std::vector<std::vector<Pos>> FindRooms(const TextMaze& text_maze,
+// Rooms are ordered by their first cell in row-major order, and so are the
+// cells of each room.
+template <typename Maze>
+std::vector<std::vector<Pos>> FindRooms(const Maze& text_maze,
                                         const std::vector<char>& wall_chars);
 
+// Returns the rooms of FindRooms as the components of a ConnectedComponents,
+// which holds all rooms in a few flat arrays. Labelling uses up to
+// 'num_threads' threads; see LabelComponentsParallel.
+template <typename Maze>
+ConnectedComponents FindRoomComponents(const Maze& text_maze,
+                                       const std::vector<char>& wall_chars,
+                                       int num_threads = 1);
+
 // Set of parameters used for making separated rectangles.
 // See MakeRandomRectangle in implementation to understand the shape and
 // distribution of rectangles generated.
@@ -73,36 +96,67 @@ std::vector<Rectangle> MakeSeparateRectangles(
 // Removes dead-ends from the entity layer of the maze by filling them with
 // 'wall'. A dead-end is an cell containing 'empty' next to three or more cells
 // that are either containing wall or wall_chars, or out of bounds.
+template <typename Maze>
 void RemoveDeadEnds(char empty, char wall, const std::vector<char>& wall_chars,
-                    TextMaze* text_maze);
+                    Maze* text_maze);
 
 // Implements the recursive backtracking maze generation algorithm, starting
 // from 'pos' and spreading across space with the same id value, and replacing
 // it with 'maze_id'.
+template <typename Maze>
 void FillWithMaze(         //
     const Pos& pos,        //
     unsigned int maze_id,  //
-    TextMaze* text_maze,   //
+    Maze* text_maze,       //
     std::mt19937_64* prbg);
 
 // Iteratively invokes FillWithMaze for all positions within text_maze with
 // id value 'fill_id', assigning sequential id values to each maze sequence
 // starting from 'start_id'.
+template <typename Maze>
 void FillSpaceWithMaze(     //
     unsigned int start_id,  //
     unsigned int fill_id,   //
-    TextMaze* text_maze,    //
+    Maze* text_maze,        //
     std::mt19937_64* prbg);
 
+// A door between two regions of the id layer: the cell at 'pos' joins region
+// 'id_0' at pos - direction to region 'id_1' at pos + direction.
+struct RegionDoor {
+  unsigned int id_0;
+  unsigned int id_1;
+  Pos pos;
+  Vec direction;
+};
+
+// Returns every cell that could join two adjacent regions of the id layer, as
+// found from the cells with odd coordinates. Each door has id_0 < id_1. Doors
+// are sorted by (id_0, id_1), and the doors between each pair of regions are in
+// the order of internal::VisitOddIds.
+template <typename Maze>
+std::vector<RegionDoor> FindRegionDoors(const Maze& text_maze);
+
 // Locates connections between adjacent regions in the id layer, placing
 // value 'connector' in the relevant positions of the entity layer. At least one
 // connection will be identified between each pair of adjacent regions, with
 // additional connections created with probability 'extra_probability'.
-// Returns a vector with the position and directions of the connections.
+// Returns the connections made: the edges of the graph whose nodes are the
+// region ids. The first connection of each pair of regions comes first, in the
+// order of FindRegionDoors, followed by the additional ones.
+template <typename Maze>
+std::vector<RegionDoor> RandomConnectRegionGraph(  //
+    char connector,                                //
+    double extra_probability,                      //
+    Maze* text_maze,                               //
+    std::mt19937_64* prbg);
+
+// Like RandomConnectRegionGraph, but returns only the position and direction
+// of each connection.
+template <typename Maze>
 std::vector<std::pair<Pos, Vec>> RandomConnectRegions(  //
     char connector,                                     //
     double extra_probability,                           //
-    TextMaze* text_maze,                                //
+    Maze* text_maze,                                    //
     std::mt19937_64* prbg);
 
 // Simplifies all corridors in 'text_maze' by removing horseshoe bends of a
@@ -140,39 +194,663 @@ std::vector<std::pair<Pos, Vec>> RandomConnectRegions(  //
 //      AA*******                 AA*******                 AA*******
 //
 // Returns whether any bends were removed.
+template <typename Maze>
 bool RemoveHorseshoeBends(                //
     int bend_size,                        //
     char wall,                            //
     const std::vector<char>& wall_chars,  //
-    TextMaze* text_maze);
+    Maze* text_maze);
 
 // Removes horseshoe bends of all sizes in all maze corridors.
+template <typename Maze>
 void RemoveAllHorseshoeBends(             //
     char wall,                            //
     const std::vector<char>& wall_chars,  //
-    TextMaze* text_maze);
+    Maze* text_maze);
 
 // For each region in 'rooms', attempts to set 'n' random cells to value
 // 'entity' in the entity layer of 'text_maze'. This only operates on cells
 // currently set to value 'empty'.
+template <typename Maze>
 void AddNEntitiesToEachRoom(              //
     const std::vector<Rectangle>& rooms,  //
     int n,                                //
     char entity,                          //
     char empty,                           //
-    TextMaze* text_maze,                  //
+    Maze* text_maze,                      //
     std::mt19937_64* prbg);
 
+// Sets the variations layer of 'text_maze' at each cell whose id is that of a
+// room, 1 to 'num_rooms', to one of 'max_variations' letters from 'A' that
+// depends on the id. 'text_maze' shall have an id layer.
+template <typename Maze>
+void AddRoomVariations(unsigned int num_rooms, int max_variations,
+                       Maze* text_maze);
+
 // Attempts to find in 'text_maze' a random path between positions 'from' and
 // 'to', while considering as walls the characters in 'wall_chars'. If
 // successful, the function returns a vector of the path positions, in order of
 // traversal. Otherwise it returns an empty vector.
+template <typename Maze>
+std::vector<Pos> FindRandomPath(          //
+    const Pos& from,                      //
+    const Pos& to,                        //
+    const std::vector<char>& wall_chars,  //
+    Maze* text_maze,                      //
+    std::mt19937_64* prbg);
+
+// Implementation details.
+
+namespace internal {
+
+// Contains Left, Right, Down, Up.
+inline std::array<Vec, 4> PathDirections() {
+  return {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+}
+
+// Returns a list of visitable directions containing fill_variation from a
+// position step_size away.
+template <typename Maze>
+std::vector<Vec> PossibleDirections(  //
+    const Maze& text_maze,            //
+    const Pos& pos,                   //
+    unsigned int fill_id,             //
+    int step_size) {
+  std::vector<Vec> result;
+  auto rect = text_maze.Area();
+  for (const auto& direction : PathDirections()) {
+    Pos two_step = pos + step_size * direction;
+    if (rect.InBounds(two_step) && text_maze.GetCellId(two_step) == fill_id) {
+      result.push_back(direction);
+    }
+  }
+  return result;
+}
+
+// Visit the id layer at odd positions in a maze.
+template <typename Maze, typename F>
+void VisitOddIds(const Maze& text_maze, F&& f) {
+  auto rect = text_maze.Area();
+  auto next_odd = [](int v) -> int { return v | 1; };
+  for (int i = next_odd(rect.pos.row); i < rect.pos.row + rect.size.height;
+       i += 2) {
+    for (int j = next_odd(rect.pos.col); j < rect.pos.col + rect.size.width;
+         j += 2) {
+      f(i, j, text_maze.GetCellId({i, j}));
+    }
+  }
+}
+
+template <typename Maze>
+bool RemoveHorseshoeBendAtPos(            //
+    Pos pos,                              //
+    int bend_size,                        //
+    char wall,                            //
+    const std::vector<char>& wall_chars,  //
+    Maze* text_maze) {
+  auto is_wall_char = internal::MakeCharBoolMap(wall_chars);
+  is_wall_char[static_cast<unsigned char>(wall)] = true;
+  auto is_corridor = [text_maze](const Pos pos) {
+    return text_maze->GetCell(TextMaze::kEntityLayer, pos) == ' ';
+  };
+
+  auto is_wall = [text_maze, &is_wall_char](const Pos pos) {
+    return is_wall_char[static_cast<unsigned char>(
+        text_maze->GetCell(TextMaze::kEntityLayer, pos))];
+  };
+
+  bool bends_removed = false;
+  bool found = false;
+  do {
+    found = false;
+    if (!is_wall(pos)) {
+      break;
+    }
+    for (const auto& v_dir : PathDirections()) {
+      const Vec u_dir = {v_dir.d_col, -v_dir.d_row};
+      //
+      // Input configuration:                Output configuration:
+      // origin (0, 0) is wall               origin (0, 0) is corridor
+      //
+      //     v  bend_size                        v
+      //     ^   <----->                         ^
+      //    2| ?*********?                      2| ?*********?
+      //    1| *         *                      1| ***********
+      //    0| ? ******* ?                      0| ?         ?
+      //    m| ??*******??                      m| ??*******??
+      //     ...---------->u                     ...---------->u
+      //       nm0123...po                         nm0123...po
+      //
+      bool ok = true;
+      // pos_u0 and pos_um must be wall for u in [0, bend_size -1]
+      for (int u = 0; u < bend_size; ++u) {
+        Pos pos_u0 = pos + u * u_dir;
+        Pos pos_um = pos + u * u_dir - v_dir;
+        if (!is_wall(pos_u0) || !is_wall(pos_um)) {
+          ok = false;
+          break;
+        }
+      }
+      if (!ok) {
+        continue;
+      }
+      // pos_u1 must be corridor for u in [-1, bend_size]
+      for (int u = -1; u <= bend_size; ++u) {
+        Pos pos_u1 = pos + u * u_dir + v_dir;
+        if (!is_corridor(pos_u1)) {
+          ok = false;
+          break;
+        }
+      }
+      if (!ok) {
+        continue;
+      }
+      // pos_u2 must be wall for u in [-1, bend_size]
+      for (int u = -1; u <= bend_size; ++u) {
+        Pos pos_u2 = pos + u * u_dir + 2 * v_dir;
+        if (!is_wall(pos_u2)) {
+          ok = false;
+          break;
+        }
+      }
+      if (!ok) {
+        continue;
+      }
+      // pos_n1 and pos_o1 must be wall
+      Pos pos_n1 = pos - 2 * u_dir + v_dir;
+      Pos pos_o1 = pos + (bend_size + 1) * u_dir + v_dir;
+      if (!is_wall(pos_n1) || !is_wall(pos_o1)) {
+        continue;
+      }
+
+      // pos_m0 and pos_p0 must be corridor
+      Pos pos_m0 = pos - u_dir;
+      Pos pos_p0 = pos + bend_size * u_dir;
+      if (!is_corridor(pos_m0) || !is_corridor(pos_p0)) {
+        continue;
+      }
+
+      // pull the string
+      bends_removed = true;
+      for (int u = -1; u <= bend_size; ++u) {
+        Pos pos_u1 = pos + u * u_dir + v_dir;
+        if (u >= 0 && u < bend_size) {
+          Pos pos_u0 = pos + u * u_dir;
+          text_maze->SetCell(
+              TextMaze::kEntityLayer, pos_u0,
+              text_maze->GetCell(TextMaze::kEntityLayer, pos_u1));
+        }
+        text_maze->SetCell(TextMaze::kEntityLayer, pos_u1, wall);
+      }
+      // move pos to pos_0m
+      pos = pos - v_dir;
+      found = true;
+      break;
+    }
+  } while (found);
+  return bends_removed;
+}
+
+// Returns a grid with -1 in the room cells of 'text_maze', as defined by
+// FindRooms, and -2 elsewhere. This is the reference for FindRoomCells, which
+// FindRooms uses instead when the maze fits in a Bitboard.
+template <typename Maze>
+BorderedGrid<int> MarkRoomCells(const Maze& text_maze,
+                                const CharBoolMap& is_wall_char) {
+  const auto& area = text_maze.Area();
+  BorderedGrid<int> distances(area.size, -2, -1);
+
+  // Mark all non-traversable cells with -2 and traversable with -1.
+  text_maze.VisitRows(
+      TextMaze::kEntityLayer,
+      [&distances, &is_wall_char](int i, int j, const char* cells, int count) {
+        int* row = &distances[distances.Index(i, j)];
+        for (int k = 0; k < count; ++k) {
+          row[k] = is_wall_char[static_cast<unsigned char>(cells[k])] ? -2 : -1;
+        }
+      });
+
+  // Next sections find corridors, T-junctions and dead-ends and marks them
+  // as also non-traversable.
+
+  auto distances_lookup = [&distances](int i, int j) -> int& {
+    return distances[distances.Index(i, j)];
+  };
+
+  // Shares the layout of 'distances', border included, to save having to do
+  // boundary checks.
+  std::vector<std::bitset<8>> adjacent_info((area.size.height + 2) *
+                                            distances.stride());
+
+  // Create lookup into adjacency_info.
+  auto adjacent_lookup =
+      [&distances, &adjacent_info](int i, int j) -> std::bitset<8>& {
+    return adjacent_info[distances.Index(i, j)];
+  };
+
+  // Fill adjacent_info with connectivity information.
+  // The adjencency_info will represent the openings at i, j.
+  //  765
+  //  4 3
+  //  210
+  area.Visit([&distances_lookup, &adjacent_lookup](int i, int j) {
+    bool is_open = distances_lookup(i, j) == -1;
+    adjacent_lookup(i - 1, j - 1)[0] = is_open;
+    adjacent_lookup(i + 0, j - 1)[1] = is_open;
+    adjacent_lookup(i + 1, j - 1)[2] = is_open;
+    adjacent_lookup(i - 1, j + 0)[3] = is_open;
+    adjacent_lookup(i + 1, j + 0)[4] = is_open;
+    adjacent_lookup(i - 1, j + 1)[5] = is_open;
+    adjacent_lookup(i + 0, j + 1)[6] = is_open;
+    adjacent_lookup(i + 1, j + 1)[7] = is_open;
+  });
+
+  // Remove any T-Junctions or L-bends.
+  for (auto& adj : adjacent_info) {
+    adj[1] = adj[1] && (adj[0] || adj[2]);
+    adj[6] = adj[6] && (adj[5] || adj[7]);
+    adj[3] = adj[3] && (adj[0] || adj[5]);
+    adj[4] = adj[4] && (adj[2] || adj[7]);
+  }
+
+  area.Visit([&distances_lookup, &adjacent_lookup](int i, int j) {
+    if (distances_lookup(i, j) != -1) return;
+    auto& adjacency_info = adjacent_lookup(i, j);
+    if ((!adjacency_info[1] && !adjacency_info[6]) ||
+        (!adjacency_info[3] && !adjacency_info[4])) {
+      distances_lookup(i, j) = -2;
+    }
+  });
+  return distances;
+}
+
+// Removes dead ends cell by cell. See RemoveDeadEnds, which uses
+// RemoveDeadEndCells instead when the maze fits in a Bitboard. 'is_wall_char'
+// shall include 'wall'.
+template <typename Maze>
+void RemoveDeadEndsScalar(char empty, char wall,
+                          const CharBoolMap& is_wall_char, Maze* text_maze) {
+  // Out-of-bounds neighbours are not counted as open, so a wall border leaves
+  // the dead-end test unchanged while removing all bounds checks.
+  auto cells = text_maze->BorderedLayer(TextMaze::kEntityLayer, wall);
+  const auto offsets = cells.NeighbourOffsets();
+  text_maze->Area().Visit(
+      [&cells, &offsets, &is_wall_char, empty, wall](int r, int c) {
+        int idx = cells.Index(r, c);
+        while (cells[idx] == empty) {
+          int empty_count = 0;
+          int wall_count = 0;
+          int last_idx = idx;
+          for (int offset : offsets) {
+            const char cell_value = cells[idx + offset];
+            if (cell_value == empty) {
+              last_idx = idx + offset;
+              ++empty_count;
+            } else if (is_wall_char[static_cast<unsigned char>(cell_value)]) {
+              ++wall_count;
+            }
+          }
+          if (wall_count + 1 < static_cast<int>(offsets.size())) {
+            break;
+          }
+          cells[idx] = wall;
+          if (empty_count == 0) {
+            break;
+          }
+          idx = last_idx;
+        }
+      });
+  text_maze->AssignLayer(TextMaze::kEntityLayer, cells);
+}
+
+}  // namespace internal
+
+template <typename Maze>
+ConnectedComponents FindRoomComponents(const Maze& text_maze,
+                                       const std::vector<char>& wall_chars,
+                                       int num_threads) {
+  const auto is_wall_char = internal::MakeCharBoolMap(wall_chars);
+  const auto& area = text_maze.Area();
+  const int width = area.size.width;
+  std::vector<std::uint8_t> is_room(area.Area(), 0);
+  if (Bitboard::Supports(area.size)) {
+    const auto open = Bitboard::FromLayer(text_maze, TextMaze::kEntityLayer,
+                                          ~is_wall_char);
+    FindRoomCells(open).VisitSet(
+        [&is_room, width](int i, int j) { is_room[i * width + j] = 1; });
+  } else {
+    const auto marks = internal::MarkRoomCells(text_maze, is_wall_char);
+    area.Visit([&is_room, &marks, width](int i, int j) {
+      is_room[i * width + j] = marks[marks.Index(i, j)] == -1;
+    });
+  }
+  return num_threads == 1
+             ? LabelComponents(area.size, is_room)
+             : LabelComponentsParallel(area.size, is_room, num_threads);
+}
+
+template <typename Maze>
+std::vector<std::vector<Pos>> FindRooms(const Maze& text_maze,
+                                        const std::vector<char>& wall_chars) {
+  const auto rooms = FindRoomComponents(text_maze, wall_chars);
+  std::vector<std::vector<Pos>> result;
+  result.reserve(rooms.NumComponents());
+  for (int k = 0; k < rooms.NumComponents(); ++k) {
+    result.emplace_back(rooms.ComponentCells(k),
+                        rooms.ComponentCells(k) + rooms.ComponentSize(k));
+  }
+  return result;
+}
+
+template <typename Maze>
+void RemoveDeadEnds(char empty, char wall, const std::vector<char>& wall_chars,
+                    Maze* text_maze) {
+  auto is_wall_char = internal::MakeCharBoolMap(wall_chars);
+  is_wall_char[static_cast<unsigned char>(wall)] = true;
+  if (!Bitboard::Supports(text_maze->Area().size)) {
+    internal::RemoveDeadEndsScalar(empty, wall, is_wall_char, text_maze);
+    return;
+  }
+  internal::CharBoolMap is_empty = {};
+  is_empty[static_cast<unsigned char>(empty)] = true;
+  auto empty_cells =
+      Bitboard::FromLayer(*text_maze, TextMaze::kEntityLayer, is_empty);
+  auto open_cells = Bitboard::FromLayer(*text_maze, TextMaze::kEntityLayer,
+                                        ~is_wall_char | is_empty);
+  const auto removed = RemoveDeadEndCells(&empty_cells, &open_cells);
+  text_maze->VisitMutableRows(
+      TextMaze::kEntityLayer, [&removed, wall](int i, int, char* cells, int) {
+        for (std::uint64_t bits = removed.Row(i); bits != 0;
+             bits &= bits - 1) {
+          cells[__builtin_ctzll(bits)] = wall;
+        }
+      });
+}
+
+template <typename Maze>
+void FillWithMaze(         //
+    const Pos& pos,        //
+    unsigned int maze_id,  //
+    Maze* text_maze,       //
+    std::mt19937_64* prbg) {
+  std::vector<Pos> stack;
+  stack.push_back(pos);
+  unsigned int fill_id = text_maze->GetCellId(pos);
+  text_maze->SetCell(TextMaze::kEntityLayer, pos, ' ');
+  text_maze->SetCellId(pos, maze_id);
+  while (!stack.empty()) {
+    Pos current = stack.back();
+    // Find the possible directions we can two step to.
+    auto possible_directions = internal::PossibleDirections(
+        *text_maze, current, fill_id, 2 /*step_size*/);
+    if (possible_directions.empty()) {
+      stack.pop_back();
+      continue;
+    }
+    int direction_id = std::uniform_int_distribution<>(
+        0, possible_directions.size() - 1)(*prbg);
+    const auto& direction = possible_directions[direction_id];
+    Pos one_step = current + direction;
+    text_maze->SetCell(TextMaze::kEntityLayer, one_step, ' ');
+    text_maze->SetCellId(one_step, maze_id);
+    Pos two_step = current + 2 * direction;
+    text_maze->SetCell(TextMaze::kEntityLayer, two_step, ' ');
+    text_maze->SetCellId(two_step, maze_id);
+    stack.push_back(two_step);
+  }
+}
+
+template <typename Maze>
+void FillSpaceWithMaze(     //
+    unsigned int start_id,  //
+    unsigned int fill_id,   //
+    Maze* text_maze,        //
+    std::mt19937_64* prbg) {
+  auto visitor = [&start_id, fill_id, text_maze, prbg](int i, int j,
+                                                       unsigned int id) {
+    if (id == fill_id) {
+      FillWithMaze({i, j}, start_id++, text_maze, prbg);
+    }
+  };
+  internal::VisitOddIds(*text_maze, visitor);
+}
+
+template <typename Maze>
+std::vector<RegionDoor> FindRegionDoors(const Maze& text_maze) {
+  std::vector<RegionDoor> doors;
+  auto visitor = [&text_maze, &doors](int i, int j, unsigned int id_0) {
+    if (id_0 != 0) {
+      Pos pos = {i, j};
+      for (const auto& direction : internal::PathDirections()) {
+        Pos two_step = pos + 2 * direction;
+        if (!text_maze.Area().InBounds(two_step)) continue;
+        auto id_1 = text_maze.GetCellId(two_step);
+        if (id_1 == 0 || id_1 <= id_0) continue;
+        doors.push_back({id_0, id_1, pos + direction, direction});
+      }
+    }
+  };
+  internal::VisitOddIds(text_maze, visitor);
+  std::stable_sort(doors.begin(), doors.end(),
+                   [](const RegionDoor& lhs, const RegionDoor& rhs) {
+                     return lhs.id_0 != rhs.id_0 ? lhs.id_0 < rhs.id_0
+                                                 : lhs.id_1 < rhs.id_1;
+                   });
+  return doors;
+}
+
+template <typename Maze>
+std::vector<RegionDoor> RandomConnectRegionGraph(  //
+    char connector,                                //
+    double extra_probability,                      //
+    Maze* text_maze,                               //
+    std::mt19937_64* prbg) {
+  // Find all connecting points between regions.
+  const auto doors = FindRegionDoors(*text_maze);
+
+  // Connect each region with at least one connecting point.
+  std::vector<RegionDoor> result;
+  for (auto begin = doors.begin(); begin != doors.end();) {
+    auto end = begin + 1;
+    while (end != doors.end() && end->id_0 == begin->id_0 &&
+           end->id_1 == begin->id_1) {
+      ++end;
+    }
+    int door = std::uniform_int_distribution<>(0, end - begin - 1)(*prbg);
+    result.push_back(begin[door]);
+    text_maze->SetCell(TextMaze::kEntityLayer, begin[door].pos, connector);
+    begin = end;
+  }
+
+  // Then add extra connections with a probability of extra_probability.
+  for (const auto& location : doors) {
+    if (std::uniform_real_distribution<>(0, 1)(*prbg) <= extra_probability) {
+      bool next_to_door = false;
+      for (auto direction : internal::PathDirections()) {
+        Pos one_step = location.pos + direction;
+        if (text_maze->GetCell(TextMaze::kEntityLayer, one_step) == connector) {
+          next_to_door = true;
+          break;
+        }
+      }
+      if (!next_to_door) {
+        result.push_back(location);
+        text_maze->SetCell(TextMaze::kEntityLayer, location.pos, connector);
+      }
+    }
+  }
+  return result;
+}
+
+template <typename Maze>
+std::vector<std::pair<Pos, Vec>> RandomConnectRegions(  //
+    char connector,                                     //
+    double extra_probability,                           //
+    Maze* text_maze,                                    //
+    std::mt19937_64* prbg) {
+  const auto doors =
+      RandomConnectRegionGraph(connector, extra_probability, text_maze, prbg);
+  std::vector<std::pair<Pos, Vec>> result;
+  result.reserve(doors.size());
+  for (const auto& door : doors) {
+    result.emplace_back(door.pos, door.direction);
+  }
+  return result;
+}
+
+template <typename Maze>
+bool RemoveHorseshoeBends(                //
+    int bend_size,                        //
+    char wall,                            //
+    const std::vector<char>& wall_chars,  //
+    Maze* text_maze) {
+  bool bends_removed = false;
+  auto visitor = [bend_size, wall, &wall_chars, text_maze, &bends_removed](
+                     int i, int j, char value) {
+    bends_removed = bends_removed ||
+                    internal::RemoveHorseshoeBendAtPos({i, j}, bend_size, wall,
+                                                       wall_chars, text_maze);
+  };
+  text_maze->Visit(TextMaze::kEntityLayer, visitor);
+  return bends_removed;
+}
+
+template <typename Maze>
+void RemoveAllHorseshoeBends(             //
+    char wall,                            //
+    const std::vector<char>& wall_chars,  //
+    Maze* text_maze) {
+  for (int i = 1; i + 3 < text_maze->Area().size.width;) {
+    bool bends_removed = RemoveHorseshoeBends(i, wall, wall_chars, text_maze);
+    // Removing bends of bend_size > 1 may generate smaller loops.
+    // We must start again in this case.
+    if (bends_removed && i != 1) {
+      i = 1;
+    } else {
+      ++i;
+    }
+  }
+}
+
+template <typename Maze>
+void AddNEntitiesToEachRoom(              //
+    const std::vector<Rectangle>& rooms,  //
+    int n,                                //
+    char entity,                          //
+    char empty,                           //
+    Maze* text_maze,                      //
+    std::mt19937_64* prbg) {
+  for (const auto& room : rooms) {
+    std::vector<Pos> samples;
+    text_maze->VisitIntersection(TextMaze::kEntityLayer, room,
+                                 [empty, &samples](int i, int j, char value) {
+                                   if (value == empty) {
+                                     samples.push_back({i, j});
+                                   }
+                                 });
+    std::shuffle(samples.begin(), samples.end(), *prbg);
+    for (std::size_t i = 0;
+         i < std::min(samples.size(), static_cast<std::size_t>(n)); ++i) {
+      text_maze->SetCell(TextMaze::kEntityLayer, samples[i], entity);
+    }
+  }
+}
+
+template <typename Maze>
+void AddRoomVariations(unsigned int num_rooms, int max_variations,
+                       Maze* text_maze) {
+  text_maze->VisitMutableWithIdsIntersection(
+      TextMaze::kVariationsLayer, text_maze->Area(),
+      [num_rooms, max_variations](int, int, char* cell, unsigned int id) {
+        if (id > 0 && id <= num_rooms) {
+          *cell = 'A' + (id - 1) % max_variations;
+        }
+      });
+}
+
+template <typename Maze>
 std::vector<Pos> FindRandomPath(          //
     const Pos& from,                      //
     const Pos& to,                        //
     const std::vector<char>& wall_chars,  //
-    TextMaze* text_maze,                  //
+    Maze* text_maze,                      //
+    std::mt19937_64* prbg) {
+  // Set the Id of all visitable locations to 1, 0 otherwise.
+  auto is_wall_char = internal::MakeCharBoolMap(wall_chars);
+  text_maze->Visit(TextMaze::kEntityLayer, [text_maze, is_wall_char](
+                                               int i, int j, char cell) {
+    text_maze->SetCellId(
+        {i, j}, is_wall_char[static_cast<unsigned char>(cell)] ? 0 : 1);
+  });
+  std::vector<Pos> path;
+  path.push_back(from);
+  text_maze->SetCellId(from, 0);
+  if (from == to) {
+    return path;
+  }
+  while (!path.empty()) {
+    std::vector<Pos> candidates;
+    const auto& pos = path.back();
+    for (const auto& direction : internal::PathDirections()) {
+      auto candidate = pos + direction;
+      if (candidate == to) {
+        path.push_back(candidate);
+        return path;
+      }
+      if (text_maze->GetCellId(candidate) != 0) {
+        candidates.push_back(candidate);
+      }
+    }
+    if (candidates.empty()) {
+      path.pop_back();
+      continue;
+    }
+    int candidate_id =
+        std::uniform_int_distribution<>(0, candidates.size() - 1)(*prbg);
+    Pos candidate = candidates[candidate_id];
+    path.push_back(candidate);
+    text_maze->SetCellId(candidate, 0);
+  }
+  return path;
+}
+
+// The TextMaze instantiations are compiled once, in algorithm.cc.
+extern template std::vector<std::vector<Pos>> FindRooms(
+    const TextMaze& text_maze, const std::vector<char>& wall_chars);
+extern template ConnectedComponents FindRoomComponents(
+    const TextMaze& text_maze, const std::vector<char>& wall_chars,
+    int num_threads);
+extern template void RemoveDeadEnds(char empty, char wall,
+                                    const std::vector<char>& wall_chars,
+                                    TextMaze* text_maze);
+extern template void FillWithMaze(const Pos& pos, unsigned int maze_id,
+                                  TextMaze* text_maze, std::mt19937_64* prbg);
+extern template void FillSpaceWithMaze(unsigned int start_id,
+                                       unsigned int fill_id,
+                                       TextMaze* text_maze,
+                                       std::mt19937_64* prbg);
+extern template std::vector<RegionDoor> FindRegionDoors(
+    const TextMaze& text_maze);
+extern template std::vector<RegionDoor> RandomConnectRegionGraph(
+    char connector, double extra_probability, TextMaze* text_maze,
+    std::mt19937_64* prbg);
+extern template std::vector<std::pair<Pos, Vec>> RandomConnectRegions(
+    char connector, double extra_probability, TextMaze* text_maze,
     std::mt19937_64* prbg);
+extern template bool RemoveHorseshoeBends(int bend_size, char wall,
+                                          const std::vector<char>& wall_chars,
+                                          TextMaze* text_maze);
+extern template void RemoveAllHorseshoeBends(
+    char wall, const std::vector<char>& wall_chars, TextMaze* text_maze);
+extern template void AddNEntitiesToEachRoom(const std::vector<Rectangle>& rooms,
+                                            int n, char entity, char empty,
+                                            TextMaze* text_maze,
+                                            std::mt19937_64* prbg);
+extern template void AddRoomVariations(unsigned int num_rooms,
+                                      int max_variations, TextMaze* text_maze);
+extern template std::vector<Pos> FindRandomPath(
+    const Pos& from, const Pos& to, const std::vector<char>& wall_chars,
+    TextMaze* text_maze, std::mt19937_64* prbg);
 
 }  // namespace labmaze
 }  // namespace deepmind
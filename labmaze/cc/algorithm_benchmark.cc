@@ -0,0 +1,258 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/bitboard.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/connected_components.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/static_text_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns a maze of size 'size' x 'size' with rooms and entities.
+TextMaze MakeMaze(int size) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = size / 4;
+  params.spawns_per_room = 1;
+  params.objects_per_room = 1;
+  return RandomMaze(params, 1).Maze();
+}
+
+void SetCellsProcessed(const TextMaze& maze, benchmark::State* state) {
+  state->SetItemsProcessed(state->iterations() * maze.Area().Area());
+}
+
+void BM_FromCharGrid(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  const CharGrid entity_layer(maze.Text(TextMaze::kEntityLayer));
+  const CharGrid variations_layer(maze.Text(TextMaze::kVariationsLayer));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FromCharGrid(entity_layer, variations_layer));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_FromCharGrid)->Arg(11)->Arg(31)->Arg(101);
+
+void BM_FindRooms(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindRooms(maze, {'*'}));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_FindRooms)->Arg(11)->Arg(31)->Arg(101);
+
+void BM_FindRoomComponents(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindRoomComponents(maze, {'*'}));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_FindRoomComponents)->Arg(11)->Arg(31)->Arg(101);
+
+void BM_FloodFill(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  Pos goal{1, 1};
+  maze.Visit(TextMaze::kEntityLayer, [&goal](int i, int j, char c) {
+    if (c == 'G') goal = {i, j};
+  });
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        FloodFill(maze, TextMaze::kEntityLayer, goal, {'*'}));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_FloodFill)->Arg(11)->Arg(31)->Arg(101);
+
+void BM_RemoveDeadEnds(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    TextMaze copy = maze;
+    state.ResumeTiming();
+    RemoveDeadEnds(' ', '*', {}, &copy);
+    benchmark::DoNotOptimize(copy);
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_RemoveDeadEnds)->Arg(11)->Arg(31)->Arg(101);
+
+// Room classification cell by cell, for comparison with BM_FindRoomCells.
+void BM_MarkRoomCellsScalar(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  const auto is_wall_char = internal::MakeCharBoolMap("*");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(internal::MarkRoomCells(maze, is_wall_char));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_MarkRoomCellsScalar)->Arg(11)->Arg(31)->Arg(63);
+
+void BM_FindRoomCells(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  const auto open_chars = ~internal::MakeCharBoolMap("*");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindRoomCells(
+        Bitboard::FromLayer(maze, TextMaze::kEntityLayer, open_chars)));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_FindRoomCells)->Arg(11)->Arg(31)->Arg(63);
+
+// Returns a maze of size 'size' x 'size' with unsimplified corridors.
+TextMaze MakeCorridorMaze(int size) {
+  TextMaze maze({size, size});
+  std::mt19937_64 rng(1);
+  FillSpaceWithMaze(1, 0, &maze, &rng);
+  return maze;
+}
+
+void BM_RemoveDeadEndsScalar(benchmark::State& state) {
+  const TextMaze maze = MakeCorridorMaze(state.range(0));
+  const auto is_wall_char = internal::MakeCharBoolMap("*");
+  for (auto _ : state) {
+    state.PauseTiming();
+    TextMaze copy = maze;
+    state.ResumeTiming();
+    internal::RemoveDeadEndsScalar(' ', '*', is_wall_char, &copy);
+    benchmark::DoNotOptimize(copy);
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_RemoveDeadEndsScalar)->Arg(11)->Arg(31)->Arg(63);
+
+void BM_RemoveDeadEndsBitboard(benchmark::State& state) {
+  const TextMaze maze = MakeCorridorMaze(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    TextMaze copy = maze;
+    state.ResumeTiming();
+    RemoveDeadEnds(' ', '*', {}, &copy);
+    benchmark::DoNotOptimize(copy);
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_RemoveDeadEndsBitboard)->Arg(11)->Arg(31)->Arg(63);
+
+// Returns a maze of size 'size' x 'size' with numbered rooms and corridor
+// regions that are not yet connected, as RandomMaze generates them.
+TextMaze MakeRegionMaze(int size) {
+  std::mt19937_64 rng(1);
+  TextMaze maze({size, size});
+  SeparateRectangleParams params;
+  params.min_size = {3, 3};
+  params.max_size = {7, 7};
+  params.max_rects = size * size / 64;
+  params.retry_count = 1000;
+  params.density = 1.0;
+  const auto rects = MakeSeparateRectangles(maze.Area(), params, &rng);
+  for (unsigned int r = 0; r < rects.size(); ++r) {
+    maze.VisitMutableIntersection(TextMaze::kEntityLayer, rects[r],
+                                  [&maze, r](int i, int j, char* cell) {
+                                    *cell = ' ';
+                                    maze.SetCellId({i, j}, r + 1);
+                                  });
+  }
+  FillSpaceWithMaze(rects.size() + 1, 0, &maze, &rng);
+  return maze;
+}
+
+void BM_FindRegionDoors(benchmark::State& state) {
+  const TextMaze maze = MakeRegionMaze(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindRegionDoors(maze));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_FindRegionDoors)->Arg(31)->Arg(101)->Arg(301);
+
+void BM_RandomConnectRegions(benchmark::State& state) {
+  const TextMaze maze = MakeRegionMaze(state.range(0));
+  std::mt19937_64 rng(1);
+  for (auto _ : state) {
+    TextMaze connected = maze;
+    benchmark::DoNotOptimize(RandomConnectRegions(-1, 0.05, &connected, &rng));
+  }
+  SetCellsProcessed(maze, &state);
+}
+BENCHMARK(BM_RandomConnectRegions)->Arg(31)->Arg(101)->Arg(301);
+
+template <typename Maze>
+Maze MakeEmptyMaze() {
+  return Maze();
+}
+
+template <>
+TextMaze MakeEmptyMaze<TextMaze>() {
+  return TextMaze({31, 31});
+}
+
+// Generates and simplifies corridors in an empty 31x31 maze.
+template <typename Maze>
+void BM_GenerateCorridors(benchmark::State& state) {
+  std::mt19937_64 rng(1);
+  for (auto _ : state) {
+    Maze maze = MakeEmptyMaze<Maze>();
+    FillSpaceWithMaze(1, 0, &maze, &rng);
+    RemoveDeadEnds(' ', '*', {}, &maze);
+    benchmark::DoNotOptimize(maze);
+  }
+  state.SetItemsProcessed(state.iterations() * 31 * 31);
+}
+BENCHMARK_TEMPLATE(BM_GenerateCorridors, TextMaze);
+BENCHMARK_TEMPLATE(BM_GenerateCorridors, StaticTextMaze<31, 31>);
+
+// Labels a random set of cells of a map with state.range(0) rows and columns
+// on state.range(1) threads.
+void BM_LabelComponents(benchmark::State& state) {
+  const Size size{static_cast<int>(state.range(0)),
+                  static_cast<int>(state.range(0))};
+  const int num_threads = state.range(1);
+  std::mt19937_64 rng(1);
+  std::bernoulli_distribution in_set(0.6);
+  std::vector<std::uint8_t> mask(size.height * size.width);
+  for (auto& cell : mask) {
+    cell = in_set(rng);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(num_threads == 1 ? LabelComponents(size, mask)
+                                              : LabelComponentsParallel(
+                                                    size, mask, num_threads));
+  }
+  state.SetItemsProcessed(state.iterations() * mask.size());
+}
+BENCHMARK(BM_LabelComponents)
+    ->Args({1024, 1})
+    ->Args({1024, 4})
+    ->Args({4096, 1})
+    ->Args({4096, 4})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -15,7 +15,10 @@
 
 #include "labmaze/cc/algorithm.h"
 
+#include <cstddef>
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -394,6 +397,81 @@ TEST(AlgorithmTest, RandomConnectRegions) {
   EXPECT_THAT(maze.Text(TextMaze::kEntityLayer), AnyOf(Eq(kMaze0), Eq(kMaze1)));
 }
 
+TextMaze MakeFourRoomMaze() {
+  TextMaze maze =
+      FromCharGrid(CharGrid("***********\n"
+                            "*     *****\n"
+                            "*     *****\n"
+                            "*     *   *\n"
+                            "*******   *\n"
+                            "*   ***   *\n"
+                            "*   *******\n"
+                            "*   *     *\n"
+                            "*   *     *\n"
+                            "*   *     *\n"
+                            "***********\n"));
+  auto rooms = FindRooms(maze, {'*'});
+  for (unsigned int i = 0; i < rooms.size(); ++i) {
+    for (const auto& cell : rooms[i]) {
+      maze.SetCellId(cell, i + 1);
+    }
+  }
+  return maze;
+}
+
+TEST(AlgorithmTest, FindRegionDoors) {
+  const auto doors = FindRegionDoors(MakeFourRoomMaze());
+  const std::vector<std::pair<unsigned int, unsigned int>> expected_ids = {
+      {1, 2}, {1, 3}, {1, 3}, {2, 4}, {2, 4}, {3, 4}, {3, 4}};
+  const std::vector<Pos> expected_pos = {{3, 6}, {4, 1}, {4, 3}, {6, 7},
+                                         {6, 9}, {7, 4}, {9, 4}};
+  ASSERT_EQ(expected_ids.size(), doors.size());
+  for (std::size_t k = 0; k < doors.size(); ++k) {
+    EXPECT_EQ(expected_ids[k].first, doors[k].id_0);
+    EXPECT_EQ(expected_ids[k].second, doors[k].id_1);
+    EXPECT_EQ(expected_pos[k], doors[k].pos);
+  }
+  EXPECT_EQ(0, doors[0].direction.d_row);
+  EXPECT_EQ(1, doors[0].direction.d_col);
+  EXPECT_EQ(1, doors[1].direction.d_row);
+  EXPECT_EQ(0, doors[1].direction.d_col);
+}
+
+TEST(AlgorithmTest, RandomConnectRegionGraph) {
+  for (int seed = 0; seed < 10; ++seed) {
+    std::mt19937_64 prbg(seed);
+    TextMaze maze = MakeFourRoomMaze();
+    const auto doors = RandomConnectRegionGraph('#', 0.5, &maze, &prbg);
+
+    std::mt19937_64 expected_prbg(seed);
+    TextMaze expected_maze = MakeFourRoomMaze();
+    const auto connections =
+        RandomConnectRegions('#', 0.5, &expected_maze, &expected_prbg);
+    EXPECT_EQ(expected_maze.Text(TextMaze::kEntityLayer),
+              maze.Text(TextMaze::kEntityLayer));
+
+    // Each pair of adjacent regions is joined by the first doors.
+    ASSERT_EQ(connections.size(), doors.size());
+    ASSERT_LE(4, doors.size());
+    const std::vector<std::pair<unsigned int, unsigned int>> edges = {
+        {1, 2}, {1, 3}, {2, 4}, {3, 4}};
+    for (std::size_t k = 0; k < doors.size(); ++k) {
+      if (k < edges.size()) {
+        EXPECT_EQ(edges[k].first, doors[k].id_0);
+        EXPECT_EQ(edges[k].second, doors[k].id_1);
+      }
+      EXPECT_EQ(connections[k].first, doors[k].pos);
+      EXPECT_EQ(connections[k].second.d_row, doors[k].direction.d_row);
+      EXPECT_EQ(connections[k].second.d_col, doors[k].direction.d_col);
+      EXPECT_EQ('#', maze.GetCell(TextMaze::kEntityLayer, doors[k].pos));
+      EXPECT_EQ(doors[k].id_0,
+                maze.GetCellId(doors[k].pos - doors[k].direction));
+      EXPECT_EQ(doors[k].id_1,
+                maze.GetCellId(doors[k].pos + doors[k].direction));
+    }
+  }
+}
+
 TEST(AlgorithmTest, RemoveAllHorseshoeBends) {
   std::mt19937_64 prbg(0);
   TextMaze maze =
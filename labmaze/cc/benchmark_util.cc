@@ -0,0 +1,67 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/benchmark_util.h"
+
+#include <random>
+
+#include "labmaze/cc/random_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+TextMaze MakeUnsimplifiedMaze(int size) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = size / 8;
+  params.extra_connection_probability = 0.05;
+  params.simplify = false;
+  return RandomMaze(params, 1).Maze();
+}
+
+std::vector<std::pair<Pos, Pos>> MakeOddCellQueries(int size, int spread) {
+  std::mt19937_64 rng(2);
+  std::uniform_int_distribution<> half(0, size / 2 - 1);
+  std::uniform_int_distribution<> offset(-spread / 2, spread / 2);
+  const auto clamp = [size](int x) {
+    return x < 0 ? 0 : x > size / 2 - 1 ? size / 2 - 1 : x;
+  };
+  std::vector<std::pair<Pos, Pos>> queries(256);
+  for (auto& query : queries) {
+    const Pos from = {half(rng), half(rng)};
+    const Pos to = {clamp(from.row + offset(rng)),
+                    clamp(from.col + offset(rng))};
+    query = {{2 * from.row + 1, 2 * from.col + 1},
+             {2 * to.row + 1, 2 * to.col + 1}};
+  }
+  return queries;
+}
+
+TextMaze MakeNoiseMaze(int size) {
+  TextMaze maze({size, size}, 0);
+  std::mt19937_64 rng(1);
+  std::bernoulli_distribution is_wall(0.3);
+  maze.VisitMutableRows(TextMaze::kEntityLayer,
+                        [&rng, &is_wall](int, int, char* cells, int count) {
+                          for (int k = 0; k < count; ++k) {
+                            cells[k] = is_wall(rng) ? '*' : ' ';
+                          }
+                        });
+  return maze;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
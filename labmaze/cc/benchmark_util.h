@@ -0,0 +1,45 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Mazes and queries shared by the benchmarks.
+
+#ifndef LABMAZE_CC_BENCHMARK_UTIL_H_
+#define LABMAZE_CC_BENCHMARK_UTIL_H_
+
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Returns a random maze of 'size' x 'size' cells with up to size / 8 rooms and
+// a few extra connections. It is not simplified, so all its odd cells are
+// open.
+TextMaze MakeUnsimplifiedMaze(int size);
+
+// Returns pairs of odd cells of a maze of 'size' x 'size' cells, at most
+// 'spread' rows and columns apart.
+std::vector<std::pair<Pos, Pos>> MakeOddCellQueries(int size, int spread);
+
+// Returns a maze of 'size' x 'size' cells, each a wall with probability 0.3.
+// Open cells percolate, so most of them are connected.
+TextMaze MakeNoiseMaze(int size);
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_BENCHMARK_UTIL_H_
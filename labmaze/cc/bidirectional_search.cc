@@ -0,0 +1,159 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/bidirectional_search.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/search_labels.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// The labels of the cells in a search, kept by each thread across searches.
+// Cell k is labelled by the search from the start in the current search only
+// if epochs[k] equals epoch, and by the search from the goal only if it equals
+// epoch + 1. parents[k] is the direction of the step into cell k.
+struct SearchLabels {
+  internal::EpochStamps epochs;
+  std::vector<int> distances;
+  std::vector<std::uint8_t> parents;
+  std::vector<int> frontiers[2];
+  std::vector<int> next;
+  unsigned int epoch = 0;
+};
+
+// Returns the labels of the calling thread, with room for 'num_cells' cells
+// and none of them labelled.
+SearchLabels& ThreadSearchLabels(int num_cells) {
+  SearchLabels& labels = internal::ThreadLabels<SearchLabels>();
+  labels.epochs.Reserve(num_cells);
+  internal::ReserveLabels(num_cells, &labels.distances);
+  internal::ReserveLabels(num_cells, &labels.parents);
+  labels.epoch = labels.epochs.NewStamps(2);
+  return labels;
+}
+
+}  // namespace
+
+BidirectionalSearch::BidirectionalSearch(const TextMaze& maze,
+                                         TextMaze::Layer layer,
+                                         const std::vector<char>& wall_chars)
+    : layer_(layer),
+      is_wall_(internal::MakeCharBoolMap(wall_chars)),
+      area_(maze.Area()),
+      open_(area_.size, 0, 0) {
+  Update(maze, area_);
+}
+
+void BidirectionalSearch::Update(const TextMaze& maze, const Rectangle& rect) {
+  internal::ReadOpenCells(maze, layer_, is_wall_, rect, &open_);
+}
+
+int BidirectionalSearch::Search(Pos from, Pos to,
+                                std::vector<Pos>* path) const {
+  if (!IsOpen(from) || !IsOpen(to)) {
+    return -1;
+  }
+  if (from == to) {
+    if (path != nullptr) path->assign(1, from);
+    return 0;
+  }
+
+  const int num_cells = (area_.size.height + 2) * open_.stride();
+  SearchLabels& labels = ThreadSearchLabels(num_cells);
+  const unsigned int stamps[2] = {labels.epoch, labels.epoch + 1};
+  const std::array<int, 4> offsets = open_.NeighbourOffsets();
+  const int ends[2] = {open_.Index(from.row, from.col),
+                       open_.Index(to.row, to.col)};
+  for (int side = 0; side < 2; ++side) {
+    labels.epochs[ends[side]] = stamps[side];
+    labels.distances[ends[side]] = 0;
+    labels.frontiers[side].assign(1, ends[side]);
+  }
+
+  // Grows one frontier a whole level at a time. The first level that touches
+  // the other search holds a shortest route, though not necessarily through
+  // the first contact, so the level is finished before stopping. The route
+  // runs through the edge between 'meetings[0]', labelled from 'from', and
+  // 'meetings[1]', labelled from 'to'.
+  int best = -1;
+  int meetings[2] = {-1, -1};
+  while (best < 0 && !labels.frontiers[0].empty() &&
+         !labels.frontiers[1].empty()) {
+    const int side =
+        labels.frontiers[0].size() <= labels.frontiers[1].size() ? 0 : 1;
+    const unsigned int own = stamps[side];
+    const unsigned int other = stamps[1 - side];
+    labels.next.clear();
+    for (int cell : labels.frontiers[side]) {
+      const int distance = labels.distances[cell] + 1;
+      for (int direction = 0; direction < 4; ++direction) {
+        const int neighbour = cell + offsets[direction];
+        if (!open_[neighbour] || labels.epochs[neighbour] == own) {
+          continue;
+        }
+        if (labels.epochs[neighbour] == other) {
+          const int total = distance + labels.distances[neighbour];
+          if (best < 0 || total < best) {
+            best = total;
+            meetings[side] = cell;
+            meetings[1 - side] = neighbour;
+          }
+          continue;
+        }
+        labels.epochs[neighbour] = own;
+        labels.distances[neighbour] = distance;
+        labels.parents[neighbour] = direction;
+        labels.next.push_back(neighbour);
+      }
+    }
+    std::swap(labels.frontiers[side], labels.next);
+  }
+
+  if (path != nullptr && best >= 0) {
+    path->clear();
+    path->reserve(best + 1);
+    // Walks back from each meeting cell to the end its search started from.
+    for (int side = 0; side < 2; ++side) {
+      for (int cell = meetings[side];; cell -= offsets[labels.parents[cell]]) {
+        path->push_back(open_.ToPos(cell));
+        if (cell == ends[side]) break;
+      }
+      if (side == 0) {
+        std::reverse(path->begin(), path->end());
+      }
+    }
+  }
+  return best;
+}
+
+int BidirectionalSearch::Distance(Pos from, Pos to) const {
+  return Search(from, to, nullptr);
+}
+
+std::vector<Pos> BidirectionalSearch::ShortestPath(Pos from, Pos to) const {
+  std::vector<Pos> path;
+  Search(from, to, &path);
+  return path;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
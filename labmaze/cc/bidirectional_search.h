@@ -0,0 +1,72 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Point-to-point shortest path queries by bidirectional breadth-first search.
+
+#ifndef LABMAZE_CC_BIDIRECTIONAL_SEARCH_H_
+#define LABMAZE_CC_BIDIRECTIONAL_SEARCH_H_
+
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Answers shortest path queries between two cells of a maze by searching
+// breadth-first from both ends at once, always growing the smaller frontier,
+// until they meet. Unlike a FloodFill, a query neither allocates nor clears a
+// grid of distances: cells are labelled in arrays kept by each thread across
+// queries and stamped with the query they belong to. A query thus costs time
+// in proportion to the cells it explores, which are often far fewer than the
+// cells connected to its end points.
+class BidirectionalSearch {
+ public:
+  // Reads the cells of 'layer' of 'maze' that are not in 'wall_chars'.
+  BidirectionalSearch(const TextMaze& maze, TextMaze::Layer layer,
+                      const std::vector<char>& wall_chars);
+
+  // Re-reads the cells in 'rect' from 'maze', which shall have the extents of
+  // the maze given on construction.
+  void Update(const TextMaze& maze, const Rectangle& rect);
+
+  // If 'to' is reachable from 'from', returns the minimum distance between
+  // them. Otherwise returns -1.
+  int Distance(Pos from, Pos to) const;
+
+  // If 'to' is reachable from 'from', returns a shortest route from 'from' to
+  // 'to' including both end points. Otherwise returns an empty vector.
+  std::vector<Pos> ShortestPath(Pos from, Pos to) const;
+
+ private:
+  bool IsOpen(Pos pos) const {
+    return area_.InBounds(pos) && open_[open_.Index(pos.row, pos.col)];
+  }
+
+  // Returns Distance(from, to), and stores a shortest route in 'path' if not
+  // null.
+  int Search(Pos from, Pos to, std::vector<Pos>* path) const;
+
+  TextMaze::Layer layer_;
+  internal::CharBoolMap is_wall_;
+  Rectangle area_;
+  BorderedGrid<char> open_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_BIDIRECTIONAL_SEARCH_H_
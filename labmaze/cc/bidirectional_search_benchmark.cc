@@ -0,0 +1,74 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares point-to-point distance queries by BidirectionalSearch with a
+// FloodFill per query, for end points near each other and far apart.
+
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/benchmark_util.h"
+#include "labmaze/cc/bidirectional_search.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Distances between cells of a maze state.range(0) cells square, up to
+// 2 * state.range(1) rows and columns apart.
+void BM_BidirectionalSearch(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const BidirectionalSearch search(maze, TextMaze::kEntityLayer, {'*'});
+  const auto queries = MakeOddCellQueries(state.range(0), state.range(1));
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        search.Distance(queries[k].first, queries[k].second));
+    if (++k == queries.size()) k = 0;
+  }
+}
+BENCHMARK(BM_BidirectionalSearch)
+    ->ArgNames({"size", "spread"})
+    ->Args({201, 10})
+    ->Args({1001, 10})
+    ->Args({1001, 100})
+    ->Args({1001, 1000})
+    ->Unit(benchmark::kMicrosecond);
+
+// As BM_BidirectionalSearch, with a FloodFill per query.
+void BM_FloodFillPerQuery(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const auto queries = MakeOddCellQueries(state.range(0), state.range(1));
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const FloodFill fill(maze, TextMaze::kEntityLayer, queries[k].second,
+                         {'*'});
+    benchmark::DoNotOptimize(fill.DistanceFrom(queries[k].first));
+    if (++k == queries.size()) k = 0;
+  }
+}
+BENCHMARK(BM_FloodFillPerQuery)
+    ->ArgNames({"size", "spread"})
+    ->Args({201, 10})
+    ->Args({1001, 10})
+    ->Args({1001, 1000})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
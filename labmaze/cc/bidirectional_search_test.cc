@@ -0,0 +1,131 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/bidirectional_search.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Checks that 'path' is a route of 'distance' steps from 'from' to 'to' over
+// open cells of 'maze'.
+void ExpectRoute(const TextMaze& maze, Pos from, Pos to, int distance,
+                 const std::vector<Pos>& path) {
+  ASSERT_EQ(distance + 1, static_cast<int>(path.size()));
+  EXPECT_EQ(from, path.front());
+  EXPECT_EQ(to, path.back());
+  for (std::size_t k = 0; k < path.size(); ++k) {
+    EXPECT_NE('*', maze.GetCell(TextMaze::kEntityLayer, path[k]));
+    if (k > 0) {
+      EXPECT_EQ(1, std::abs(path[k].row - path[k - 1].row) +
+                       std::abs(path[k].col - path[k - 1].col));
+    }
+  }
+}
+
+TEST(BidirectionalSearchTest, Simple) {
+  const TextMaze maze = FromCharGrid(CharGrid("*******\n"
+                                              "*     *\n"
+                                              "* *** *\n"
+                                              "*   * *\n"
+                                              "*** * *\n"
+                                              "*     *\n"
+                                              "*******\n"));
+  const BidirectionalSearch search(maze, TextMaze::kEntityLayer, {'*'});
+  EXPECT_EQ(0, search.Distance({1, 1}, {1, 1}));
+  EXPECT_EQ(1, search.Distance({1, 1}, {1, 2}));
+  EXPECT_EQ(8, search.Distance({3, 3}, {1, 5}));
+  EXPECT_THAT(search.ShortestPath({1, 1}, {5, 1}),
+              ElementsAre(Pos{1, 1}, Pos{2, 1}, Pos{3, 1}, Pos{3, 2},
+                          Pos{3, 3}, Pos{4, 3}, Pos{5, 3}, Pos{5, 2},
+                          Pos{5, 1}));
+  EXPECT_THAT(search.ShortestPath({2, 1}, {2, 1}), ElementsAre(Pos{2, 1}));
+  // Walls and cells out of bounds.
+  EXPECT_EQ(-1, search.Distance({0, 0}, {1, 1}));
+  EXPECT_EQ(-1, search.Distance({1, 1}, {2, 2}));
+  EXPECT_EQ(-1, search.Distance({1, 1}, {7, 1}));
+  EXPECT_TRUE(search.ShortestPath({1, 1}, {-1, 1}).empty());
+}
+
+TEST(BidirectionalSearchTest, Unreachable) {
+  const TextMaze maze = FromCharGrid(CharGrid("  *   \n"
+                                              "  *   \n"));
+  const BidirectionalSearch search(maze, TextMaze::kEntityLayer, {'*'});
+  EXPECT_EQ(-1, search.Distance({0, 0}, {1, 5}));
+  EXPECT_TRUE(search.ShortestPath({1, 5}, {0, 0}).empty());
+  EXPECT_EQ(3, search.Distance({0, 3}, {1, 5}));
+}
+
+TEST(BidirectionalSearchTest, MatchesFloodFill) {
+  std::mt19937_64 rng(1);
+  for (int seed = 0; seed < 4; ++seed) {
+    RandomMazeParams params;
+    params.height = 41;
+    params.width = 61;
+    params.max_rooms = 6;
+    params.extra_connection_probability = 0.3;
+    params.simplify = seed % 2 == 0;
+    const TextMaze maze = RandomMaze(params, seed).Maze();
+    const BidirectionalSearch search(maze, TextMaze::kEntityLayer, {'*'});
+    std::uniform_int_distribution<> row(0, params.height - 1);
+    std::uniform_int_distribution<> col(0, params.width - 1);
+    for (int query = 0; query < 50; ++query) {
+      const Pos from = {row(rng), col(rng)};
+      const Pos to = {row(rng), col(rng)};
+      const FloodFill fill(maze, TextMaze::kEntityLayer, to, {'*'});
+      const int distance = fill.DistanceFrom(from);
+      ASSERT_EQ(distance, search.Distance(from, to)) << seed << ", " << query;
+      const std::vector<Pos> path = search.ShortestPath(from, to);
+      if (distance < 0) {
+        EXPECT_TRUE(path.empty());
+      } else {
+        ExpectRoute(maze, from, to, distance, path);
+      }
+    }
+  }
+}
+
+TEST(BidirectionalSearchTest, Update) {
+  TextMaze maze = FromCharGrid(CharGrid("     \n"
+                                        "**** \n"
+                                        "     \n"));
+  BidirectionalSearch search(maze, TextMaze::kEntityLayer, {'*'});
+  EXPECT_EQ(10, search.Distance({0, 0}, {2, 0}));
+  maze.SetCell(TextMaze::kEntityLayer, {1, 0}, ' ');
+  search.Update(maze, {{1, 0}, {1, 1}});
+  EXPECT_EQ(2, search.Distance({0, 0}, {2, 0}));
+  maze.SetCell(TextMaze::kEntityLayer, {1, 4}, '*');
+  maze.SetCell(TextMaze::kEntityLayer, {1, 0}, '*');
+  search.Update(maze, maze.Area());
+  EXPECT_EQ(-1, search.Distance({0, 0}, {2, 0}));
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,205 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/bitboard.h"
+
+#include <array>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "labmaze/cc/logging.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns the cells of 'row' that have a horizontal neighbour in 'row'.
+inline std::uint64_t HasHorizontalPair(std::uint64_t row) {
+  return row & ((row >> 1) | (row << 1));
+}
+
+// Returns the room cells of row 'mid' given its neighbouring rows. See
+// FindRoomCells.
+inline std::uint64_t RoomRow(std::uint64_t up, std::uint64_t mid,
+                             std::uint64_t down) {
+  // Open cells of 'mid' with an open vertical neighbour; a horizontal
+  // neighbour of a room cell must be one of these.
+  const std::uint64_t mid_vertical = mid & (up | down);
+  const std::uint64_t horizontal = (mid_vertical >> 1) | (mid_vertical << 1);
+  // Open cells of 'up' and 'down' with an open horizontal neighbour; a
+  // vertical neighbour of a room cell must be one of these.
+  const std::uint64_t vertical =
+      HasHorizontalPair(up) | HasHorizontalPair(down);
+  return mid & horizontal & vertical;
+}
+
+// Extends 'seed' along the runs of 'mask' that contain it, in both directions.
+// 'seed' shall be a subset of 'mask'.
+inline std::uint64_t FillRow(std::uint64_t seed, std::uint64_t mask) {
+  std::uint64_t up = seed;
+  std::uint64_t down = seed;
+  std::uint64_t up_mask = mask;
+  std::uint64_t down_mask = mask;
+  for (int shift = 1; shift < 64; shift *= 2) {
+    up |= up_mask & (up << shift);
+    down |= down_mask & (down >> shift);
+    up_mask &= up_mask << shift;
+    down_mask &= down_mask >> shift;
+  }
+  return up | down;
+}
+
+// Returns the neighbours of in-bounds cell (i, j) in 'open' as a mask with
+// bit 0 up, bit 1 down, bit 2 left and bit 3 right.
+inline unsigned int NeighbourMask(const Bitboard& open, int i, int j) {
+  const std::uint64_t row = open.Row(i);
+  return ((open.Row(i - 1) >> j) & 1) | (((open.Row(i + 1) >> j) & 1) << 1) |
+         ((((row << 1) >> j) & 1) << 2) | ((((row >> 1) >> j) & 1) << 3);
+}
+
+}  // namespace
+
+Bitboard::Bitboard(Size size) : size_(size), rows_(size.height + 2, 0) {
+  CHECK(Supports(size)) << "Bitboard does not support a width of "
+                        << size.width << ".";
+}
+
+int Bitboard::Count() const {
+  int count = 0;
+  for (std::uint64_t row : rows_) {
+    count += __builtin_popcountll(row);
+  }
+  return count;
+}
+
+Bitboard CellsWithAtMostOneNeighbour(const Bitboard& cells,
+                                     const Bitboard& open) {
+  Bitboard result(cells.size());
+  for (int i = 0; i < cells.size().height; ++i) {
+    const std::uint64_t mid = open.Row(i);
+    const std::uint64_t left = mid << 1;
+    const std::uint64_t right = mid >> 1;
+    const std::uint64_t up = open.Row(i - 1);
+    const std::uint64_t down = open.Row(i + 1);
+    const std::uint64_t at_least_two =
+        (left & right) | (up & down) | ((left | right) & (up | down));
+    result.MutableRow(i) = cells.Row(i) & ~at_least_two;
+  }
+  return result;
+}
+
+Bitboard RemoveDeadEndCells(Bitboard* empty, Bitboard* open) {
+  Bitboard removed(empty->size());
+  const std::array<Vec, 4> directions = {{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}};
+  // Removing a dead end can only turn its one remaining open neighbour into a
+  // dead end, so the initial dead ends are followed along their corridors.
+  // Cells reached this way are always in bounds.
+  CellsWithAtMostOneNeighbour(*empty, *open).VisitSet([&](int i, int j) {
+    while ((empty->Row(i) >> j) & 1) {
+      const unsigned int neighbours = NeighbourMask(*open, i, j);
+      if (neighbours & (neighbours - 1)) {
+        break;
+      }
+      const std::uint64_t bit = std::uint64_t{1} << j;
+      empty->MutableRow(i) &= ~bit;
+      open->MutableRow(i) &= ~bit;
+      removed.MutableRow(i) |= bit;
+      if (neighbours == 0) {
+        break;
+      }
+      const Vec& direction = directions[__builtin_ctz(neighbours)];
+      i += direction.d_row;
+      j += direction.d_col;
+    }
+  });
+  return removed;
+}
+
+Bitboard FindRoomCells(const Bitboard& open) {
+  const int height = open.size().height;
+  Bitboard result(open.size());
+  int i = 0;
+#if defined(__AVX2__)
+  // Four rows at a time. Rows are contiguous and padded with a zero row at
+  // either end, so each group loads its neighbouring rows directly.
+  const auto load = [&open](int row) {
+    return _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(open.RowData(row)));
+  };
+  const auto has_horizontal_pair = [](__m256i row) {
+    return _mm256_and_si256(row, _mm256_or_si256(_mm256_srli_epi64(row, 1),
+                                                 _mm256_slli_epi64(row, 1)));
+  };
+  for (; i + 4 <= height; i += 4) {
+    const __m256i up = load(i - 1);
+    const __m256i mid = load(i);
+    const __m256i down = load(i + 1);
+    const __m256i mid_vertical =
+        _mm256_and_si256(mid, _mm256_or_si256(up, down));
+    const __m256i horizontal = _mm256_or_si256(
+        _mm256_srli_epi64(mid_vertical, 1), _mm256_slli_epi64(mid_vertical, 1));
+    const __m256i vertical =
+        _mm256_or_si256(has_horizontal_pair(up), has_horizontal_pair(down));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&result.MutableRow(i)),
+        _mm256_and_si256(mid, _mm256_and_si256(horizontal, vertical)));
+  }
+#endif
+  for (; i < height; ++i) {
+    result.MutableRow(i) =
+        RoomRow(open.Row(i - 1), open.Row(i), open.Row(i + 1));
+  }
+  return result;
+}
+
+Bitboard ReachableCells(const Bitboard& open, Pos from) {
+  const int height = open.size().height;
+  Bitboard reach(open.size());
+  if (!open.Test(from)) {
+    return reach;
+  }
+  reach.Set(from);
+  // Alternate downward and upward sweeps, spreading each row along its open
+  // runs, until no row changes.
+  auto spread = [&open, &reach](int i) {
+    const std::uint64_t mask = open.Row(i);
+    const std::uint64_t seed =
+        reach.Row(i) | (mask & (reach.Row(i - 1) | reach.Row(i + 1)));
+    const std::uint64_t row = FillRow(seed, mask);
+    const bool changed = row != reach.Row(i);
+    reach.MutableRow(i) = row;
+    return changed;
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 0; i < height; ++i) {
+      changed |= spread(i);
+    }
+    for (int i = height - 1; i >= 0; --i) {
+      changed |= spread(i);
+    }
+  }
+  return reach;
+}
+
+bool AreConnected(const Bitboard& open, Pos from, Pos to) {
+  return open.Test(to) && ReachableCells(open, from).Test(to);
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,134 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Bitboard: packed cell sets and word-parallel maze kernels.
+
+#ifndef LABMAZE_CC_BITBOARD_H_
+#define LABMAZE_CC_BITBOARD_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// A set of cells of a maze at most kMaxWidth columns wide, packed with one
+// 64-bit word per row: bit j of row i is cell (i, j). A zero row is kept above
+// and below the maze so that kernels can read the rows neighbouring any row
+// without bounds checks.
+class Bitboard {
+ public:
+  static constexpr int kMaxWidth = 64;
+
+  // Returns whether mazes of 'size' can be represented.
+  static bool Supports(const Size& size) {
+    return 0 < size.width && size.width <= kMaxWidth;
+  }
+
+  // Creates an empty set of cells. 'size' shall be supported.
+  explicit Bitboard(Size size);
+
+  // Returns the cells of 'layer' of 'maze' whose characters are in 'chars'.
+  template <typename Maze>
+  static Bitboard FromLayer(const Maze& maze, TextMaze::Layer layer,
+                            const internal::CharBoolMap& chars) {
+    Bitboard result(maze.Area().size);
+    maze.VisitRows(layer, [&result, &chars](int i, int, const char* cells,
+                                            int count) {
+      std::uint64_t bits = 0;
+      for (int k = 0; k < count; ++k) {
+        bits |= static_cast<std::uint64_t>(
+                    chars[static_cast<unsigned char>(cells[k])])
+                << k;
+      }
+      result.MutableRow(i) = bits;
+    });
+    return result;
+  }
+
+  const Size& size() const { return size_; }
+
+  // Returns the word of row 'i'. 'i' may be -1 or size().height, which are
+  // always zero.
+  std::uint64_t Row(int i) const { return rows_[i + 1]; }
+  std::uint64_t& MutableRow(int i) { return rows_[i + 1]; }
+
+  // Returns the words of rows 'i' onwards, which are contiguous.
+  const std::uint64_t* RowData(int i) const { return &rows_[i + 1]; }
+
+  // Returns whether 'pos' is in the set. Out-of-bounds cells never are.
+  bool Test(Pos pos) const {
+    return Rectangle{{0, 0}, size_}.InBounds(pos) &&
+           ((Row(pos.row) >> pos.col) & 1);
+  }
+
+  // Adds or removes the in-bounds cell 'pos'.
+  void Set(Pos pos) { MutableRow(pos.row) |= std::uint64_t{1} << pos.col; }
+  void Reset(Pos pos) { MutableRow(pos.row) &= ~(std::uint64_t{1} << pos.col); }
+
+  // Returns the number of cells in the set.
+  int Count() const;
+
+  // Calls f(i, j) for each cell (i, j) in the set in row-major order.
+  template <typename F>
+  void VisitSet(F&& f) const {
+    for (int i = 0; i < size_.height; ++i) {
+      for (std::uint64_t bits = Row(i); bits != 0; bits &= bits - 1) {
+        f(i, __builtin_ctzll(bits));
+      }
+    }
+  }
+
+  friend bool operator==(const Bitboard& lhs, const Bitboard& rhs) {
+    return lhs.size_.height == rhs.size_.height &&
+           lhs.size_.width == rhs.size_.width && lhs.rows_ == rhs.rows_;
+  }
+
+ private:
+  Size size_;
+  std::vector<std::uint64_t> rows_;
+};
+
+// Returns the cells of 'cells' that have at most one of their four neighbours
+// in 'open'.
+Bitboard CellsWithAtMostOneNeighbour(const Bitboard& cells,
+                                     const Bitboard& open);
+
+// Removes dead ends, as defined by RemoveDeadEnds, until none remain. A dead
+// end is a cell of '*empty' with at most one neighbour in '*open', where
+// '*empty' shall be a subset of '*open'. Removed cells are cleared from both
+// sets and returned.
+Bitboard RemoveDeadEndCells(Bitboard* empty, Bitboard* open);
+
+// Returns the cells of 'open' that FindRooms considers part of a room, which
+// excludes corridors, T-junctions and dead ends: an open cell is in a room if
+// one of its horizontal neighbours has an open vertical neighbour and one of
+// its vertical neighbours has an open horizontal neighbour.
+Bitboard FindRoomCells(const Bitboard& open);
+
+// Returns the cells of 'open' connected to 'from' through 'open', or an empty
+// set if 'from' is not in 'open'.
+Bitboard ReachableCells(const Bitboard& open, Pos from);
+
+// Returns whether 'from' and 'to' are connected through 'open'.
+bool AreConnected(const Bitboard& open, Pos from, Pos to);
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_BITBOARD_H_
@@ -0,0 +1,160 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/bitboard.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+const internal::CharBoolMap kWalls = internal::MakeCharBoolMap("*");
+
+// Returns a maze of 'size' with random walls, corridors and entities.
+TextMaze MakeNoiseMaze(Size size, double wall_probability,
+                       std::mt19937_64* rng) {
+  TextMaze maze(size);
+  std::uniform_real_distribution<> uniform(0, 1);
+  maze.VisitMutable(TextMaze::kEntityLayer, [&](int, int, char* c) {
+    const double p = uniform(*rng);
+    *c = p < wall_probability ? '*' : p < 0.95 ? ' ' : 'G';
+  });
+  return maze;
+}
+
+// Returns a generated maze of 'size' with its dead ends still in place.
+TextMaze MakeCorridorMaze(Size size, std::mt19937_64* rng) {
+  TextMaze maze(size);
+  FillSpaceWithMaze(1, 0, &maze, rng);
+  RandomConnectRegions(' ', 0.05, &maze, rng);
+  return maze;
+}
+
+TEST(BitboardTest, SetAndTest) {
+  Bitboard bitboard({3, 64});
+  bitboard.Set({0, 0});
+  bitboard.Set({2, 63});
+  EXPECT_TRUE(bitboard.Test({0, 0}));
+  EXPECT_TRUE(bitboard.Test({2, 63}));
+  EXPECT_FALSE(bitboard.Test({1, 0}));
+  EXPECT_FALSE(bitboard.Test({-1, 0}));
+  EXPECT_FALSE(bitboard.Test({0, 64}));
+  EXPECT_EQ(2, bitboard.Count());
+  EXPECT_EQ(0, bitboard.Row(-1));
+  EXPECT_EQ(0, bitboard.Row(3));
+
+  std::vector<Pos> visited;
+  bitboard.VisitSet([&visited](int i, int j) { visited.push_back({i, j}); });
+  ASSERT_EQ(2, visited.size());
+  EXPECT_EQ((Pos{0, 0}), visited[0]);
+  EXPECT_EQ((Pos{2, 63}), visited[1]);
+
+  bitboard.Reset({0, 0});
+  EXPECT_FALSE(bitboard.Test({0, 0}));
+  EXPECT_FALSE(Bitboard::Supports({3, 65}));
+}
+
+TEST(BitboardTest, FromLayer) {
+  TextMaze maze({2, 3});
+  maze.SetCell(TextMaze::kEntityLayer, {1, 1}, ' ');
+  const auto open =
+      Bitboard::FromLayer(maze, TextMaze::kEntityLayer, ~kWalls);
+  EXPECT_EQ(1, open.Count());
+  EXPECT_TRUE(open.Test({1, 1}));
+}
+
+TEST(BitboardTest, FindRoomCellsMatchesScalar) {
+  std::mt19937_64 rng(1);
+  for (int width : {1, 2, 7, 31, 63, 64}) {
+    for (int height : {1, 3, 4, 9, 30}) {
+      for (double wall_probability : {0.2, 0.5}) {
+        const auto maze =
+            MakeNoiseMaze({height, width}, wall_probability, &rng);
+        const auto expected = internal::MarkRoomCells(maze, kWalls);
+        const auto rooms = FindRoomCells(
+            Bitboard::FromLayer(maze, TextMaze::kEntityLayer, ~kWalls));
+        maze.Area().Visit([&](int i, int j) {
+          EXPECT_EQ(expected[expected.Index(i, j)] == -1, rooms.Test({i, j}))
+              << maze.Text(TextMaze::kEntityLayer) << "at " << i << ", "
+              << j;
+        });
+      }
+    }
+  }
+}
+
+TEST(BitboardTest, RemoveDeadEndsMatchesScalar) {
+  std::mt19937_64 rng(2);
+  for (int width : {3, 17, 63, 64}) {
+    for (int height : {3, 21}) {
+      for (int trial = 0; trial < 4; ++trial) {
+        auto maze = trial % 2 == 0 ? MakeCorridorMaze({height, width}, &rng)
+                                   : MakeNoiseMaze({height, width}, 0.4, &rng);
+        auto expected = maze;
+        auto is_wall_char = kWalls;
+        is_wall_char['#'] = true;
+        internal::RemoveDeadEndsScalar(' ', '#', is_wall_char, &expected);
+        RemoveDeadEnds(' ', '#', {'*'}, &maze);
+        EXPECT_EQ(expected.Text(TextMaze::kEntityLayer),
+                  maze.Text(TextMaze::kEntityLayer));
+      }
+    }
+  }
+}
+
+TEST(BitboardTest, ReachableCellsMatchesFloodFill) {
+  std::mt19937_64 rng(3);
+  for (int trial = 0; trial < 8; ++trial) {
+    const auto maze = MakeNoiseMaze({25, 64}, 0.4, &rng);
+    const auto open =
+        Bitboard::FromLayer(maze, TextMaze::kEntityLayer, ~kWalls);
+    const Pos from{12, 30};
+    const FloodFill fill(maze, TextMaze::kEntityLayer, from, {'*'});
+    const auto reach = ReachableCells(open, from);
+    maze.Area().Visit([&](int i, int j) {
+      EXPECT_EQ(fill.DistanceFrom({i, j}) >= 0, reach.Test({i, j}));
+      EXPECT_EQ(fill.DistanceFrom({i, j}) >= 0,
+                AreConnected(open, from, {i, j}));
+    });
+  }
+}
+
+TEST(BitboardTest, ReachableCellsFollowsSpiral) {
+  TextMaze maze({7, 7});
+  // A spiral corridor that needs several sweeps in both directions.
+  maze.FillRect(TextMaze::kEntityLayer, {{0, 0}, {1, 7}}, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, {{0, 6}, {7, 1}}, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, {{6, 0}, {1, 7}}, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, {{2, 0}, {5, 1}}, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, {{2, 0}, {1, 5}}, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, {{2, 4}, {3, 1}}, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, {{4, 2}, {1, 3}}, ' ');
+  const auto open = Bitboard::FromLayer(maze, TextMaze::kEntityLayer, ~kWalls);
+  EXPECT_TRUE(AreConnected(open, {0, 0}, {4, 2}));
+  EXPECT_EQ(open.Count(), ReachableCells(open, {0, 0}).Count());
+  EXPECT_FALSE(AreConnected(open, {0, 0}, {1, 1}));
+  EXPECT_EQ(0, ReachableCells(open, {1, 1}).Count());
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,125 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/cell_record_maze.h"
+
+#include <algorithm>
+
+#include "labmaze/cc/logging.h"
+
+namespace deepmind {
+namespace labmaze {
+
+CellRecordMaze::CellRecordMaze(Size extents)
+    : area_{{0, 0}, extents},
+      cells_(extents.height * extents.width, CellRecord{'*', '.', 0}) {}
+
+CellRecordMaze::CellRecordMaze(const TextMaze& maze)
+    : CellRecordMaze(maze.Area().size) {
+  for (Layer layer : {TextMaze::kEntityLayer, TextMaze::kVariationsLayer}) {
+    char CellRecord::*field = Field(layer);
+    maze.VisitRows(layer, [this, field](int i, int j, const char* cells,
+                                        int count) {
+      CellRecord* records = &cells_[Index(i, j)];
+      for (int k = 0; k < count; ++k) {
+        records[k].*field = cells[k];
+      }
+    });
+  }
+  if (maze.HasIds()) {
+    area_.Visit([this, &maze](int i, int j) {
+      SetCellId({i, j}, maze.GetCellId({i, j}));
+    });
+  }
+}
+
+void CellRecordMaze::IdOutOfRange(unsigned int id) {
+  LOG(FATAL) << "Id " << id << " exceeds the maximum id " << MaxId() << ".";
+}
+
+TextMaze CellRecordMaze::ToTextMaze() const {
+  TextMaze result(area_.size, MaxId());
+  for (Layer layer : {TextMaze::kEntityLayer, TextMaze::kVariationsLayer}) {
+    const char CellRecord::*field = Field(layer);
+    result.VisitMutableRows(layer, [this, field](int i, int j, char* cells,
+                                                 int count) {
+      const CellRecord* records = &cells_[Index(i, j)];
+      for (int k = 0; k < count; ++k) {
+        cells[k] = records[k].*field;
+      }
+    });
+  }
+  area_.Visit([this, &result](int i, int j) {
+    result.SetCellId({i, j}, cells_[Index(i, j)].id);
+  });
+  return result;
+}
+
+BorderedGrid<char> CellRecordMaze::BorderedLayer(Layer layer,
+                                                 char border) const {
+  BorderedGrid<char> grid(area_.size, border, border);
+  VisitRows(layer, [&grid](int i, int j, const char* cells, int count) {
+    std::copy_n(cells, count, &grid[grid.Index(i, j)]);
+  });
+  return grid;
+}
+
+void CellRecordMaze::AssignLayer(Layer layer, const BorderedGrid<char>& grid) {
+  CHECK_EQ(grid.size().height, area_.size.height);
+  CHECK_EQ(grid.size().width, area_.size.width);
+  VisitMutableRows(layer, [&grid](int i, int j, char* cells, int count) {
+    std::copy_n(&grid[grid.Index(i, j)], count, cells);
+  });
+}
+
+std::string CellRecordMaze::Text(Layer layer) const {
+  std::string text;
+  text.reserve(area_.size.height * (area_.size.width + 1));
+  VisitRows(layer, [&text](int, int, const char* cells, int count) {
+    text.append(cells, count);
+    text.push_back('\n');
+  });
+  return text;
+}
+
+CellRecordMaze CellRecordMaze::Rotate(int rotation) const {
+  const internal::RotationMap map =
+      internal::MakeRotationMap(rotation, area_.size);
+  CellRecordMaze result(map.extents);
+  VisitRecordsIntersection(area_, [&map, &result](int i, int j,
+                                                  const CellRecord* records,
+                                                  int count) {
+    const Pos start = map.Apply(i, j);
+    int index = result.Index(start.row, start.col);
+    const int step =
+        map.col_step.d_row * map.extents.width + map.col_step.d_col;
+    for (int k = 0; k < count; ++k, index += step) {
+      result.cells_[index] = records[k];
+    }
+  });
+  return result;
+}
+
+void CellRecordMaze::PasteCells(Pos pos, const CellRecordMaze& maze) {
+  VisitMutableRecordsIntersection(
+      {pos, maze.Area().size},
+      [&maze, &pos](int i, int j, CellRecord* records, int count) {
+        std::copy_n(&maze.cells_[maze.Index(i - pos.row, j - pos.col)], count,
+                    records);
+      });
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
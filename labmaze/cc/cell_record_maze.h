@@ -0,0 +1,281 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#ifndef LABMAZE_CC_CELL_RECORD_MAZE_H_
+#define LABMAZE_CC_CELL_RECORD_MAZE_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// All the state of one cell of a CellRecordMaze.
+struct CellRecord {
+  char entity;
+  char variation;
+  std::uint16_t id;
+};
+
+// A maze with the cell interface of TextMaze that stores each cell as one
+// CellRecord, so passes that read or move every layer of a cell, such as
+// Rotate, PasteCells and AddRoomVariations, touch one 4-byte record instead of
+// three separate arrays. Passes over a single layer are better served by
+// TextMaze: VisitRows and the other row visitors gather each row into a buffer
+// (and scatter it back for the mutable ones), which is what lets all
+// algorithm.h functions accept a CellRecordMaze. Ids shall not exceed MaxId().
+class CellRecordMaze {
+ public:
+  using Layer = TextMaze::Layer;
+  using Id = std::uint16_t;
+
+  // Creates a maze with the entity layer filled with '*', the variations layer
+  // filled with '.' and all ids set to 0.
+  explicit CellRecordMaze(Size extents);
+
+  // Copies both layers and the ids of 'maze', whose ids shall not exceed
+  // MaxId().
+  explicit CellRecordMaze(const TextMaze& maze);
+
+  // Returns a TextMaze with the same layers and ids.
+  TextMaze ToTextMaze() const;
+
+  const Rectangle& Area() const { return area_; }
+
+  // Largest id the id layer can hold.
+  static constexpr unsigned int MaxId() {
+    return std::numeric_limits<Id>::max();
+  }
+
+  // Calls f(i, j, records, count) for each row (i, j) to (i, j + count - 1) of
+  // the intersection of the maze and 'rect', where 'records' points at the
+  // 'count' contiguous records of the row.
+  template <typename F>
+  void VisitRecordsIntersection(const Rectangle& rect, F&& f) const {
+    const Rectangle overlap = Overlap(area_, rect);
+    for (int i = overlap.pos.row; i < overlap.pos.row + overlap.size.height;
+         ++i) {
+      f(i, overlap.pos.col, &cells_[Index(i, overlap.pos.col)],
+        overlap.size.width);
+    }
+  }
+
+  template <typename F>
+  void VisitMutableRecordsIntersection(const Rectangle& rect, F&& f) {
+    const Rectangle overlap = Overlap(area_, rect);
+    for (int i = overlap.pos.row; i < overlap.pos.row + overlap.size.height;
+         ++i) {
+      f(i, overlap.pos.col, &cells_[Index(i, overlap.pos.col)],
+        overlap.size.width);
+    }
+  }
+
+  // See TextMaze::VisitIntersection.
+  template <typename F>
+  void VisitIntersection(Layer layer, const Rectangle& rect, F&& f) const {
+    const char CellRecord::*field = Field(layer);
+    VisitRecordsIntersection(rect, [field, &f](int i, int j,
+                                               const CellRecord* records,
+                                               int count) {
+      for (int k = 0; k < count; ++k) {
+        f(i, j + k, records[k].*field);
+      }
+    });
+  }
+
+  // See TextMaze::VisitMutableIntersection.
+  template <typename F>
+  void VisitMutableIntersection(Layer layer, const Rectangle& rect, F&& f) {
+    char CellRecord::*field = Field(layer);
+    VisitMutableRecordsIntersection(
+        rect, [field, &f](int i, int j, CellRecord* records, int count) {
+          for (int k = 0; k < count; ++k) {
+            f(i, j + k, &(records[k].*field));
+          }
+        });
+  }
+
+  template <typename F>
+  void Visit(Layer layer, F&& f) const {
+    VisitIntersection(layer, area_, std::forward<F>(f));
+  }
+
+  template <typename F>
+  void VisitMutable(Layer layer, F&& f) {
+    VisitMutableIntersection(layer, area_, std::forward<F>(f));
+  }
+
+  // See TextMaze::VisitRowsIntersection. Each row is gathered into a buffer.
+  template <typename F>
+  void VisitRowsIntersection(Layer layer, const Rectangle& rect, F&& f) const {
+    const char CellRecord::*field = Field(layer);
+    std::string row;
+    VisitRecordsIntersection(rect, [field, &f, &row](int i, int j,
+                                                     const CellRecord* records,
+                                                     int count) {
+      row.resize(count);
+      for (int k = 0; k < count; ++k) {
+        row[k] = records[k].*field;
+      }
+      f(i, j, row.data(), count);
+    });
+  }
+
+  // See TextMaze::VisitMutableRowsIntersection. Each row is gathered into a
+  // buffer and scattered back after 'f' returns.
+  template <typename F>
+  void VisitMutableRowsIntersection(Layer layer, const Rectangle& rect, F&& f) {
+    char CellRecord::*field = Field(layer);
+    std::string row;
+    VisitMutableRecordsIntersection(
+        rect, [field, &f, &row](int i, int j, CellRecord* records, int count) {
+          row.resize(count);
+          for (int k = 0; k < count; ++k) {
+            row[k] = records[k].*field;
+          }
+          f(i, j, &row[0], count);
+          for (int k = 0; k < count; ++k) {
+            records[k].*field = row[k];
+          }
+        });
+  }
+
+  template <typename F>
+  void VisitRows(Layer layer, F&& f) const {
+    VisitRowsIntersection(layer, area_, std::forward<F>(f));
+  }
+
+  template <typename F>
+  void VisitMutableRows(Layer layer, F&& f) {
+    VisitMutableRowsIntersection(layer, area_, std::forward<F>(f));
+  }
+
+  // See TextMaze::VisitMutableRowsWithIdsIntersection. 'ids' always points at
+  // const Id. Cells and ids are gathered as in VisitMutableRowsIntersection.
+  template <typename F>
+  void VisitMutableRowsWithIdsIntersection(Layer layer, const Rectangle& rect,
+                                           F&& f) {
+    std::vector<Id> ids;
+    VisitMutableRowsIntersection(
+        layer, rect, [this, &f, &ids](int i, int j, char* cells, int count) {
+          ids.resize(count);
+          for (int k = 0; k < count; ++k) {
+            ids[k] = cells_[Index(i, j + k)].id;
+          }
+          const Id* row_ids = ids.data();
+          f(i, j, cells, row_ids, count);
+        });
+  }
+
+  // See TextMaze::VisitMutableWithIdsIntersection.
+  template <typename F>
+  void VisitMutableWithIdsIntersection(Layer layer, const Rectangle& rect,
+                                       F&& f) {
+    char CellRecord::*field = Field(layer);
+    VisitMutableRecordsIntersection(
+        rect, [field, &f](int i, int j, CellRecord* records, int count) {
+          for (int k = 0; k < count; ++k) {
+            f(i, j + k, &(records[k].*field),
+              static_cast<unsigned int>(records[k].id));
+          }
+        });
+  }
+
+  // Returns the character at 'pos', or '\0' if 'pos' is out of bounds.
+  char GetCell(Layer layer, Pos pos) const {
+    return area_.InBounds(pos) ? cells_[Index(pos.row, pos.col)].*Field(layer)
+                               : '\0';
+  }
+
+  // Sets the character at 'pos' if 'pos' is in bounds.
+  void SetCell(Layer layer, Pos pos, char value) {
+    if (area_.InBounds(pos)) {
+      cells_[Index(pos.row, pos.col)].*Field(layer) = value;
+    }
+  }
+
+  void FillRect(Layer layer, const Rectangle& rect, char value) {
+    VisitMutableIntersection(layer, rect,
+                             [value](int, int, char* c) { *c = value; });
+  }
+
+  // Returns the id at 'pos', or 0 if 'pos' is out of bounds.
+  unsigned int GetCellId(Pos pos) const {
+    return area_.InBounds(pos) ? cells_[Index(pos.row, pos.col)].id : 0;
+  }
+
+  // Sets the id at 'pos' if 'pos' is in bounds. 'id' shall not exceed MaxId().
+  void SetCellId(Pos pos, unsigned int id) {
+    if (id > MaxId()) {
+      IdOutOfRange(id);
+    }
+    if (area_.InBounds(pos)) {
+      cells_[Index(pos.row, pos.col)].id = id;
+    }
+  }
+
+  // See TextMaze::BorderedLayer.
+  BorderedGrid<char> BorderedLayer(Layer layer, char border) const;
+
+  // See TextMaze::AssignLayer.
+  void AssignLayer(Layer layer, const BorderedGrid<char>& grid);
+
+  // Returns the text of 'layer' in the format of TextMaze::Text.
+  std::string Text(Layer layer) const;
+
+  // See TextMaze::Rotate. Moves whole records.
+  CellRecordMaze Rotate(int rotation) const;
+
+  // See TextMaze::Paste.
+  void Paste(Layer layer, Pos pos, const CellRecordMaze& maze) {
+    char CellRecord::*field = Field(layer);
+    VisitMutableRecordsIntersection(
+        {pos, maze.Area().size},
+        [&maze, &pos, field](int i, int j, CellRecord* records, int count) {
+          const CellRecord* source =
+              &maze.cells_[maze.Index(i - pos.row, j - pos.col)];
+          for (int k = 0; k < count; ++k) {
+            records[k].*field = source[k].*field;
+          }
+        });
+  }
+
+  // Copies all layers and ids of 'maze' into the cells starting at 'pos',
+  // clamped to the bounds of this maze.
+  void PasteCells(Pos pos, const CellRecordMaze& maze);
+
+ private:
+  int Index(int i, int j) const { return i * area_.size.width + j; }
+
+  [[noreturn]] static void IdOutOfRange(unsigned int id);
+
+  static char CellRecord::*Field(Layer layer) {
+    return layer == TextMaze::kEntityLayer ? &CellRecord::entity
+                                           : &CellRecord::variation;
+  }
+
+  Rectangle area_;
+  std::vector<CellRecord> cells_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_CELL_RECORD_MAZE_H_
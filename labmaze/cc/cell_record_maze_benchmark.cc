@@ -0,0 +1,130 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares the per-layer TextMaze with the interleaved CellRecordMaze on the
+// passes that touch every layer of a cell.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/cell_record_maze.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns a maze of size 'size' x 'size' with rooms, variations and region ids
+// in 8x8 blocks.
+TextMaze MakeTextMaze(int size) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = size / 4;
+  params.max_variations = 26;
+  const RandomMaze random_maze(params, 1);
+  TextMaze maze = FromCharGrid(CharGrid(random_maze.EntityLayer()),
+                               CharGrid(random_maze.VariationsLayer()));
+  maze.Area().Visit([&maze, size](int i, int j) {
+    maze.SetCellId({i, j}, (i / 8) * ((size + 7) / 8) + j / 8 + 1);
+  });
+  return maze;
+}
+
+template <typename Maze>
+Maze MakeMaze(int size);
+
+template <>
+TextMaze MakeMaze(int size) {
+  return MakeTextMaze(size);
+}
+
+template <>
+CellRecordMaze MakeMaze(int size) {
+  return CellRecordMaze(MakeTextMaze(size));
+}
+
+void SetCellsProcessed(int size, benchmark::State* state) {
+  state->SetItemsProcessed(state->iterations() * size * size);
+}
+
+template <typename Maze>
+void BM_Rotate(benchmark::State& state) {
+  const Maze maze = MakeMaze<Maze>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(maze.Rotate(1));
+  }
+  SetCellsProcessed(state.range(0), &state);
+}
+BENCHMARK_TEMPLATE(BM_Rotate, TextMaze)->Arg(31)->Arg(101);
+BENCHMARK_TEMPLATE(BM_Rotate, CellRecordMaze)->Arg(31)->Arg(101);
+
+template <typename Maze>
+void BM_AddRoomVariations(benchmark::State& state) {
+  Maze maze = MakeMaze<Maze>(state.range(0));
+  const unsigned int num_rooms = state.range(0) * state.range(0) / 128;
+  for (auto _ : state) {
+    AddRoomVariations(num_rooms, 26, &maze);
+    benchmark::ClobberMemory();
+  }
+  SetCellsProcessed(state.range(0), &state);
+}
+BENCHMARK_TEMPLATE(BM_AddRoomVariations, TextMaze)->Arg(31)->Arg(101);
+BENCHMARK_TEMPLATE(BM_AddRoomVariations, CellRecordMaze)->Arg(31)->Arg(101);
+
+// Pastes both layers of a maze into one twice its size.
+void BM_PasteLayers(benchmark::State& state) {
+  const int size = state.range(0);
+  const TextMaze source = MakeTextMaze(size);
+  TextMaze maze({2 * size, 2 * size});
+  for (auto _ : state) {
+    maze.Paste(TextMaze::kEntityLayer, {size / 2, size / 2}, source);
+    maze.Paste(TextMaze::kVariationsLayer, {size / 2, size / 2}, source);
+    benchmark::ClobberMemory();
+  }
+  SetCellsProcessed(size, &state);
+}
+BENCHMARK(BM_PasteLayers)->Arg(31)->Arg(101);
+
+void BM_PasteCells(benchmark::State& state) {
+  const int size = state.range(0);
+  const CellRecordMaze source = MakeMaze<CellRecordMaze>(size);
+  CellRecordMaze maze({2 * size, 2 * size});
+  for (auto _ : state) {
+    maze.PasteCells({size / 2, size / 2}, source);
+    benchmark::ClobberMemory();
+  }
+  SetCellsProcessed(size, &state);
+}
+BENCHMARK(BM_PasteCells)->Arg(31)->Arg(101);
+
+// The cost of producing the per-layer text on demand.
+template <typename Maze>
+void BM_Text(benchmark::State& state) {
+  const Maze maze = MakeMaze<Maze>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(maze.Text(TextMaze::kEntityLayer));
+  }
+  SetCellsProcessed(state.range(0), &state);
+}
+BENCHMARK_TEMPLATE(BM_Text, TextMaze)->Arg(31)->Arg(101);
+BENCHMARK_TEMPLATE(BM_Text, CellRecordMaze)->Arg(31)->Arg(101);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
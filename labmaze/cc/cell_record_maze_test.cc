@@ -0,0 +1,174 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/cell_record_maze.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+static_assert(sizeof(CellRecord) == 4, "A CellRecord shall be 4 bytes.");
+
+// Returns a generated maze with ids set in 4x4 blocks.
+TextMaze MakeMaze() {
+  RandomMazeParams params;
+  params.height = 11;
+  params.width = 13;
+  params.objects_per_room = 1;
+  const RandomMaze random_maze(params, 3);
+  // Rebuilds the maze, as RandomMaze releases its id layer.
+  TextMaze maze = FromCharGrid(CharGrid(random_maze.EntityLayer()),
+                               CharGrid(random_maze.VariationsLayer()));
+  maze.Area().Visit([&maze](int i, int j) {
+    maze.SetCellId({i, j}, (i / 4) * 4 + j / 4);
+  });
+  return maze;
+}
+
+void ExpectSameMaze(const TextMaze& expected, const CellRecordMaze& actual) {
+  ASSERT_EQ(expected.Area().size.height, actual.Area().size.height);
+  ASSERT_EQ(expected.Area().size.width, actual.Area().size.width);
+  EXPECT_EQ(expected.Text(TextMaze::kEntityLayer),
+            actual.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(expected.Text(TextMaze::kVariationsLayer),
+            actual.Text(TextMaze::kVariationsLayer));
+  expected.Area().Visit([&expected, &actual](int i, int j) {
+    EXPECT_EQ(expected.GetCellId({i, j}), actual.GetCellId({i, j}));
+  });
+}
+
+TEST(CellRecordMazeTest, Defaults) {
+  const CellRecordMaze maze({3, 4});
+  ExpectSameMaze(TextMaze({3, 4}), maze);
+  EXPECT_EQ('\0', maze.GetCell(TextMaze::kVariationsLayer, {3, 0}));
+  EXPECT_EQ(0, maze.GetCellId({-1, 0}));
+}
+
+TEST(CellRecordMazeTest, TextMazeRoundTrip) {
+  const TextMaze text_maze = MakeMaze();
+  const CellRecordMaze maze(text_maze);
+  ExpectSameMaze(text_maze, maze);
+  ExpectSameMaze(maze.ToTextMaze(), maze);
+}
+
+TEST(CellRecordMazeTest, CellsShareRecords) {
+  CellRecordMaze maze({2, 2});
+  maze.SetCell(TextMaze::kEntityLayer, {1, 0}, 'G');
+  maze.SetCell(TextMaze::kVariationsLayer, {1, 0}, 'A');
+  maze.SetCellId({1, 0}, 300);
+  maze.VisitRecordsIntersection(
+      {{1, 0}, {1, 1}},
+      [](int i, int j, const CellRecord* records, int count) {
+        EXPECT_EQ(1, i);
+        EXPECT_EQ(0, j);
+        ASSERT_EQ(1, count);
+        EXPECT_EQ('G', records[0].entity);
+        EXPECT_EQ('A', records[0].variation);
+        EXPECT_EQ(300, records[0].id);
+      });
+}
+
+TEST(CellRecordMazeTest, RotateMatchesTextMaze) {
+  const TextMaze text_maze = MakeMaze();
+  const CellRecordMaze maze(text_maze);
+  for (int rotation = -2; rotation <= 4; ++rotation) {
+    ExpectSameMaze(text_maze.Rotate(rotation), maze.Rotate(rotation));
+  }
+}
+
+TEST(CellRecordMazeTest, PasteMatchesTextMaze) {
+  const TextMaze source = MakeMaze();
+  const CellRecordMaze record_source(source);
+  for (Pos pos : {Pos{0, 0}, Pos{3, -2}, Pos{-4, 5}}) {
+    TextMaze text_maze({9, 15});
+    CellRecordMaze maze({9, 15});
+    text_maze.Paste(TextMaze::kVariationsLayer, pos, source);
+    maze.Paste(TextMaze::kVariationsLayer, pos, record_source);
+    ExpectSameMaze(text_maze, maze);
+
+    // PasteCells copies every layer and the ids.
+    text_maze.Paste(TextMaze::kEntityLayer, pos, source);
+    Rectangle{pos, source.Area().size}.Visit([&](int i, int j) {
+      text_maze.SetCellId({i, j}, source.GetCellId({i - pos.row, j - pos.col}));
+    });
+    CellRecordMaze all_layers({9, 15});
+    all_layers.PasteCells(pos, record_source);
+    ExpectSameMaze(text_maze, all_layers);
+  }
+}
+
+TEST(CellRecordMazeTest, AddRoomVariationsMatchesTextMaze) {
+  TextMaze text_maze = MakeMaze();
+  CellRecordMaze maze(text_maze);
+  AddRoomVariations(5, 3, &text_maze);
+  AddRoomVariations(5, 3, &maze);
+  ExpectSameMaze(text_maze, maze);
+}
+
+TEST(CellRecordMazeTest, GenerationMatchesTextMaze) {
+  const Rectangle room{{3, 5}, {5, 5}};
+  TextMaze text_maze({15, 17});
+  CellRecordMaze maze({15, 17});
+  text_maze.FillRect(TextMaze::kEntityLayer, room, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, room, ' ');
+  room.Visit([&text_maze, &maze](int i, int j) {
+    text_maze.SetCellId({i, j}, 1);
+    maze.SetCellId({i, j}, 1);
+  });
+
+  std::mt19937_64 text_maze_rng(5);
+  std::mt19937_64 rng(5);
+  FillSpaceWithMaze(2, 0, &text_maze, &text_maze_rng);
+  FillSpaceWithMaze(2, 0, &maze, &rng);
+  RandomConnectRegions('D', 0.1, &text_maze, &text_maze_rng);
+  RandomConnectRegions('D', 0.1, &maze, &rng);
+  RemoveDeadEnds(' ', '*', {}, &text_maze);
+  RemoveDeadEnds(' ', '*', {}, &maze);
+  RemoveAllHorseshoeBends('*', {}, &text_maze);
+  RemoveAllHorseshoeBends('*', {}, &maze);
+  AddRoomVariations(1, 1, &text_maze);
+  AddRoomVariations(1, 1, &maze);
+  AddNEntitiesToEachRoom({room}, 2, 'G', ' ', &text_maze, &text_maze_rng);
+  AddNEntitiesToEachRoom({room}, 2, 'G', ' ', &maze, &rng);
+  ExpectSameMaze(text_maze, maze);
+
+  const auto expected_rooms = FindRooms(text_maze, {'*'});
+  const auto rooms = FindRooms(maze, {'*'});
+  ASSERT_EQ(expected_rooms.size(), rooms.size());
+  for (std::size_t i = 0; i < rooms.size(); ++i) {
+    ASSERT_EQ(expected_rooms[i].size(), rooms[i].size());
+    for (std::size_t j = 0; j < rooms[i].size(); ++j) {
+      EXPECT_EQ(expected_rooms[i][j], rooms[i][j]);
+    }
+  }
+}
+
+TEST(CellRecordMazeDeathTest, IdOutOfRange) {
+  TextMaze text_maze({2, 2});
+  text_maze.SetCellId({1, 1}, CellRecordMaze::MaxId() + 1);
+  EXPECT_DEATH(CellRecordMaze maze(text_maze), "exceeds the maximum id");
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -49,6 +49,12 @@ class CharGrid {
     return i < height() && j < rows_[i].size() ? rows_[i][j] : '\0';
   }
 
+  // Cells of row i, which may be shorter than width(), or an empty row if i is
+  // out of bounds.
+  absl::string_view Row(std::size_t i) const {
+    return i < height() ? rows_[i] : absl::string_view();
+  }
+
  private:
   std::string raw_data_;
   std::vector<absl::string_view> rows_;
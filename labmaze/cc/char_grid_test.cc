@@ -31,6 +31,10 @@ TEST(CharGridTest, Simple) {
 
   EXPECT_EQ('\0', grid.CellAt(2, 0));
   EXPECT_EQ('\0', grid.CellAt(0, 4));
+
+  EXPECT_EQ("abc", grid.Row(0));
+  EXPECT_EQ("12345", grid.Row(1));
+  EXPECT_EQ("", grid.Row(2));
 }
 
 }  // namespace
@@ -0,0 +1,229 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/connected_components.h"
+
+#include <algorithm>
+
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/parallel_for.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// The first pass builds a union-find forest over cell indices in 'parents',
+// with -1 for cells not in the set. Every parent index is less than its
+// child's, so the root of each tree is the first cell of its component in
+// row-major order.
+
+int Find(int index, std::vector<int>* parents) {
+  auto& p = *parents;
+  int root = index;
+  while (p[root] != root) {
+    root = p[root];
+  }
+  while (p[index] != root) {
+    const int next = p[index];
+    p[index] = root;
+    index = next;
+  }
+  return root;
+}
+
+void Union(int lhs, int rhs, std::vector<int>* parents) {
+  lhs = Find(lhs, parents);
+  rhs = Find(rhs, parents);
+  if (lhs < rhs) {
+    (*parents)[rhs] = lhs;
+  } else {
+    (*parents)[lhs] = rhs;
+  }
+}
+
+// Links the cells of rows ['begin', 'end') to their neighbours above and to
+// the left within those rows.
+void LinkRows(Size size, const std::vector<std::uint8_t>& in_set, int begin,
+              int end, std::vector<int>* parents) {
+  auto& p = *parents;
+  const int width = size.width;
+  for (int i = begin; i < end; ++i) {
+    for (int index = i * width; index < (i + 1) * width; ++index) {
+      if (!in_set[index]) {
+        continue;
+      }
+      const bool up = i > begin && in_set[index - width];
+      const bool left = index > i * width && in_set[index - 1];
+      if (up) {
+        p[index] = p[index - width];
+        if (left) {
+          Union(index - 1, index, parents);
+        }
+      } else if (left) {
+        p[index] = p[index - 1];
+      } else {
+        p[index] = index;
+      }
+    }
+  }
+}
+
+// Fills in the offsets, cells and bounds of 'components' from its labels.
+void BuildCompressedRows(int num_components, ConnectedComponents* components) {
+  const int width = components->size.width;
+  const auto& labels = components->labels;
+  auto& offsets = components->offsets;
+  offsets.assign(num_components + 1, 0);
+  for (int label : labels) {
+    if (label >= 0) {
+      ++offsets[label + 1];
+    }
+  }
+  for (int k = 0; k < num_components; ++k) {
+    offsets[k + 1] += offsets[k];
+  }
+  components->cells.resize(offsets[num_components]);
+  components->bounds.assign(num_components, Rectangle{{0, 0}, {0, 0}});
+  std::vector<int> next(offsets.begin(), offsets.end() - 1);
+  for (int i = 0; i < components->size.height; ++i) {
+    const int* row = &labels[i * width];
+    for (int j = 0; j < width; ++j) {
+      const int label = row[j];
+      if (label < 0) {
+        continue;
+      }
+      components->cells[next[label]++] = {i, j};
+      auto& bounds = components->bounds[label];
+      if (bounds.size.height == 0) {
+        bounds = {{i, j}, {1, 1}};
+        continue;
+      }
+      // Rows only grow in row-major order; columns can extend either way.
+      bounds.size.height = i - bounds.pos.row + 1;
+      if (j < bounds.pos.col) {
+        bounds.size.width += bounds.pos.col - j;
+        bounds.pos.col = j;
+      } else if (j >= bounds.pos.col + bounds.size.width) {
+        bounds.size.width = j - bounds.pos.col + 1;
+      }
+    }
+  }
+}
+
+// Calls f(strip) for 'num_strips' strips, each on its own thread.
+template <typename F>
+void RunStrips(int num_strips, const F& f) {
+  internal::ParallelFor(num_strips, num_strips, f);
+}
+
+}  // namespace
+
+ConnectedComponents LabelComponents(Size size,
+                                    const std::vector<std::uint8_t>& in_set) {
+  CHECK_EQ(in_set.size(), static_cast<std::size_t>(size.height) * size.width);
+  ConnectedComponents result;
+  result.size = size;
+  auto& labels = result.labels;
+  labels.assign(in_set.size(), -1);
+  LinkRows(size, in_set, 0, size.height, &labels);
+
+  // Second pass: every parent precedes its child, so a child's parent already
+  // holds its final label.
+  int num_components = 0;
+  for (int index = 0; index < static_cast<int>(labels.size()); ++index) {
+    const int parent = labels[index];
+    if (parent >= 0) {
+      labels[index] = parent == index ? num_components++ : labels[parent];
+    }
+  }
+  BuildCompressedRows(num_components, &result);
+  return result;
+}
+
+ConnectedComponents LabelComponentsParallel(
+    Size size, const std::vector<std::uint8_t>& in_set, int num_threads) {
+  CHECK_EQ(in_set.size(), static_cast<std::size_t>(size.height) * size.width);
+  const int num_strips = std::max(
+      1, std::min(internal::ResolveNumThreads(num_threads), size.height));
+  const int width = size.width;
+  const auto strip_begin = [&size, num_strips](int strip) {
+    return static_cast<int>(static_cast<long long>(size.height) * strip /
+                            num_strips);
+  };
+
+  ConnectedComponents result;
+  result.size = size;
+  auto& labels = result.labels;
+  labels.assign(in_set.size(), -1);
+  RunStrips(num_strips, [&](int strip) {
+    LinkRows(size, in_set, strip_begin(strip), strip_begin(strip + 1), &labels);
+  });
+  for (int strip = 1; strip < num_strips; ++strip) {
+    const int row = strip_begin(strip);
+    for (int index = row * width; index < (row + 1) * width; ++index) {
+      if (in_set[index] && in_set[index - width]) {
+        Union(index - width, index, &labels);
+      }
+    }
+  }
+
+  // Resolve the root of every cell, leaving the forest untouched while other
+  // strips read it, and count the roots of each strip.
+  std::vector<int> roots(labels.size(), -1);
+  std::vector<int> strip_components(num_strips + 1, 0);
+  RunStrips(num_strips, [&](int strip) {
+    int count = 0;
+    for (int index = strip_begin(strip) * width;
+         index < strip_begin(strip + 1) * width; ++index) {
+      int root = labels[index];
+      if (root < 0) {
+        continue;
+      }
+      while (labels[root] != root) {
+        root = labels[root];
+      }
+      roots[index] = root;
+      count += root == index;
+    }
+    strip_components[strip + 1] = count;
+  });
+  for (int strip = 0; strip < num_strips; ++strip) {
+    strip_components[strip + 1] += strip_components[strip];
+  }
+  // Number the roots, then copy their numbers to the other cells.
+  RunStrips(num_strips, [&](int strip) {
+    int label = strip_components[strip];
+    for (int index = strip_begin(strip) * width;
+         index < strip_begin(strip + 1) * width; ++index) {
+      if (roots[index] == index) {
+        labels[index] = label++;
+      }
+    }
+  });
+  RunStrips(num_strips, [&](int strip) {
+    for (int index = strip_begin(strip) * width;
+         index < strip_begin(strip + 1) * width; ++index) {
+      const int root = roots[index];
+      if (root >= 0 && root != index) {
+        labels[index] = labels[root];
+      }
+    }
+  });
+  BuildCompressedRows(strip_components[num_strips], &result);
+  return result;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,74 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Connected-component labelling of cell sets.
+
+#ifndef LABMAZE_CC_CONNECTED_COMPONENTS_H_
+#define LABMAZE_CC_CONNECTED_COMPONENTS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// The 4-connected components of a set of cells, in compressed sparse row form.
+// Components are numbered from 0 in row-major order of their first cell.
+struct ConnectedComponents {
+  Size size;
+  // Component of each cell in row-major order, or -1 for cells not in the set.
+  std::vector<int> labels;
+  // The cells of component k are cells[offsets[k]] to cells[offsets[k + 1] -
+  // 1], in row-major order.
+  std::vector<int> offsets;
+  std::vector<Pos> cells;
+  // Bounding box of each component.
+  std::vector<Rectangle> bounds;
+
+  int NumComponents() const { return static_cast<int>(bounds.size()); }
+
+  // Returns the component of 'pos', or -1 if 'pos' is out of bounds or not in
+  // the set.
+  int Label(Pos pos) const {
+    return Rectangle{{0, 0}, size}.InBounds(pos)
+               ? labels[pos.row * size.width + pos.col]
+               : -1;
+  }
+
+  // Returns the number of cells of component 'k'.
+  int ComponentSize(int k) const { return offsets[k + 1] - offsets[k]; }
+
+  // Returns a pointer to the ComponentSize(k) cells of component 'k'.
+  const Pos* ComponentCells(int k) const { return cells.data() + offsets[k]; }
+};
+
+// Labels the components of the cells (i, j) of a grid of 'size' for which
+// in_set[i * size.width + j] is non-zero, with a two-pass union-find in time
+// linear in the number of cells.
+ConnectedComponents LabelComponents(Size size,
+                                    const std::vector<std::uint8_t>& in_set);
+
+// Like LabelComponents, but labels horizontal strips of rows on up to
+// 'num_threads' threads before joining the strips along their seams. A
+// 'num_threads' of 0 uses all cores. The result is identical.
+ConnectedComponents LabelComponentsParallel(
+    Size size, const std::vector<std::uint8_t>& in_set, int num_threads);
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_CONNECTED_COMPONENTS_H_
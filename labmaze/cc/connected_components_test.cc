@@ -0,0 +1,149 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/connected_components.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+std::vector<std::uint8_t> MakeMask(const std::vector<std::string>& rows) {
+  std::vector<std::uint8_t> mask;
+  for (const auto& row : rows) {
+    for (char c : row) {
+      mask.push_back(c != '*');
+    }
+  }
+  return mask;
+}
+
+std::vector<std::uint8_t> MakeRandomMask(Size size, double probability,
+                                         std::mt19937_64* rng) {
+  std::bernoulli_distribution in_set(probability);
+  std::vector<std::uint8_t> mask(size.height * size.width);
+  for (auto& cell : mask) {
+    cell = in_set(*rng);
+  }
+  return mask;
+}
+
+void ExpectSameComponents(const ConnectedComponents& expected,
+                          const ConnectedComponents& actual) {
+  EXPECT_EQ(expected.labels, actual.labels);
+  EXPECT_EQ(expected.offsets, actual.offsets);
+  ASSERT_EQ(expected.cells.size(), actual.cells.size());
+  for (std::size_t i = 0; i < expected.cells.size(); ++i) {
+    EXPECT_EQ(expected.cells[i], actual.cells[i]);
+  }
+  ASSERT_EQ(expected.NumComponents(), actual.NumComponents());
+  for (int k = 0; k < expected.NumComponents(); ++k) {
+    EXPECT_EQ(expected.bounds[k].pos, actual.bounds[k].pos);
+    EXPECT_EQ(expected.bounds[k].size.height, actual.bounds[k].size.height);
+    EXPECT_EQ(expected.bounds[k].size.width, actual.bounds[k].size.width);
+  }
+}
+
+TEST(ConnectedComponentsTest, LabelsInRowMajorOrder) {
+  // The U-shaped component is only joined at its bottom row, after the
+  // component on its right has started.
+  const auto components = LabelComponents({4, 6}, MakeMask({" * * *",  //
+                                                            " * * *",  //
+                                                            "   ***",  //
+                                                            "****  "}));
+  ASSERT_EQ(3, components.NumComponents());
+  EXPECT_EQ(0, components.Label({0, 0}));
+  EXPECT_EQ(0, components.Label({0, 2}));
+  EXPECT_EQ(1, components.Label({0, 4}));
+  EXPECT_EQ(2, components.Label({3, 4}));
+  EXPECT_EQ(-1, components.Label({0, 1}));
+  EXPECT_EQ(-1, components.Label({4, 0}));
+
+  EXPECT_EQ((std::vector<int>{0, 7, 9, 11}), components.offsets);
+  EXPECT_EQ((Pos{0, 2}), components.ComponentCells(0)[1]);
+  EXPECT_EQ((Pos{2, 2}), components.ComponentCells(0)[6]);
+  EXPECT_EQ(2, components.ComponentSize(1));
+
+  EXPECT_EQ((Pos{0, 0}), components.bounds[0].pos);
+  EXPECT_EQ(3, components.bounds[0].size.height);
+  EXPECT_EQ(3, components.bounds[0].size.width);
+  EXPECT_EQ((Pos{3, 4}), components.bounds[2].pos);
+  EXPECT_EQ(1, components.bounds[2].size.height);
+  EXPECT_EQ(2, components.bounds[2].size.width);
+}
+
+TEST(ConnectedComponentsTest, MatchesFloodFill) {
+  std::mt19937_64 rng(1);
+  for (Size size : {Size{1, 1}, Size{1, 40}, Size{40, 1}, Size{23, 37}}) {
+    for (double probability : {0.3, 0.6, 0.9}) {
+      const auto mask = MakeRandomMask(size, probability, &rng);
+      const auto components = LabelComponents(size, mask);
+      BorderedGrid<int> distances(size, -2, -2);
+      for (int i = 0; i < size.height; ++i) {
+        for (int j = 0; j < size.width; ++j) {
+          if (mask[i * size.width + j]) {
+            distances[distances.Index(i, j)] = -1;
+          }
+        }
+      }
+      int k = 0;
+      Rectangle{{0, 0}, size}.Visit([&](int i, int j) {
+        std::vector<Pos> connected;
+        if (internal::FloodFill({i, j}, &distances, &connected)) {
+          ASSERT_LT(k, components.NumComponents());
+          ASSERT_EQ(connected.size(), components.ComponentSize(k));
+          for (const Pos& pos : connected) {
+            EXPECT_EQ(k, components.Label(pos));
+          }
+          ++k;
+        }
+      });
+      EXPECT_EQ(k, components.NumComponents());
+    }
+  }
+}
+
+TEST(ConnectedComponentsTest, ParallelMatchesSerial) {
+  std::mt19937_64 rng(2);
+  for (Size size : {Size{1, 9}, Size{3, 3}, Size{57, 31}, Size{64, 64}}) {
+    for (double probability : {0.4, 0.6}) {
+      const auto mask = MakeRandomMask(size, probability, &rng);
+      const auto expected = LabelComponents(size, mask);
+      for (int num_threads : {0, 2, 3, 8}) {
+        ExpectSameComponents(
+            expected, LabelComponentsParallel(size, mask, num_threads));
+      }
+    }
+  }
+}
+
+TEST(ConnectedComponentsTest, Empty) {
+  const auto components = LabelComponents({0, 5}, {});
+  EXPECT_EQ(0, components.NumComponents());
+  EXPECT_EQ(std::vector<int>{0}, components.offsets);
+  EXPECT_EQ(0, LabelComponentsParallel({0, 5}, {}, 4).NumComponents());
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
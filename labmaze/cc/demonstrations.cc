@@ -0,0 +1,244 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/demonstrations.h"
+
+#include <cstring>
+
+#include "labmaze/cc/direction.h"
+#include "labmaze/cc/logging.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+constexpr char kHeaderMagic[] = "LMDEMOS1";
+constexpr char kFooterMagic[] = "LMDEMEND";
+constexpr std::size_t kMagicSize = 8;
+constexpr std::size_t kFooterSize = 8 + 8 + kMagicSize;
+constexpr int kMaxRun = 64;
+
+void AppendLittleEndian(std::uint64_t value, int num_bytes, std::string* out) {
+  for (int i = 0; i < num_bytes; ++i) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+std::uint64_t ReadLittleEndian(const char* data, int num_bytes) {
+  std::uint64_t value = 0;
+  for (int i = 0; i < num_bytes; ++i) {
+    value |= std::uint64_t{static_cast<unsigned char>(data[i])} << (8 * i);
+  }
+  return value;
+}
+
+std::size_t PackedSize(std::size_t num_actions) {
+  return (num_actions + 3) / 4;
+}
+
+std::size_t RunLengthSize(const std::vector<std::uint8_t>& actions) {
+  std::size_t size = 0;
+  for (std::size_t k = 0; k < actions.size();) {
+    std::size_t run = 1;
+    while (run < kMaxRun && k + run < actions.size() &&
+           actions[k + run] == actions[k]) {
+      ++run;
+    }
+    ++size;
+    k += run;
+  }
+  return size;
+}
+
+}  // namespace
+
+std::vector<std::uint8_t> PathActions(const std::vector<Pos>& path) {
+  std::vector<std::uint8_t> actions;
+  if (path.empty()) return actions;
+  actions.reserve(path.size() - 1);
+  for (std::size_t k = 1; k < path.size(); ++k) {
+    const Vec step = {path[k].row - path[k - 1].row,
+                      path[k].col - path[k - 1].col};
+    int direction = 0;
+    while (direction < 4 &&
+           !(DirectionStep(direction).d_row == step.d_row &&
+             DirectionStep(direction).d_col == step.d_col)) {
+      ++direction;
+    }
+    CHECK_LT(direction, 4) << "Path cells " << k - 1 << " and " << k
+                           << " are not neighbours.";
+    actions.push_back(direction);
+  }
+  return actions;
+}
+
+ActionEncoding EncodeActions(const std::vector<std::uint8_t>& actions,
+                             std::string* out) {
+  if (RunLengthSize(actions) < PackedSize(actions.size())) {
+    for (std::size_t k = 0; k < actions.size();) {
+      int run = 1;
+      while (run < kMaxRun && k + run < actions.size() &&
+             actions[k + run] == actions[k]) {
+        ++run;
+      }
+      out->push_back(static_cast<char>(actions[k] | (run - 1) << 2));
+      k += run;
+    }
+    return ActionEncoding::kRunLength;
+  }
+  const std::size_t begin = out->size();
+  out->resize(begin + PackedSize(actions.size()), 0);
+  for (std::size_t k = 0; k < actions.size(); ++k) {
+    (*out)[begin + k / 4] |= static_cast<char>(actions[k] << (2 * (k % 4)));
+  }
+  return ActionEncoding::kPacked;
+}
+
+bool DecodeActions(ActionEncoding encoding, const char* data, std::size_t size,
+                   std::size_t num_actions,
+                   std::vector<std::uint8_t>* actions) {
+  actions->clear();
+  actions->reserve(num_actions);
+  switch (encoding) {
+    case ActionEncoding::kPacked:
+      if (size != PackedSize(num_actions)) return false;
+      for (std::size_t k = 0; k < num_actions; ++k) {
+        actions->push_back((static_cast<unsigned char>(data[k / 4]) >>
+                            (2 * (k % 4))) & 3);
+      }
+      return true;
+    case ActionEncoding::kRunLength:
+      for (std::size_t k = 0; k < size; ++k) {
+        const unsigned char code = data[k];
+        actions->insert(actions->end(), (code >> 2) + 1, code & 3);
+        if (actions->size() > num_actions) return false;
+      }
+      return actions->size() == num_actions;
+  }
+  return false;
+}
+
+void AppendDemonstration(const Demonstration& demonstration,
+                         std::string* out) {
+  AppendLittleEndian(demonstration.seed, 8, out);
+  AppendLittleEndian(demonstration.start.row, 2, out);
+  AppendLittleEndian(demonstration.start.col, 2, out);
+  AppendLittleEndian(demonstration.goal.row, 2, out);
+  AppendLittleEndian(demonstration.goal.col, 2, out);
+  AppendLittleEndian(demonstration.actions.size(), 4, out);
+  std::string codes;
+  const ActionEncoding encoding = EncodeActions(demonstration.actions, &codes);
+  out->push_back(static_cast<char>(encoding));
+  AppendLittleEndian(codes.size(), 4, out);
+  out->append(codes);
+}
+
+std::size_t ParseDemonstration(const char* data, std::size_t size,
+                               Demonstration* demonstration) {
+  if (size < kDemonstrationHeaderSize) return 0;
+  demonstration->seed = ReadLittleEndian(data, 8);
+  demonstration->start.row = ReadLittleEndian(data + 8, 2);
+  demonstration->start.col = ReadLittleEndian(data + 10, 2);
+  demonstration->goal.row = ReadLittleEndian(data + 12, 2);
+  demonstration->goal.col = ReadLittleEndian(data + 14, 2);
+  const std::size_t num_actions = ReadLittleEndian(data + 16, 4);
+  const auto encoding = static_cast<ActionEncoding>(data[20]);
+  const std::size_t num_bytes = ReadLittleEndian(data + 21, 4);
+  if (size - kDemonstrationHeaderSize < num_bytes ||
+      !DecodeActions(encoding, data + kDemonstrationHeaderSize, num_bytes,
+                     num_actions, &demonstration->actions)) {
+    return 0;
+  }
+  return kDemonstrationHeaderSize + num_bytes;
+}
+
+bool ParseDemonstrationsFile(const std::string& contents,
+                             std::string* metadata,
+                             std::vector<Demonstration>* demonstrations) {
+  const char* data = contents.data();
+  const std::size_t size = contents.size();
+  if (size < kMagicSize + 4 + kFooterSize ||
+      std::memcmp(data, kHeaderMagic, kMagicSize) != 0 ||
+      std::memcmp(data + size - kMagicSize, kFooterMagic, kMagicSize) != 0) {
+    return false;
+  }
+  const std::size_t metadata_size = ReadLittleEndian(data + kMagicSize, 4);
+  const std::uint64_t index_offset =
+      ReadLittleEndian(data + size - kFooterSize, 8);
+  const std::uint64_t num_records =
+      ReadLittleEndian(data + size - kFooterSize + 8, 8);
+  // Bounded one by one so that corrupt values cannot overflow the sum.
+  if (kMagicSize + 4 + metadata_size > index_offset ||
+      index_offset > size - kFooterSize ||
+      num_records > (size - kFooterSize - index_offset) / 8 ||
+      index_offset + 8 * num_records + kFooterSize != size) {
+    return false;
+  }
+  metadata->assign(data + kMagicSize + 4, metadata_size);
+  demonstrations->resize(num_records);
+  for (std::uint64_t k = 0; k < num_records; ++k) {
+    const std::uint64_t offset = ReadLittleEndian(data + index_offset + 8 * k,
+                                                  8);
+    if (offset >= index_offset ||
+        ParseDemonstration(data + offset, index_offset - offset,
+                           &(*demonstrations)[k]) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DemonstrationWriter::DemonstrationWriter(std::FILE* file,
+                                         const std::string& metadata)
+    : file_(file) {
+  std::string header(kHeaderMagic, kMagicSize);
+  AppendLittleEndian(metadata.size(), 4, &header);
+  header.append(metadata);
+  WriteBytes(header.data(), header.size());
+}
+
+void DemonstrationWriter::Write(const std::string& buffer,
+                                const std::vector<std::size_t>& offsets) {
+  if (offsets.size() < 2) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+    index_.push_back(bytes_ + offsets[i] - offsets[0]);
+  }
+  WriteBytes(buffer.data() + offsets.front(),
+             offsets.back() - offsets.front());
+}
+
+bool DemonstrationWriter::Finish() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string tail;
+  tail.reserve(8 * index_.size() + kFooterSize);
+  for (std::uint64_t offset : index_) {
+    AppendLittleEndian(offset, 8, &tail);
+  }
+  AppendLittleEndian(bytes_, 8, &tail);
+  AppendLittleEndian(index_.size(), 8, &tail);
+  tail.append(kFooterMagic, kMagicSize);
+  WriteBytes(tail.data(), tail.size());
+  ok_ = std::fflush(file_) == 0 && ok_;
+  return ok_;
+}
+
+void DemonstrationWriter::WriteBytes(const char* data, std::size_t size) {
+  ok_ = std::fwrite(data, 1, size, file_) == size && ok_;
+  bytes_ += size;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
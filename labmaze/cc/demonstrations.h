@@ -0,0 +1,132 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compact files of expert demonstrations: shortest paths through generated
+// mazes stored as action codes.
+//
+// A demonstrations file holds, with integers in little-endian:
+//
+//   header: "LMDEMOS1", uint32 size, followed by 'size' bytes of metadata.
+//   records, one per demonstration:
+//     uint64 seed, uint16 start row, start col, goal row, goal col,
+//     uint32 number of actions, uint8 ActionEncoding, uint32 size, followed
+//     by 'size' bytes of encoded actions.
+//   index: uint64 file offset of each record.
+//   footer: uint64 file offset of the index, uint64 number of records,
+//     "LMDEMEND".
+//
+// Records are streamed as they are produced; the index and footer follow the
+// last of them, so a file can be read at random once complete.
+
+#ifndef LABMAZE_CC_DEMONSTRATIONS_H_
+#define LABMAZE_CC_DEMONSTRATIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// A path from 'start' to 'goal' in the maze generated from 'seed', as the
+// Direction of each step.
+struct Demonstration {
+  std::uint64_t seed;
+  Pos start;
+  Pos goal;
+  std::vector<std::uint8_t> actions;
+};
+
+// Size of a record before its encoded actions.
+constexpr std::size_t kDemonstrationHeaderSize = 25;
+
+// How the actions of a record are encoded.
+enum class ActionEncoding : std::uint8_t {
+  // 2 bits per action; action k is in bits 2 * (k % 4) and up of byte k / 4.
+  kPacked = 0,
+  // One byte per run of up to 64 equal actions: the action in bits 0 and 1,
+  // and the run length minus one in bits 2 to 7.
+  kRunLength = 1,
+};
+
+// Returns the actions that follow 'path', whose consecutive cells shall be
+// neighbours.
+std::vector<std::uint8_t> PathActions(const std::vector<Pos>& path);
+
+// Appends the shorter of the packed and the run-length encoding of 'actions'
+// to 'out' and returns which it is.
+ActionEncoding EncodeActions(const std::vector<std::uint8_t>& actions,
+                             std::string* out);
+
+// Decodes 'num_actions' actions from the 'size' bytes at 'data' into
+// 'actions'. Returns false if the data does not hold exactly that many.
+bool DecodeActions(ActionEncoding encoding, const char* data, std::size_t size,
+                   std::size_t num_actions, std::vector<std::uint8_t>* actions);
+
+// Appends the record of 'demonstration' to 'out'.
+void AppendDemonstration(const Demonstration& demonstration, std::string* out);
+
+// Parses the record at the start of the 'size' bytes at 'data' into
+// 'demonstration'. Returns the size of the record, or 0 if it is malformed.
+std::size_t ParseDemonstration(const char* data, std::size_t size,
+                               Demonstration* demonstration);
+
+// Parses the complete demonstrations file 'contents'. Returns false if it is
+// malformed.
+bool ParseDemonstrationsFile(const std::string& contents,
+                             std::string* metadata,
+                             std::vector<Demonstration>* demonstrations);
+
+// Streams records to a demonstrations file and finishes it with the index.
+class DemonstrationWriter {
+ public:
+  // Writes the header with 'metadata' to 'file', which must outlive the
+  // writer and is not closed by it.
+  DemonstrationWriter(std::FILE* file, const std::string& metadata);
+
+  DemonstrationWriter(const DemonstrationWriter&) = delete;
+  DemonstrationWriter& operator=(const DemonstrationWriter&) = delete;
+
+  // Writes the records in 'buffer', whose byte ranges are delimited by
+  // 'offsets'. Thread-safe.
+  void Write(const std::string& buffer,
+             const std::vector<std::size_t>& offsets);
+
+  // Writes the index and footer. No records may be written afterwards.
+  // Returns false if any write failed.
+  bool Finish();
+
+  std::uint64_t written() const { return index_.size(); }
+  std::uint64_t bytes() const { return bytes_; }
+
+ private:
+  void WriteBytes(const char* data, std::size_t size);
+
+  std::FILE* file_;
+  std::mutex mutex_;
+  std::vector<std::uint64_t> index_;
+  std::uint64_t bytes_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_DEMONSTRATIONS_H_
@@ -0,0 +1,162 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/demonstrations.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/direction.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(DemonstrationsTest, PathActions) {
+  EXPECT_THAT(PathActions({{1, 1}, {0, 1}, {0, 2}, {1, 2}, {1, 1}}),
+              ElementsAre(kUp, kRight,
+                          kDown, kLeft));
+  EXPECT_TRUE(PathActions({}).empty());
+  EXPECT_TRUE(PathActions({{3, 4}}).empty());
+}
+
+TEST(DemonstrationsTest, PathActionsFollowShortestPath) {
+  RandomMazeParams params;
+  params.height = 31;
+  params.width = 41;
+  params.simplify = false;
+  const TextMaze maze = RandomMaze(params, 5).Maze();
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+  std::mt19937_64 rng(1);
+  const std::vector<Pos> path = fill.ShortestPathFrom({29, 39}, &rng);
+  ASSERT_FALSE(path.empty());
+  const std::vector<std::uint8_t> actions = PathActions(path);
+  ASSERT_EQ(path.size() - 1, actions.size());
+  Pos pos = path.front();
+  for (std::uint8_t action : actions) {
+    pos = pos + DirectionStep(action);
+  }
+  EXPECT_EQ((Pos{1, 1}), pos);
+}
+
+TEST(DemonstrationsTest, EncodeChoosesShorter) {
+  // Alternating actions pack into 2 bits each.
+  const std::vector<std::uint8_t> zigzag = {0, 3, 0, 3, 0, 3, 0};
+  std::string packed;
+  EXPECT_EQ(ActionEncoding::kPacked, EncodeActions(zigzag, &packed));
+  ASSERT_EQ(2u, packed.size());
+  EXPECT_EQ(static_cast<char>(0 | 3 << 2 | 0 << 4 | 3 << 6), packed[0]);
+  EXPECT_EQ(static_cast<char>(0 | 3 << 2 | 0 << 4), packed[1]);
+
+  // Long corridors take one byte per run of up to 64.
+  std::vector<std::uint8_t> corridors(70, kRight);
+  corridors.resize(75, kDown);
+  std::string runs = "x";
+  EXPECT_EQ(ActionEncoding::kRunLength, EncodeActions(corridors, &runs));
+  EXPECT_EQ(std::string("x") + static_cast<char>(3 | 63 << 2) +
+                static_cast<char>(3 | 5 << 2) + static_cast<char>(1 | 4 << 2),
+            runs);
+}
+
+TEST(DemonstrationsTest, EncodeDecodeRoundTrip) {
+  std::mt19937_64 rng(2);
+  for (int length : {0, 1, 3, 4, 5, 100, 1000}) {
+    for (int max_run : {1, 8, 200}) {
+      std::vector<std::uint8_t> actions;
+      while (static_cast<int>(actions.size()) < length) {
+        const int run = std::uniform_int_distribution<>(1, max_run)(rng);
+        actions.resize(std::min<int>(length, actions.size() + run),
+                       std::uniform_int_distribution<>(0, 3)(rng));
+      }
+      std::string codes;
+      const ActionEncoding encoding = EncodeActions(actions, &codes);
+      std::vector<std::uint8_t> decoded;
+      ASSERT_TRUE(DecodeActions(encoding, codes.data(), codes.size(),
+                                actions.size(), &decoded));
+      EXPECT_EQ(actions, decoded);
+      EXPECT_LE(codes.size(), (actions.size() + 3) / 4);
+      EXPECT_FALSE(DecodeActions(encoding, codes.data(), codes.size(),
+                                 actions.size() + 5, &decoded));
+    }
+  }
+}
+
+TEST(DemonstrationsTest, WriteAndParseFile) {
+  std::vector<Demonstration> demonstrations = {
+      {7, {1, 1}, {1, 4}, {3, 3, 3}},
+      {8, {5, 2}, {5, 2}, {}},
+      {1ull << 40, {300, 2}, {1, 1}, std::vector<std::uint8_t>(299, 0)},
+  };
+  demonstrations[2].actions.push_back(2);
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(nullptr, file);
+  {
+    DemonstrationWriter writer(file, "{\"height\": 11}");
+    // The first two records in one batch, after a byte that is not written.
+    std::string buffer = "x";
+    std::vector<std::size_t> offsets = {1};
+    for (int k : {0, 1}) {
+      AppendDemonstration(demonstrations[k], &buffer);
+      offsets.push_back(buffer.size());
+    }
+    writer.Write(buffer, offsets);
+    buffer.clear();
+    AppendDemonstration(demonstrations[2], &buffer);
+    writer.Write(buffer, {0, buffer.size()});
+    EXPECT_EQ(3u, writer.written());
+    ASSERT_TRUE(writer.Finish());
+  }
+  std::string contents(std::ftell(file), '\0');
+  std::rewind(file);
+  ASSERT_EQ(contents.size(),
+            std::fread(&contents[0], 1, contents.size(), file));
+  std::fclose(file);
+
+  std::string metadata;
+  std::vector<Demonstration> parsed;
+  ASSERT_TRUE(ParseDemonstrationsFile(contents, &metadata, &parsed));
+  EXPECT_EQ("{\"height\": 11}", metadata);
+  ASSERT_EQ(3u, parsed.size());
+  for (std::size_t k = 0; k < parsed.size(); ++k) {
+    EXPECT_EQ(demonstrations[k].seed, parsed[k].seed);
+    EXPECT_EQ(demonstrations[k].start, parsed[k].start);
+    EXPECT_EQ(demonstrations[k].goal, parsed[k].goal);
+    EXPECT_EQ(demonstrations[k].actions, parsed[k].actions);
+  }
+
+  // A truncated file has no footer.
+  EXPECT_FALSE(ParseDemonstrationsFile(contents.substr(0, contents.size() - 1),
+                                       &metadata, &parsed));
+
+  // A record count of 3 + 2^61 would pass a size check that overflows.
+  std::string corrupt = contents;
+  corrupt[corrupt.size() - 24 + 15] |= 0x20;
+  EXPECT_FALSE(ParseDemonstrationsFile(corrupt, &metadata, &parsed));
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,41 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// The directions of steps between neighbouring cells, shared by PolicyField,
+// MazeGraph and demonstration files.
+
+#ifndef LABMAZE_CC_DIRECTION_H_
+#define LABMAZE_CC_DIRECTION_H_
+
+#include <cstdint>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Directions of steps, in the order of Rectangle::VisitNeighbours.
+enum Direction : std::uint8_t { kUp, kDown, kLeft, kRight };
+
+// Returns the step in 'direction'.
+inline Vec DirectionStep(int direction) {
+  static constexpr Vec kSteps[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+  return kSteps[direction];
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_DIRECTION_H_
@@ -0,0 +1,204 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/distance_matrix.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/parallel_for.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+constexpr int kUnreached = std::numeric_limits<int>::max();
+
+}  // namespace
+
+constexpr int DistanceMatrix::kMaxTourPositions;
+
+DistanceMatrix::DistanceMatrix(const TextMaze& maze, TextMaze::Layer layer,
+                               const std::vector<Pos>& positions,
+                               const std::vector<char>& wall_chars,
+                               int num_threads)
+    : positions_(positions), distances_(positions.size() * positions.size()) {
+  const int n = NumPositions();
+  const Rectangle& area = maze.Area();
+  const auto is_wall = internal::MakeCharBoolMap(wall_chars);
+  BorderedGrid<int> walls(area.size, -2, -1);
+  maze.VisitRows(layer, [&walls, &is_wall](int i, int j, const char* cells,
+                                           int count) {
+    for (int k = 0; k < count; ++k) {
+      if (is_wall[static_cast<unsigned char>(cells[k])]) {
+        walls[walls.Index(i, j + k)] = -2;
+      }
+    }
+  });
+
+  // The first position at each open cell stands for all positions there.
+  // Only those are searched from, and each search looks for the ones after
+  // its own.
+  BorderedGrid<int> firsts(area.size, -1, -1);
+  std::vector<int> representatives(n, -1);
+  std::vector<int> sources;
+  for (int k = 0; k < n; ++k) {
+    const Pos& pos = positions_[k];
+    if (!area.InBounds(pos)) {
+      continue;
+    }
+    const int index = walls.Index(pos.row, pos.col);
+    if (walls[index] != -1) {
+      continue;
+    }
+    if (firsts[index] == -1) {
+      firsts[index] = k;
+      sources.push_back(k);
+    }
+    representatives[k] = firsts[index];
+  }
+
+  // found[i * n + j] is the distance between sources i < j.
+  std::vector<int> found(n * n, -1);
+  const int num_sources = sources.size();
+  num_threads = std::max(
+      1, std::min(internal::ResolveNumThreads(num_threads), num_sources - 1));
+  internal::ParallelFor(num_threads, num_threads, [&](int thread) {
+    BorderedGrid<int> cells = walls;
+    std::vector<int> queue;
+    // The last source has nothing after it to look for.
+    for (int s = thread; s < num_sources - 1; s += num_threads) {
+      const int source = sources[s];
+      int remaining = num_sources - 1 - s;
+      const Pos& pos = positions_[source];
+      const int start = cells.Index(pos.row, pos.col);
+      cells[start] = 0;
+      queue.assign(1, start);
+      for (std::size_t head = 0; head < queue.size() && remaining > 0;
+           ++head) {
+        const int index = queue[head];
+        const int distance = cells[index] + 1;
+        for (int neighbour : cells.Neighbours(index)) {
+          if (cells[neighbour] != -1) {
+            continue;
+          }
+          cells[neighbour] = distance;
+          queue.push_back(neighbour);
+          const int target = firsts[neighbour];
+          if (target > source) {
+            found[source * n + target] = distance;
+            --remaining;
+          }
+        }
+      }
+      // Only the cells reached need resetting.
+      for (int index : queue) {
+        cells[index] = -1;
+      }
+    }
+  });
+
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      const int from = representatives[i];
+      const int to = representatives[j];
+      if (from < 0 || to < 0) {
+        distances_[i * n + j] = -1;
+      } else if (from == to) {
+        distances_[i * n + j] = 0;
+      } else {
+        distances_[i * n + j] =
+            found[std::min(from, to) * n + std::max(from, to)];
+      }
+    }
+  }
+}
+
+int DistanceMatrix::ShortestTour(int start, bool return_to_start,
+                                 std::vector<int>* order) const {
+  const int n = NumPositions();
+  CHECK_LE(n, kMaxTourPositions) << "Too many positions for an exact tour.";
+  CHECK(start >= 0 && start < n) << "Start " << start << " out of range.";
+  // Distances are symmetric, so if all positions can be reached from 'start'
+  // they can all be reached from each other.
+  for (int k = 0; k < n; ++k) {
+    if (Distance(start, k) < 0) {
+      return -1;
+    }
+  }
+
+  // costs[mask * n + last] is the length of the shortest walk from 'start'
+  // through the positions in 'mask', ending at 'last', and previous[] is the
+  // position visited before 'last' on that walk, or -1 at 'start'.
+  const int num_masks = 1 << n;
+  std::vector<int> costs(num_masks * n, kUnreached);
+  std::vector<std::int8_t> previous(num_masks * n, -1);
+  costs[(1 << start) * n + start] = 0;
+  for (int mask = 0; mask < num_masks; ++mask) {
+    if (!(mask & (1 << start))) {
+      continue;
+    }
+    for (int last = 0; last < n; ++last) {
+      const int cost = costs[mask * n + last];
+      if (cost == kUnreached) {
+        continue;
+      }
+      for (int next = 0; next < n; ++next) {
+        if (mask & (1 << next)) {
+          continue;
+        }
+        const int state = (mask | (1 << next)) * n + next;
+        const int next_cost = cost + Distance(last, next);
+        if (next_cost < costs[state]) {
+          costs[state] = next_cost;
+          previous[state] = last;
+        }
+      }
+    }
+  }
+
+  const int full = num_masks - 1;
+  int best = kUnreached;
+  int best_last = start;
+  for (int last = 0; last < n; ++last) {
+    if (costs[full * n + last] == kUnreached) {
+      continue;
+    }
+    const int cost = costs[full * n + last] +
+                     (return_to_start ? Distance(last, start) : 0);
+    if (cost < best) {
+      best = cost;
+      best_last = last;
+    }
+  }
+  if (order != nullptr) {
+    order->clear();
+    int mask = full;
+    for (int last = best_last; last != -1;) {
+      order->push_back(last);
+      const int before = previous[mask * n + last];
+      mask ^= 1 << last;
+      last = before;
+    }
+    std::reverse(order->begin(), order->end());
+  }
+  return best;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
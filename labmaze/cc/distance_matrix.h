@@ -0,0 +1,75 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Shortest distances between all pairs of a few cells of a maze.
+
+#ifndef LABMAZE_CC_DISTANCE_MATRIX_H_
+#define LABMAZE_CC_DISTANCE_MATRIX_H_
+
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// The matrix of shortest distances between all pairs of a list of positions,
+// such as the spawns and objects of a maze. The walls are read once and one
+// breadth-first search runs per position, on several threads. Distances are
+// symmetric, so each search only looks for the positions after its own and
+// stops as soon as it has found them.
+class DistanceMatrix {
+ public:
+  // The most positions that ShortestTour accepts.
+  static constexpr int kMaxTourPositions = 16;
+
+  // Computes the distances between 'positions' in the cells of 'layer' of
+  // 'maze' that are not in 'wall_chars', on up to 'num_threads' threads, or
+  // all cores if 'num_threads' is 0.
+  DistanceMatrix(const TextMaze& maze, TextMaze::Layer layer,
+                 const std::vector<Pos>& positions,
+                 const std::vector<char>& wall_chars, int num_threads = 0);
+
+  int NumPositions() const { return static_cast<int>(positions_.size()); }
+  const std::vector<Pos>& Positions() const { return positions_; }
+
+  // Returns the distance between positions 'from' and 'to', or -1 if either
+  // is a wall or out of bounds or they are not connected.
+  int Distance(int from, int to) const {
+    return distances_[from * NumPositions() + to];
+  }
+
+  // All distances, with Distance(i, j) at [i * NumPositions() + j].
+  const std::vector<int>& Distances() const { return distances_; }
+
+  // Finds an order of visiting all positions that starts at position 'start'
+  // and, if 'return_to_start', ends there again, such that the total distance
+  // walked is minimal. This is exact, by dynamic programming over subsets of
+  // positions, so there shall be at most kMaxTourPositions positions. Returns
+  // the total distance and fills 'order', if not null, with the positions in
+  // order of visit, starting with 'start'. Returns -1 if some position cannot
+  // be reached from 'start'.
+  int ShortestTour(int start, bool return_to_start,
+                   std::vector<int>* order) const;
+
+ private:
+  std::vector<Pos> positions_;
+  std::vector<int> distances_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_DISTANCE_MATRIX_H_
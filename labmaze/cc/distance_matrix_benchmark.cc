@@ -0,0 +1,105 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares a DistanceMatrix with one FloodFill per position, and times exact
+// tours.
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/benchmark_util.h"
+#include "labmaze/cc/distance_matrix.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns 'count' random cells of the middle half of 'maze', opening them.
+// Cells that far from the edges percolate into one region.
+std::vector<Pos> MakePositions(int count, TextMaze* maze) {
+  std::mt19937_64 rng(2);
+  const int size = maze->Area().size.height;
+  std::uniform_int_distribution<> coordinate(size / 4, 3 * size / 4);
+  std::vector<Pos> positions(count);
+  for (Pos& pos : positions) {
+    pos = {coordinate(rng), coordinate(rng)};
+    maze->SetCell(TextMaze::kEntityLayer, pos, ' ');
+  }
+  return positions;
+}
+
+// The distances between state.range(1) positions of a maze of
+// state.range(0) cells square, on state.range(2) threads.
+void BM_DistanceMatrix(benchmark::State& state) {
+  TextMaze maze = MakeNoiseMaze(state.range(0));
+  const auto positions = MakePositions(state.range(1), &maze);
+  for (auto _ : state) {
+    const DistanceMatrix matrix(maze, TextMaze::kEntityLayer, positions,
+                                {'*'}, state.range(2));
+    benchmark::DoNotOptimize(matrix.Distances().data());
+  }
+}
+BENCHMARK(BM_DistanceMatrix)
+    ->ArgNames({"size", "positions", "threads"})
+    ->Args({256, 16, 1})
+    ->Args({1024, 16, 1})
+    ->Args({1024, 16, 4})
+    ->Args({1024, 64, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// As BM_DistanceMatrix, with one FloodFill per position.
+void BM_FloodFillPerPosition(benchmark::State& state) {
+  TextMaze maze = MakeNoiseMaze(state.range(0));
+  const auto positions = MakePositions(state.range(1), &maze);
+  std::vector<int> distances(positions.size() * positions.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      const FloodFill fill(maze, TextMaze::kEntityLayer, positions[i], {'*'});
+      for (std::size_t j = 0; j < positions.size(); ++j) {
+        distances[i * positions.size() + j] = fill.DistanceFrom(positions[j]);
+      }
+    }
+    benchmark::DoNotOptimize(distances.data());
+  }
+}
+BENCHMARK(BM_FloodFillPerPosition)
+    ->ArgNames({"size", "positions"})
+    ->Args({256, 16})
+    ->Args({1024, 16})
+    ->Args({1024, 64})
+    ->Unit(benchmark::kMillisecond);
+
+// An exact open tour of state.range(0) positions.
+void BM_ShortestTour(benchmark::State& state) {
+  TextMaze maze = MakeNoiseMaze(256);
+  const auto positions = MakePositions(state.range(0), &maze);
+  const DistanceMatrix matrix(maze, TextMaze::kEntityLayer, positions, {'*'});
+  std::vector<int> order;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix.ShortestTour(0, false, &order));
+  }
+}
+BENCHMARK(BM_ShortestTour)
+    ->Arg(8)
+    ->Arg(12)
+    ->Arg(16)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
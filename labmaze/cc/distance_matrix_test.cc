@@ -0,0 +1,159 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/distance_matrix.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Returns 'count' random open cells of 'maze'.
+std::vector<Pos> RandomOpenCells(const TextMaze& maze, int count,
+                                 std::mt19937_64* rng) {
+  std::vector<Pos> cells;
+  maze.Visit(TextMaze::kEntityLayer, [&cells](int i, int j, char c) {
+    if (c != '*') {
+      cells.push_back({i, j});
+    }
+  });
+  std::shuffle(cells.begin(), cells.end(), *rng);
+  cells.resize(count);
+  return cells;
+}
+
+TEST(DistanceMatrixTest, MatchesFloodFill) {
+  std::mt19937_64 rng(1);
+  RandomMazeParams params;
+  params.height = 41;
+  params.width = 51;
+  params.max_rooms = 5;
+  const TextMaze maze = RandomMaze(params, 3).Maze();
+  std::vector<Pos> positions = RandomOpenCells(maze, 12, &rng);
+  // A duplicate, a wall and a cell out of bounds.
+  positions.push_back(positions[4]);
+  positions.push_back({0, 0});
+  positions.push_back({41, 3});
+  for (int num_threads : {1, 3}) {
+    const DistanceMatrix matrix(maze, TextMaze::kEntityLayer, positions,
+                                {'*'}, num_threads);
+    ASSERT_EQ(15, matrix.NumPositions());
+    ASSERT_EQ(225u, matrix.Distances().size());
+    for (int i = 0; i < matrix.NumPositions(); ++i) {
+      const FloodFill fill(maze, TextMaze::kEntityLayer, positions[i], {'*'});
+      for (int j = 0; j < matrix.NumPositions(); ++j) {
+        const int expected = i < 13 ? fill.DistanceFrom(positions[j]) : -1;
+        EXPECT_EQ(expected, matrix.Distance(i, j)) << i << ", " << j;
+      }
+    }
+  }
+}
+
+TEST(DistanceMatrixTest, ShortestTour) {
+  const TextMaze maze = FromCharGrid(CharGrid("*******\n"
+                                              "*     *\n"
+                                              "* *** *\n"
+                                              "*     *\n"
+                                              "*******\n"));
+  const DistanceMatrix matrix(maze, TextMaze::kEntityLayer,
+                              {{1, 1}, {3, 5}, {1, 5}, {3, 1}}, {'*'});
+  EXPECT_EQ(6, matrix.Distance(0, 1));
+  EXPECT_EQ(4, matrix.Distance(2, 0));
+  std::vector<int> order;
+  EXPECT_EQ(8, matrix.ShortestTour(0, false, &order));
+  EXPECT_THAT(order, ElementsAre(0, 3, 1, 2));
+  // Around the loop.
+  EXPECT_EQ(12, matrix.ShortestTour(1, true, &order));
+  EXPECT_EQ(1, order[0]);
+  EXPECT_EQ(8, matrix.ShortestTour(3, false, nullptr));
+}
+
+TEST(DistanceMatrixTest, ShortestTourMatchesBruteForce) {
+  std::mt19937_64 rng(2);
+  RandomMazeParams params;
+  params.height = 31;
+  params.width = 31;
+  const TextMaze maze = RandomMaze(params, 4).Maze();
+  const DistanceMatrix matrix(maze, TextMaze::kEntityLayer,
+                              RandomOpenCells(maze, 7, &rng), {'*'});
+  const int n = matrix.NumPositions();
+  for (bool return_to_start : {false, true}) {
+    for (int start = 0; start < n; ++start) {
+      // Tries all orders of the other positions.
+      std::vector<int> others;
+      for (int k = 0; k < n; ++k) {
+        if (k != start) {
+          others.push_back(k);
+        }
+      }
+      const auto length = [&](const std::vector<int>& order) {
+        int result = 0;
+        for (std::size_t k = 1; k < order.size(); ++k) {
+          result += matrix.Distance(order[k - 1], order[k]);
+        }
+        return result + (return_to_start
+                             ? matrix.Distance(order.back(), order.front())
+                             : 0);
+      };
+      int best = -1;
+      do {
+        std::vector<int> order = {start};
+        order.insert(order.end(), others.begin(), others.end());
+        const int total = length(order);
+        if (best == -1 || total < best) {
+          best = total;
+        }
+      } while (std::next_permutation(others.begin(), others.end()));
+
+      std::vector<int> order;
+      ASSERT_EQ(best, matrix.ShortestTour(start, return_to_start, &order));
+      ASSERT_EQ(n, static_cast<int>(order.size()));
+      EXPECT_EQ(start, order[0]);
+      EXPECT_EQ(best, length(order));
+      std::vector<int> sorted = order;
+      std::sort(sorted.begin(), sorted.end());
+      std::vector<int> all(n);
+      std::iota(all.begin(), all.end(), 0);
+      EXPECT_EQ(all, sorted);
+    }
+  }
+}
+
+TEST(DistanceMatrixTest, UnreachableTour) {
+  const TextMaze maze = FromCharGrid(CharGrid("  *  \n"));
+  const DistanceMatrix matrix(maze, TextMaze::kEntityLayer,
+                              {{0, 0}, {0, 1}, {0, 4}}, {'*'});
+  EXPECT_EQ(-1, matrix.Distance(0, 2));
+  EXPECT_EQ(1, matrix.Distance(1, 0));
+  EXPECT_EQ(-1, matrix.ShortestTour(0, false, nullptr));
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
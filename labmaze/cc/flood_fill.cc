@@ -20,43 +20,106 @@
 namespace deepmind {
 namespace labmaze {
 namespace internal {
+namespace {
 
-bool FloodFill(const Pos goal, const Rectangle& area,
-               std::vector<int>* distances, std::vector<Pos>* connected) {
-  const int flat_idx = DistanceIndex(area, goal.row, goal.col);
-  if (!area.InBounds(goal) || (*distances)[flat_idx] != -1) {
+template <typename Grid>
+bool FloodFillGrid(const Pos* goals, int num_goals, Grid* distances,
+                   Grid* sources, std::vector<Pos>* connected) {
+  const Rectangle area{{0, 0}, distances->size()};
+  auto& cells = *distances;
+  std::vector<int> current_indices, next_indices;
+  for (int k = 0; k < num_goals; ++k) {
+    const Pos& goal = goals[k];
+    if (!area.InBounds(goal)) {
+      continue;
+    }
+    const int goal_idx = cells.Index(goal.row, goal.col);
+    if (cells[goal_idx] != -1) {
+      continue;
+    }
+    cells[goal_idx] = 0;
+    if (sources != nullptr) {
+      (*sources)[goal_idx] = k;
+    }
+    current_indices.push_back(goal_idx);
+  }
+  if (current_indices.empty()) {
     return false;
   }
 
-  std::vector<Pos> current_points, next_points;
-  current_points.push_back(goal);
   int cost = 0;
-  (*distances)[flat_idx] = cost;
-  while (!current_points.empty()) {
+  while (!current_indices.empty()) {
     ++cost;
-    for (auto pos : current_points) {
-      area.VisitNeighbours(
-          pos, [&area, &next_points, distances, cost](int i, int j) {
-            auto& distance = (*distances)[DistanceIndex(area, i, j)];
-            if (distance == -1) {
-              distance = cost;
-              next_points.push_back({i, j});
-            }
-          });
+    for (int idx : current_indices) {
+      for (int neighbour : cells.Neighbours(idx)) {
+        auto& distance = cells[neighbour];
+        if (distance == -1) {
+          distance = cost;
+          if (sources != nullptr) {
+            (*sources)[neighbour] = (*sources)[idx];
+          }
+          next_indices.push_back(neighbour);
+        }
+      }
+      connected->push_back(cells.ToPos(idx));
     }
-    connected->insert(connected->end(), current_points.begin(),
-                      current_points.end());
-    current_points.clear();
-    std::swap(current_points, next_points);
+    current_indices.clear();
+    std::swap(current_indices, next_indices);
   }
   return true;
 }
 
+}  // namespace
+
+bool FloodFill(const Pos goal, BorderedGrid<int>* distances,
+               std::vector<Pos>* connected) {
+  return FloodFillGrid<BorderedGrid<int>>(&goal, 1, distances, nullptr,
+                                          connected);
+}
+
+bool FloodFill(const Pos goal, TiledGrid<int>* distances,
+               std::vector<Pos>* connected) {
+  return FloodFillGrid<TiledGrid<int>>(&goal, 1, distances, nullptr,
+                                       connected);
+}
+
+bool FloodFill(const std::vector<Pos>& goals, BorderedGrid<int>* distances,
+               BorderedGrid<int>* sources, std::vector<Pos>* connected) {
+  return FloodFillGrid(goals.data(), goals.size(), distances, sources,
+                       connected);
+}
+
+bool FloodFill(const std::vector<Pos>& goals, TiledGrid<int>* distances,
+               TiledGrid<int>* sources, std::vector<Pos>* connected) {
+  return FloodFillGrid(goals.data(), goals.size(), distances, sources,
+                       connected);
+}
+
 }  // namespace internal
 
+namespace {
+
+// Returns the cells of 'layer' of 'maze' whose character is 'token', in
+// row-major order.
+std::vector<Pos> FindCells(const TextMaze& maze, TextMaze::Layer layer,
+                           char token) {
+  std::vector<Pos> result;
+  maze.VisitRows(layer, [&result, token](int i, int j, const char* cells,
+                                         int count) {
+    for (int k = 0; k < count; ++k) {
+      if (cells[k] == token) {
+        result.push_back({i, j + k});
+      }
+    }
+  });
+  return result;
+}
+
+}  // namespace
+
 int FloodFill::DistanceFrom(Pos pos) const {
   if (area_.InBounds(pos)) {
-    int distance = distances_[pos.row * area_.size.width + pos.col];
+    int distance = Distance(pos);
     return distance >= 0 ? distance : -1;
   } else {
     return -1;
@@ -64,18 +127,84 @@ int FloodFill::DistanceFrom(Pos pos) const {
 }
 
 FloodFill::FloodFill(const TextMaze& maze, TextMaze::Layer layer, Pos goal,
-                     const std::vector<char>& wall_chars)
-    : area_(maze.Area()) {
+                     const std::vector<char>& wall_chars, Layout layout)
+    : area_(maze.Area()),
+      layout_(layout),
+      goals_{goal},
+      has_sources_(false) {
+  if (layout == kTiled) {
+    tiled_distances_.emplace(area_.size, -2, -1);
+    Fill<TiledGrid<int>>(maze, layer, wall_chars, &*tiled_distances_,
+                         nullptr);
+  } else {
+    distances_.emplace(area_.size, -2, -1);
+    Fill<BorderedGrid<int>>(maze, layer, wall_chars, &*distances_, nullptr);
+  }
+}
+
+FloodFill::FloodFill(const TextMaze& maze, TextMaze::Layer layer,
+                     const std::vector<Pos>& goals,
+                     const std::vector<char>& wall_chars, Layout layout)
+    : area_(maze.Area()),
+      layout_(layout),
+      goals_(goals),
+      has_sources_(true) {
+  if (layout == kTiled) {
+    tiled_distances_.emplace(area_.size, -2, -1);
+    tiled_sources_.emplace(area_.size, -1, -1);
+    Fill(maze, layer, wall_chars, &*tiled_distances_, &*tiled_sources_);
+  } else {
+    distances_.emplace(area_.size, -2, -1);
+    sources_.emplace(area_.size, -1, -1);
+    Fill(maze, layer, wall_chars, &*distances_, &*sources_);
+  }
+}
+
+FloodFill::FloodFill(const TextMaze& maze, TextMaze::Layer layer,
+                     char goal_token, const std::vector<char>& wall_chars,
+                     Layout layout)
+    : FloodFill(maze, layer, FindCells(maze, layer, goal_token), wall_chars,
+                layout) {}
+
+template <typename Grid>
+void FloodFill::Fill(const TextMaze& maze, TextMaze::Layer layer,
+                     const std::vector<char>& wall_chars, Grid* distances,
+                     Grid* sources) {
   auto is_wall = internal::MakeCharBoolMap(wall_chars);
-  distances_.reserve(maze.Area().Area());
-  maze.Visit(layer, [this, &is_wall](int i, int j, int c) {
-    distances_.push_back(is_wall[c] ? -2 : -1);
+  maze.VisitRows(layer, [distances, &is_wall](int i, int j, const char* cells,
+                                              int count) {
+    for (int k = 0; k < count; ++k) {
+      (*distances)[distances->Index(i, j + k)] =
+          is_wall[static_cast<unsigned char>(cells[k])] ? -2 : -1;
+    }
   });
-  internal::FloodFill(goal, area_, &distances_, &connected_);
+  if (sources == nullptr) {
+    internal::FloodFill(goals_.front(), distances, &connected_);
+  } else {
+    internal::FloodFill(goals_, distances, sources, &connected_);
+  }
+}
+
+int FloodFill::NearestGoalFrom(Pos pos) const {
+  if (DistanceFrom(pos) == -1) {
+    return -1;
+  }
+  return has_sources_ ? Source(pos) : 0;
 }
 
 std::vector<Pos> FloodFill::ShortestPathFrom(Pos pos,
                                              std::mt19937_64* rng) const {
+  return layout_ == kTiled
+             ? ShortestPath(*tiled_distances_,
+                            has_sources_ ? &*tiled_sources_ : nullptr, pos, rng)
+             : ShortestPath(*distances_, has_sources_ ? &*sources_ : nullptr,
+                            pos, rng);
+}
+
+template <typename Grid>
+std::vector<Pos> FloodFill::ShortestPath(const Grid& distances,
+                                         const Grid* sources, Pos pos,
+                                         std::mt19937_64* rng) const {
   std::vector<Pos> result;
 
   int distance = DistanceFrom(pos);
@@ -84,20 +213,25 @@ std::vector<Pos> FloodFill::ShortestPathFrom(Pos pos,
   }
   result.reserve(distance + 1);
   result.push_back(pos);
+  int idx = distances.Index(pos.row, pos.col);
+  // Every cell was reached from a neighbour with the same nearest goal, so
+  // the route can stay with that goal all the way.
+  const int source = has_sources_ ? (*sources)[idx] : 0;
   while (distance--) {
-    const auto& next_pos = result.back();
-    result.emplace_back();
+    int next_idx = idx;
     int choice = 0;
-    area_.VisitNeighbours(
-        next_pos, [&result, rng, &choice, distance, this](int i, int j) {
-          if (distances_[internal::DistanceIndex(area_, i, j)] == distance) {
-            ++choice;
-            if (choice == 1 ||
-                std::uniform_int_distribution<>(1, choice)(*rng) == 1) {
-              result.back() = {i, j};
-            }
-          }
-        });
+    for (int neighbour : distances.Neighbours(idx)) {
+      if (distances[neighbour] == distance &&
+          (!has_sources_ || (*sources)[neighbour] == source)) {
+        ++choice;
+        if (choice == 1 ||
+            std::uniform_int_distribution<>(1, choice)(*rng) == 1) {
+          next_idx = neighbour;
+        }
+      }
+    }
+    idx = next_idx;
+    result.push_back(distances.ToPos(idx));
   }
   return result;
 }
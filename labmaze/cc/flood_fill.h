@@ -18,6 +18,7 @@
 
 #include <bitset>
 #include <limits>
+#include <optional>
 #include <random>
 #include <vector>
 
@@ -42,53 +43,128 @@ CharBoolMap MakeCharBoolMap(const C& chars) {
   return result;
 }
 
-// Converts row and col into a flat index for use with distance.
-inline int DistanceIndex(const Rectangle& area, int row, int col) {
-  return row * area.size.width + col;
-}
-
 // Flood fills from 'goal' in 'distances' where distance has the value -1.
 // '*distances' is updated with the distance to the goal.
 // '*connected' is appended with cells connected to goal in ascending distance
 // order.
-// 'distances->size()' must be equal to 'area.Area()'.
-bool FloodFill(Pos goal, const Rectangle& area,
-               std::vector<int>* distances,
+// The border of 'distances' must not be -1; it is never written.
+bool FloodFill(Pos goal, BorderedGrid<int>* distances,
+               std::vector<Pos>* connected);
+bool FloodFill(Pos goal, TiledGrid<int>* distances,
                std::vector<Pos>* connected);
 
+// Like FloodFill, but from all of 'goals' at once, so that '*distances' is
+// updated with the distance to the nearest goal. Goals that are out of bounds
+// or not -1 are skipped. If 'sources' is not null, it is updated with the
+// index in 'goals' of the nearest goal of each cell reached; it shall have
+// the layout of 'distances'. Returns whether any goal was filled from.
+bool FloodFill(const std::vector<Pos>& goals, BorderedGrid<int>* distances,
+               BorderedGrid<int>* sources, std::vector<Pos>* connected);
+bool FloodFill(const std::vector<Pos>& goals, TiledGrid<int>* distances,
+               TiledGrid<int>* sources, std::vector<Pos>* connected);
+
 }  // namespace internal
 
 // Structure for calculating distance to goal object from any point in a maze.
 class FloodFill {
  public:
+  // Memory layout of the distance field. Results do not depend on it.
+  enum Layout {
+    // Row-major; best for mazes that fit in the cache.
+    kRowMajor,
+    // 8x8 tiles (see TiledGrid); fewer cache misses on mazes with millions of
+    // cells.
+    kTiled,
+  };
+
   // Finds all points attached to goal.
   // 'goal' - Flood fill starts from goal.
   // 'wall_chars' are characters for the flood fill to avoid.
   FloodFill(const TextMaze& maze, TextMaze::Layer layer, Pos goal,
-            const std::vector<char>& wall_chars);
+            const std::vector<char>& wall_chars, Layout layout = kRowMajor);
+
+  // Finds all points attached to any of 'goals' in a single pass, and records
+  // for each which goal is nearest. Distances and paths are to the nearest
+  // goal. Goals that are out of bounds or walls are skipped.
+  FloodFill(const TextMaze& maze, TextMaze::Layer layer,
+            const std::vector<Pos>& goals, const std::vector<char>& wall_chars,
+            Layout layout = kRowMajor);
+
+  // As above, with a goal at each cell of 'layer' whose character is
+  // 'goal_token', in row-major order.
+  FloodFill(const TextMaze& maze, TextMaze::Layer layer, char goal_token,
+            const std::vector<char>& wall_chars, Layout layout = kRowMajor);
 
   // If goal is reachable from start, returns the minimum distance between start
   // and goal. Otherwise returns -1.
   int DistanceFrom(Pos start) const;
 
+  // If a goal is reachable from 'start', returns the index in Goals() of the
+  // goal nearest to it. Of goals at equal distance, one is chosen arbitrarily
+  // but consistently with ShortestPathFrom. Otherwise returns -1.
+  int NearestGoalFrom(Pos start) const;
+
+  // The goals filled from.
+  const std::vector<Pos>& Goals() const { return goals_; }
+
+  // The extents of the maze filled.
+  const Rectangle& Area() const { return area_; }
+
   // If 'goal' is reachable from 'start', returns a shortest route from 'start'
   // to 'goal' including both end points. Otherwise returns an empty vector.
   // If the route from has multiple possible branches each branch has an equal
-  // chance of being chosen according to the rng.
+  // chance of being chosen according to the rng. With several goals, the route
+  // leads to Goals()[NearestGoalFrom(start)].
   std::vector<Pos> ShortestPathFrom(Pos start, std::mt19937_64* rng) const;
 
   // Calls f(i, j, distance) for all points connected to start.
   template <typename F>
-  void Visit(F&& f) {
+  void Visit(F&& f) const {
     for (const auto& p : connected_) {
-      f(p.row, p.col, distances_[internal::DistanceIndex(area_, p.row, p.col)]);
+      f(p.row, p.col, Distance(p));
     }
   }
 
  private:
-  std::vector<int> distances_;
-  std::vector<Pos> connected_;
+  // Returns the stored distance of the in-bounds cell 'pos'.
+  int Distance(Pos pos) const {
+    return layout_ == kTiled
+               ? (*tiled_distances_)[tiled_distances_->Index(pos.row, pos.col)]
+               : (*distances_)[distances_->Index(pos.row, pos.col)];
+  }
+
+  // Returns the stored nearest goal of the in-bounds cell 'pos', which shall
+  // have been reached, when there are several goals.
+  int Source(Pos pos) const {
+    return layout_ == kTiled
+               ? (*tiled_sources_)[tiled_sources_->Index(pos.row, pos.col)]
+               : (*sources_)[sources_->Index(pos.row, pos.col)];
+  }
+
+  // Reads the walls of 'maze' into 'distances' and fills from goals_,
+  // recording nearest goals in 'sources' if not null.
+  template <typename Grid>
+  void Fill(const TextMaze& maze, TextMaze::Layer layer,
+            const std::vector<char>& wall_chars, Grid* distances,
+            Grid* sources);
+
+  template <typename Grid>
+  std::vector<Pos> ShortestPath(const Grid& distances, const Grid* sources,
+                                Pos start, std::mt19937_64* rng) const;
+
   Rectangle area_;
+  Layout layout_;
+  std::vector<Pos> goals_;
+  // Whether the nearest goal of each cell is recorded, which is only needed
+  // for several goals.
+  bool has_sources_;
+  // Only the grids of 'layout_' are allocated, and the nearest goals only if
+  // has_sources_. Held by value, so that FloodFill stays copyable.
+  std::optional<BorderedGrid<int>> distances_;
+  std::optional<TiledGrid<int>> tiled_distances_;
+  std::optional<BorderedGrid<int>> sources_;
+  std::optional<TiledGrid<int>> tiled_sources_;
+  std::vector<Pos> connected_;
 };
 
 }  // namespace labmaze
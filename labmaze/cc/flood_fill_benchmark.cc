@@ -0,0 +1,210 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares the FloodFill distance field layouts on mazes with millions of
+// cells. Where the kernel allows perf events, the cache misses of each layout
+// are reported next to the time. Also compares a single fill from many goals
+// with one fill per goal.
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/benchmark_util.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Counts a hardware event of the calling thread while enabled. Does nothing if
+// perf events are unavailable, as they are in many containers.
+class PerfEventCounter {
+ public:
+  PerfEventCounter(std::uint32_t type, std::uint64_t config) {
+#if defined(__linux__)
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~PerfEventCounter() {
+#if defined(__linux__)
+    if (fd_ >= 0) close(fd_);
+#endif
+  }
+
+  PerfEventCounter(const PerfEventCounter&) = delete;
+  PerfEventCounter& operator=(const PerfEventCounter&) = delete;
+
+  bool available() const { return fd_ >= 0; }
+
+  void Enable() {
+#if defined(__linux__)
+    if (fd_ >= 0) ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  void Disable() {
+#if defined(__linux__)
+    if (fd_ >= 0) ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+  }
+
+  // Returns the count so far.
+  std::uint64_t Read() const {
+    std::uint64_t count = 0;
+#if defined(__linux__)
+    if (fd_ >= 0 && read(fd_, &count, sizeof(count)) != sizeof(count)) {
+      count = 0;
+    }
+#endif
+    return count;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+// Returns a noise maze of size 'size' x 'size' whose centre is open, so that
+// most open cells are connected to it.
+TextMaze MakeLargeMaze(int size) {
+  TextMaze maze = MakeNoiseMaze(size);
+  maze.SetCell(TextMaze::kEntityLayer, {size / 2, size / 2}, ' ');
+  return maze;
+}
+
+template <FloodFill::Layout layout>
+void BM_FloodFillLarge(benchmark::State& state) {
+  const int size = state.range(0);
+  const TextMaze maze = MakeLargeMaze(size);
+#if defined(__linux__)
+  PerfEventCounter cache_misses(PERF_TYPE_HARDWARE,
+                                PERF_COUNT_HW_CACHE_MISSES);
+  PerfEventCounter l1d_misses(
+      PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+  PerfEventCounter cache_misses(0, 0);
+  PerfEventCounter l1d_misses(0, 0);
+#endif
+  for (auto _ : state) {
+    cache_misses.Enable();
+    l1d_misses.Enable();
+    FloodFill fill(maze, TextMaze::kEntityLayer, {size / 2, size / 2}, {'*'},
+                   layout);
+    cache_misses.Disable();
+    l1d_misses.Disable();
+    benchmark::DoNotOptimize(fill);
+  }
+  const double cells = static_cast<double>(size) * size;
+  if (cache_misses.available()) {
+    state.counters["cache_misses_per_cell"] =
+        cache_misses.Read() / (cells * state.iterations());
+  }
+  if (l1d_misses.available()) {
+    state.counters["l1d_misses_per_cell"] =
+        l1d_misses.Read() / (cells * state.iterations());
+  }
+  state.counters["cells_per_second"] = benchmark::Counter(
+      cells * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_FloodFillLarge, FloodFill::kRowMajor)
+    ->Arg(2048)
+    ->Arg(4096)
+    ->Arg(8192)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FloodFillLarge, FloodFill::kTiled)
+    ->Arg(2048)
+    ->Arg(4096)
+    ->Arg(8192)
+    ->Unit(benchmark::kMillisecond);
+
+// Returns 'count' random open cells of 'maze'.
+std::vector<Pos> RandomGoals(const TextMaze& maze, int count) {
+  std::mt19937_64 rng(2);
+  const Size& size = maze.Area().size;
+  std::uniform_int_distribution<> row(0, size.height - 1);
+  std::uniform_int_distribution<> col(0, size.width - 1);
+  std::vector<Pos> goals;
+  while (static_cast<int>(goals.size()) < count) {
+    const Pos goal = {row(rng), col(rng)};
+    if (maze.GetCell(TextMaze::kEntityLayer, goal) != '*') {
+      goals.push_back(goal);
+    }
+  }
+  return goals;
+}
+
+// The distance to the nearest of state.range(1) goals from every cell of a
+// maze of state.range(0) cells square, in a single fill.
+void BM_NearestGoal(benchmark::State& state) {
+  const TextMaze maze = MakeLargeMaze(state.range(0));
+  const auto goals = RandomGoals(maze, state.range(1));
+  for (auto _ : state) {
+    FloodFill fill(maze, TextMaze::kEntityLayer, goals, {'*'});
+    benchmark::DoNotOptimize(fill);
+  }
+}
+BENCHMARK(BM_NearestGoal)
+    ->ArgNames({"size", "goals"})
+    ->Args({512, 4})
+    ->Args({512, 32})
+    ->Args({2048, 32})
+    ->Unit(benchmark::kMillisecond);
+
+// As BM_NearestGoal, with one fill per goal and a minimum over the fills.
+void BM_NearestGoalPerGoal(benchmark::State& state) {
+  const TextMaze maze = MakeLargeMaze(state.range(0));
+  const auto goals = RandomGoals(maze, state.range(1));
+  BorderedGrid<int> nearest(maze.Area().size, -1, -1);
+  for (auto _ : state) {
+    for (Pos goal : goals) {
+      const FloodFill fill(maze, TextMaze::kEntityLayer, goal, {'*'});
+      fill.Visit([&nearest](int i, int j, int distance) {
+        int& best = nearest[nearest.Index(i, j)];
+        best = best < 0 ? distance : std::min(best, distance);
+      });
+    }
+    benchmark::DoNotOptimize(nearest);
+  }
+}
+BENCHMARK(BM_NearestGoalPerGoal)
+    ->ArgNames({"size", "goals"})
+    ->Args({512, 4})
+    ->Args({512, 32})
+    ->Args({2048, 32})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -15,10 +15,13 @@
 
 #include "labmaze/cc/flood_fill.h"
 
+#include <random>
 #include <tuple>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
 #include "labmaze/cc/text_maze.h"
 
 namespace deepmind {
@@ -156,6 +159,138 @@ TEST(FloodFillTest, ShortestPathFromRandom) {
   }
 }
 
+TEST(FloodFillTest, TiledLayoutMatchesRowMajor) {
+  std::mt19937_64 maze_rng(4);
+  std::bernoulli_distribution is_wall(0.3);
+  // Extents that do and do not end on a tile boundary.
+  for (Size size : {Size{6, 6}, Size{17, 30}, Size{40, 9}}) {
+    TextMaze maze(size);
+    maze.VisitMutable(TextMaze::kEntityLayer, [&](int, int, char* c) {
+      *c = is_wall(maze_rng) ? '*' : ' ';
+    });
+    const Pos goal{size.height / 2, size.width / 2};
+    maze.SetCell(TextMaze::kEntityLayer, goal, ' ');
+    const FloodFill row_major(maze, TextMaze::kEntityLayer, goal, {'*'});
+    const FloodFill tiled(maze, TextMaze::kEntityLayer, goal, {'*'},
+                          FloodFill::kTiled);
+    std::vector<std::tuple<int, int, int>> row_major_cells, tiled_cells;
+    row_major.Visit([&row_major_cells](int i, int j, int distance) {
+      row_major_cells.emplace_back(i, j, distance);
+    });
+    tiled.Visit([&tiled_cells](int i, int j, int distance) {
+      tiled_cells.emplace_back(i, j, distance);
+    });
+    EXPECT_EQ(row_major_cells, tiled_cells);
+
+    maze.Area().Visit([&](int i, int j) {
+      ASSERT_EQ(row_major.DistanceFrom({i, j}), tiled.DistanceFrom({i, j}));
+      std::mt19937_64 row_major_rng(i * size.width + j);
+      std::mt19937_64 tiled_rng(i * size.width + j);
+      const auto expected = row_major.ShortestPathFrom({i, j}, &row_major_rng);
+      const auto path = tiled.ShortestPathFrom({i, j}, &tiled_rng);
+      ASSERT_EQ(expected.size(), path.size());
+      for (std::size_t k = 0; k < path.size(); ++k) {
+        EXPECT_EQ(expected[k], path[k]);
+      }
+    });
+  }
+}
+
+TEST(FloodFillTest, MultipleGoalsMatchNearestSingleGoal) {
+  std::mt19937_64 maze_rng(5);
+  std::bernoulli_distribution is_wall(0.3);
+  TextMaze maze({23, 31});
+  maze.VisitMutable(TextMaze::kEntityLayer, [&](int, int, char* c) {
+    *c = is_wall(maze_rng) ? '*' : ' ';
+  });
+  maze.SetCell(TextMaze::kEntityLayer, {0, 0}, '*');
+  // Walls, duplicates and cells out of bounds are skipped.
+  const std::vector<Pos> goals = {{3, 4}, {0, 0}, {20, 25}, {3, 4},
+                                  {-1, 2}, {11, 15}, {22, 0}};
+  for (Pos goal : goals) {
+    if (maze.Area().InBounds(goal) && !(goal == Pos{0, 0})) {
+      maze.SetCell(TextMaze::kEntityLayer, goal, ' ');
+    }
+  }
+  std::vector<FloodFill> singles;
+  for (Pos goal : goals) {
+    singles.emplace_back(maze, TextMaze::kEntityLayer, goal,
+                         std::vector<char>{'*'});
+  }
+  for (FloodFill::Layout layout : {FloodFill::kRowMajor, FloodFill::kTiled}) {
+    const FloodFill fill(maze, TextMaze::kEntityLayer, goals, {'*'}, layout);
+    EXPECT_EQ(goals, fill.Goals());
+    int previous_distance = 0;
+    fill.Visit([&](int i, int j, int distance) {
+      EXPECT_EQ(fill.DistanceFrom({i, j}), distance);
+      EXPECT_LE(previous_distance, distance);
+      previous_distance = distance;
+    });
+    maze.Area().Visit([&](int i, int j) {
+      int nearest = -1;
+      for (const FloodFill& single : singles) {
+        const int distance = single.DistanceFrom({i, j});
+        if (distance >= 0 && (nearest == -1 || distance < nearest)) {
+          nearest = distance;
+        }
+      }
+      ASSERT_EQ(nearest, fill.DistanceFrom({i, j}));
+      const int goal = fill.NearestGoalFrom({i, j});
+      std::mt19937_64 rng(i * 31 + j);
+      const auto path = fill.ShortestPathFrom({i, j}, &rng);
+      if (nearest == -1) {
+        EXPECT_EQ(-1, goal);
+        EXPECT_TRUE(path.empty());
+        return;
+      }
+      ASSERT_GE(goal, 0);
+      EXPECT_NE(1, goal);
+      EXPECT_NE(4, goal);
+      EXPECT_EQ(nearest, singles[goal].DistanceFrom({i, j}));
+      ASSERT_EQ(nearest + 1, static_cast<int>(path.size()));
+      EXPECT_EQ((Pos{i, j}), path.front());
+      EXPECT_EQ(goals[goal], path.back());
+    });
+  }
+}
+
+TEST(FloodFillTest, GoalToken) {
+  const TextMaze maze = FromCharGrid(CharGrid("G  *  \n"
+                                              "** * G\n"
+                                              "  G*  \n"
+                                              "***** \n"
+                                              "  *  G\n"));
+  const FloodFill fill(maze, TextMaze::kEntityLayer, 'G', {'*'});
+  EXPECT_EQ((std::vector<Pos>{{0, 0}, {1, 5}, {2, 2}, {4, 5}}), fill.Goals());
+  EXPECT_EQ(1, fill.DistanceFrom({0, 1}));
+  EXPECT_EQ(0, fill.NearestGoalFrom({0, 1}));
+  EXPECT_EQ(1, fill.DistanceFrom({1, 2}));
+  EXPECT_EQ(2, fill.NearestGoalFrom({1, 2}));
+  EXPECT_EQ(1, fill.NearestGoalFrom({0, 4}));
+  EXPECT_EQ(3, fill.NearestGoalFrom({4, 3}));
+  EXPECT_EQ(-1, fill.DistanceFrom({4, 0}));
+  EXPECT_EQ(-1, fill.NearestGoalFrom({4, 0}));
+}
+
+TEST(FloodFillTest, Copy) {
+  const TextMaze maze = FromCharGrid(CharGrid("G  *  \n"
+                                              "** * G\n"
+                                              "  G*  \n"));
+  for (auto layout : {FloodFill::kRowMajor, FloodFill::kTiled}) {
+    const FloodFill fill(maze, TextMaze::kEntityLayer, 'G', {'*'}, layout);
+    FloodFill copy = fill;
+    EXPECT_EQ(fill.Goals(), copy.Goals());
+    maze.Area().Visit([&fill, &copy](int i, int j) {
+      EXPECT_EQ(fill.DistanceFrom({i, j}), copy.DistanceFrom({i, j}));
+      EXPECT_EQ(fill.NearestGoalFrom({i, j}), copy.NearestGoalFrom({i, j}));
+    });
+    copy = FloodFill(maze, TextMaze::kEntityLayer, Pos{0, 0}, {'*'}, layout);
+    EXPECT_EQ(2, copy.DistanceFrom({0, 2}));
+    std::mt19937_64 rng(1);
+    EXPECT_EQ(3u, copy.ShortestPathFrom({0, 2}, &rng).size());
+  }
+}
+
 }  // namespace
 }  // namespace labmaze
 }  // namespace deepmind
@@ -0,0 +1,252 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Generates the first maze of RandomMaze(params, seed) for every seed in
+// [seed_begin, seed_end) on all cores, and writes a shortest path from every
+// spawn point to every object of each maze to a demonstrations file:
+//
+//   generate_demonstrations --height=21 --width=21 --seed_end=1000000
+//       --output=/tmp/demonstrations.bin
+//
+// Records are written in completion order, not in seed order; every record
+// carries its seed. Ties between shortest paths are broken at random with the
+// seed. The metadata of the file is a JSON object of the maze parameters,
+// named as the arguments of the Python `labmaze.RandomMaze`, from which the
+// maze of each record can be generated again. See demonstrations.h for the
+// file format and labmaze/demonstrations.py for a reader.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "labmaze/cc/defaults.h"
+#include "labmaze/cc/demonstrations.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/parallel_for.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/seed_chunks.h"
+#include "labmaze/cc/text_maze.h"
+
+ABSL_FLAG(int, height, 11, "Maze height. Shall be odd.");
+ABSL_FLAG(int, width, 11, "Maze width. Shall be odd.");
+ABSL_FLAG(int, max_rooms, deepmind::labmaze::defaults::kMaxRooms,
+          "Maximum number of rooms.");
+ABSL_FLAG(int, room_min_size, deepmind::labmaze::defaults::kRoomMinSize,
+          "Minimum room size.");
+ABSL_FLAG(int, room_max_size, deepmind::labmaze::defaults::kRoomMaxSize,
+          "Maximum room size.");
+ABSL_FLAG(int, retry_count, deepmind::labmaze::defaults::kRetryCount,
+          "Number of attempts at placing rooms.");
+ABSL_FLAG(double, extra_connection_probability,
+          deepmind::labmaze::defaults::kExtraConnectionProbability,
+          "Probability of adding extra connections between regions.");
+ABSL_FLAG(int, max_variations, deepmind::labmaze::defaults::kMaxVariations,
+          "Maximum number of room variations.");
+ABSL_FLAG(bool, has_doors, deepmind::labmaze::defaults::kHasDoors,
+          "Whether connections between regions are doors.");
+ABSL_FLAG(bool, simplify, deepmind::labmaze::defaults::kSimplify,
+          "Whether to remove dead ends and horseshoe bends.");
+ABSL_FLAG(int, spawns_per_room, 1,
+          "Number of spawn points per room, from which paths start.");
+ABSL_FLAG(std::string, spawn_token, deepmind::labmaze::defaults::kSpawnToken,
+          "Character marking spawn points.");
+ABSL_FLAG(int, objects_per_room, 1,
+          "Number of objects per room, at which paths end.");
+ABSL_FLAG(std::string, object_token, deepmind::labmaze::defaults::kObjectToken,
+          "Character marking objects.");
+
+ABSL_FLAG(std::uint64_t, seed_begin, 0, "First seed to generate.");
+ABSL_FLAG(std::uint64_t, seed_end, 1000, "One past the last seed to generate.");
+ABSL_FLAG(int, threads, 0, "Number of worker threads; 0 uses all cores.");
+ABSL_FLAG(std::string, output, "-", "Output file, or '-' for stdout.");
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Number of seeds a worker claims at a time.
+constexpr std::uint64_t kChunkSize = 64;
+
+// Returns a JSON string holding the single character 'token'.
+std::string JsonToken(const std::string& token) {
+  CHECK(token != "\"" && token != "\\") << "Unsupported token: " << token;
+  return "\"" + token + "\"";
+}
+
+// Returns the parameters as a JSON object with the argument names of the
+// Python labmaze.RandomMaze.
+std::string Metadata(const RandomMazeParams& params) {
+  std::ostringstream out;
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << "{\"height\": " << params.height << ", \"width\": " << params.width
+      << ", \"max_rooms\": " << params.max_rooms
+      << ", \"room_min_size\": " << params.room_min_size
+      << ", \"room_max_size\": " << params.room_max_size
+      << ", \"retry_count\": " << params.retry_count
+      << ", \"extra_connection_probability\": "
+      << params.extra_connection_probability
+      << ", \"max_variations\": " << params.max_variations
+      << ", \"has_doors\": " << (params.has_doors ? "true" : "false")
+      << ", \"simplify\": " << (params.simplify ? "true" : "false")
+      << ", \"spawns_per_room\": " << params.spawns_per_room
+      << ", \"spawn_token\": " << JsonToken(params.spawn_token)
+      << ", \"objects_per_room\": " << params.objects_per_room
+      << ", \"object_token\": " << JsonToken(params.object_token) << "}";
+  return out.str();
+}
+
+int Main() {
+  RandomMazeParams params;
+  params.height = absl::GetFlag(FLAGS_height);
+  params.width = absl::GetFlag(FLAGS_width);
+  params.max_rooms = absl::GetFlag(FLAGS_max_rooms);
+  params.room_min_size = absl::GetFlag(FLAGS_room_min_size);
+  params.room_max_size = absl::GetFlag(FLAGS_room_max_size);
+  params.retry_count = absl::GetFlag(FLAGS_retry_count);
+  params.extra_connection_probability =
+      absl::GetFlag(FLAGS_extra_connection_probability);
+  params.max_variations = absl::GetFlag(FLAGS_max_variations);
+  params.has_doors = absl::GetFlag(FLAGS_has_doors);
+  params.simplify = absl::GetFlag(FLAGS_simplify);
+  params.spawns_per_room = absl::GetFlag(FLAGS_spawns_per_room);
+  params.spawn_token = absl::GetFlag(FLAGS_spawn_token);
+  params.objects_per_room = absl::GetFlag(FLAGS_objects_per_room);
+  params.object_token = absl::GetFlag(FLAGS_object_token);
+  CHECK(params.height > 0 && params.height % 2 == 1)
+      << "--height shall be a positive odd integer.";
+  CHECK(params.width > 0 && params.width % 2 == 1)
+      << "--width shall be a positive odd integer.";
+  CHECK(params.height <= 0xFFFF && params.width <= 0xFFFF)
+      << "Records hold cells in 16 bits.";
+  CHECK_EQ(params.spawn_token.size(), std::size_t{1})
+      << "--spawn_token shall be one char.";
+  CHECK_EQ(params.object_token.size(), std::size_t{1})
+      << "--object_token shall be one char.";
+
+  const std::uint64_t seed_begin = absl::GetFlag(FLAGS_seed_begin);
+  const std::uint64_t seed_end = absl::GetFlag(FLAGS_seed_end);
+  const int num_threads =
+      internal::ResolveNumThreads(absl::GetFlag(FLAGS_threads));
+
+  const std::string output = absl::GetFlag(FLAGS_output);
+  std::FILE* file = output == "-" ? stdout : std::fopen(output.c_str(), "wb");
+  CHECK(file != nullptr) << "Unable to open " << output;
+
+  DemonstrationWriter writer(file, Metadata(params));
+  internal::SeedChunks chunks(seed_begin, seed_end, kChunkSize);
+  std::atomic<std::uint64_t> steps{0};
+  std::atomic<std::uint64_t> action_bytes{0};
+  std::atomic<std::uint64_t> unreachable{0};
+
+  auto worker = [&]() {
+    std::string buffer;
+    std::vector<std::size_t> offsets;
+    std::vector<Pos> spawns;
+    std::vector<Pos> goals;
+    Demonstration demonstration;
+    std::uint64_t worker_steps = 0;
+    std::uint64_t worker_action_bytes = 0;
+    std::uint64_t worker_unreachable = 0;
+    std::uint64_t begin, end;
+    while (chunks.Next(&begin, &end)) {
+      buffer.clear();
+      offsets.assign(1, 0);
+      for (std::uint64_t seed = begin; seed < end; ++seed) {
+        RandomMaze random_maze(params, seed);
+        const TextMaze& maze = random_maze.Maze();
+        spawns.clear();
+        goals.clear();
+        maze.Visit(TextMaze::kEntityLayer, [&](int i, int j, char c) {
+          if (c == params.spawn_token[0]) {
+            spawns.push_back({i, j});
+          } else if (c == params.object_token[0]) {
+            goals.push_back({i, j});
+          }
+        });
+        std::mt19937_64 rng(seed);
+        demonstration.seed = seed;
+        for (const Pos& goal : goals) {
+          const FloodFill fill(maze, TextMaze::kEntityLayer, goal, {'*'});
+          demonstration.goal = goal;
+          for (const Pos& spawn : spawns) {
+            const std::vector<Pos> path = fill.ShortestPathFrom(spawn, &rng);
+            if (path.empty()) {
+              ++worker_unreachable;
+              continue;
+            }
+            demonstration.start = spawn;
+            demonstration.actions = PathActions(path);
+            worker_steps += demonstration.actions.size();
+            AppendDemonstration(demonstration, &buffer);
+            worker_action_bytes +=
+                buffer.size() - offsets.back() - kDemonstrationHeaderSize;
+            offsets.push_back(buffer.size());
+          }
+        }
+      }
+      writer.Write(buffer, offsets);
+    }
+    steps += worker_steps;
+    action_bytes += worker_action_bytes;
+    unreachable += worker_unreachable;
+  };
+
+  const auto start_time = std::chrono::steady_clock::now();
+  internal::ParallelFor(num_threads, num_threads,
+                        [&worker](int) { worker(); });
+  CHECK(writer.Finish()) << "Unable to write " << output;
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_time;
+
+  if (file != stdout) {
+    CHECK_EQ(std::fclose(file), 0) << "Unable to write " << output;
+  }
+
+  const std::uint64_t generated = seed_end > seed_begin ? seed_end - seed_begin
+                                                        : 0;
+  std::fprintf(stderr,
+               "generated %llu mazes, written %llu demonstrations of %llu "
+               "steps in %llu bytes (actions %.2f bits/step), unreachable "
+               "%llu in %.3fs using %d threads (%.0f demonstrations/s)\n",
+               static_cast<unsigned long long>(generated),
+               static_cast<unsigned long long>(writer.written()),
+               static_cast<unsigned long long>(steps.load()),
+               static_cast<unsigned long long>(writer.bytes()),
+               steps.load() > 0 ? 8.0 * action_bytes.load() / steps.load()
+                                : 0.0,
+               static_cast<unsigned long long>(unreachable.load()),
+               elapsed.count(), num_threads,
+               elapsed.count() > 0 ? writer.written() / elapsed.count() : 0.0);
+  return 0;
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  return deepmind::labmaze::Main();
+}
@@ -0,0 +1,316 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Generates the first maze of RandomMaze(params, seed) for every seed in
+// [seed_begin, seed_end) on all cores and streams them to a file:
+//
+//   generate_mazes --height=21 --width=21 --seed_end=10000000
+//       --format=binary --output=/tmp/mazes.bin
+//
+// Records are written in completion order, not in seed order; every record
+// carries its seed.
+//
+// --format=text writes for each maze:
+//   seed <seed>\n<entity layer><variations layer>\n
+// --format=binary writes for each maze, with integers in little-endian:
+//   uint64 seed, uint32 size, followed by 'size' bytes of TextMaze::Serialize.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/hash/hash.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/defaults.h"
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/parallel_for.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/seed_chunks.h"
+#include "labmaze/cc/text_maze.h"
+
+ABSL_FLAG(int, height, 11, "Maze height. Shall be odd.");
+ABSL_FLAG(int, width, 11, "Maze width. Shall be odd.");
+ABSL_FLAG(int, max_rooms, deepmind::labmaze::defaults::kMaxRooms,
+          "Maximum number of rooms.");
+ABSL_FLAG(int, room_min_size, deepmind::labmaze::defaults::kRoomMinSize,
+          "Minimum room size.");
+ABSL_FLAG(int, room_max_size, deepmind::labmaze::defaults::kRoomMaxSize,
+          "Maximum room size.");
+ABSL_FLAG(int, retry_count, deepmind::labmaze::defaults::kRetryCount,
+          "Number of attempts at placing rooms.");
+ABSL_FLAG(double, extra_connection_probability,
+          deepmind::labmaze::defaults::kExtraConnectionProbability,
+          "Probability of adding extra connections between regions.");
+ABSL_FLAG(int, max_variations, deepmind::labmaze::defaults::kMaxVariations,
+          "Maximum number of room variations.");
+ABSL_FLAG(bool, has_doors, deepmind::labmaze::defaults::kHasDoors,
+          "Whether connections between regions are doors.");
+ABSL_FLAG(bool, simplify, deepmind::labmaze::defaults::kSimplify,
+          "Whether to remove dead ends and horseshoe bends.");
+ABSL_FLAG(int, spawns_per_room, deepmind::labmaze::defaults::kSpawnCount,
+          "Number of spawn points per room.");
+ABSL_FLAG(std::string, spawn_token, deepmind::labmaze::defaults::kSpawnToken,
+          "Character marking spawn points.");
+ABSL_FLAG(int, objects_per_room, deepmind::labmaze::defaults::kObjectCount,
+          "Number of objects per room.");
+ABSL_FLAG(std::string, object_token, deepmind::labmaze::defaults::kObjectToken,
+          "Character marking objects.");
+
+ABSL_FLAG(std::uint64_t, seed_begin, 0, "First seed to generate.");
+ABSL_FLAG(std::uint64_t, seed_end, 1000, "One past the last seed to generate.");
+ABSL_FLAG(int, threads, 0, "Number of worker threads; 0 uses all cores.");
+ABSL_FLAG(std::string, output, "-", "Output file, or '-' for stdout.");
+ABSL_FLAG(std::string, format, "text", "Output format: 'text' or 'binary'.");
+ABSL_FLAG(bool, dedup, false,
+          "Skip mazes whose layers are identical to an earlier maze. Layers "
+          "are compared by 128-bit digests, which cost about 60 bytes of "
+          "memory per maze written.");
+ABSL_FLAG(int, filter_min_rooms, 0, "Skip mazes with fewer rooms.");
+ABSL_FLAG(int, filter_max_rooms, -1,
+          "Skip mazes with more rooms; negative means no limit.");
+ABSL_FLAG(int, filter_min_open_cells, 0,
+          "Skip mazes with fewer non-wall cells.");
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Number of seeds a worker claims at a time.
+constexpr std::uint64_t kChunkSize = 256;
+
+enum class Format { kText, kBinary };
+
+struct Filter {
+  int min_rooms;
+  int max_rooms;
+  int min_open_cells;
+
+  bool Accepts(const TextMaze& maze) const {
+    if (min_open_cells > 0) {
+      int open_cells = 0;
+      maze.Visit(TextMaze::kEntityLayer, [&open_cells](int, int, char c) {
+        open_cells += c != '*';
+      });
+      if (open_cells < min_open_cells) return false;
+    }
+    if (min_rooms > 0 || max_rooms >= 0) {
+      const int rooms = FindRooms(maze, {'*'}).size();
+      if (rooms < min_rooms || (max_rooms >= 0 && rooms > max_rooms)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+void AppendLittleEndian(std::uint64_t value, int num_bytes, std::string* out) {
+  for (int i = 0; i < num_bytes; ++i) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+void AppendRecord(Format format, std::uint64_t seed, const TextMaze& maze,
+                  std::string* out) {
+  switch (format) {
+    case Format::kText:
+      out->append("seed ");
+      out->append(std::to_string(seed));
+      out->push_back('\n');
+      out->append(maze.Text(TextMaze::kEntityLayer));
+      out->append(maze.Text(TextMaze::kVariationsLayer));
+      out->push_back('\n');
+      break;
+    case Format::kBinary: {
+      const std::string data = maze.Serialize();
+      AppendLittleEndian(seed, 8, out);
+      AppendLittleEndian(data.size(), 4, out);
+      out->append(data);
+      break;
+    }
+  }
+}
+
+// A 128-bit digest of the serialized layers of a maze, from two unrelated
+// hash functions. Distinct mazes share one with negligible probability, even
+// over billions of mazes, and a digest takes far less memory than the layers.
+using Digest = std::pair<std::uint64_t, std::uint64_t>;
+
+Digest MakeDigest(const std::string& layers) {
+  return {absl::Hash<std::string>()(layers), std::hash<std::string>()(layers)};
+}
+
+// Serializes writes to the output and tracks duplicates.
+class Writer {
+ public:
+  Writer(std::FILE* file, bool dedup) : file_(file), dedup_(dedup) {}
+
+  // Writes the records in 'buffer', whose byte ranges are delimited by
+  // 'offsets'. If deduplicating, 'digests' holds the digest of each record;
+  // records whose digest was written before are skipped.
+  void Write(const std::string& buffer,
+             const std::vector<std::size_t>& offsets,
+             const std::vector<Digest>& digests) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+      if (dedup_ && !seen_.insert(digests[i]).second) {
+        ++duplicates_;
+        continue;
+      }
+      const std::size_t size = offsets[i + 1] - offsets[i];
+      ok_ = std::fwrite(buffer.data() + offsets[i], 1, size, file_) == size &&
+            ok_;
+      ++written_;
+    }
+  }
+
+  // Flushes the output. Returns false if any write failed.
+  bool Finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ok_ = std::fflush(file_) == 0 && ok_;
+    return ok_;
+  }
+
+  std::uint64_t written() const { return written_; }
+  std::uint64_t duplicates() const { return duplicates_; }
+
+ private:
+  std::FILE* file_;
+  bool dedup_;
+  std::mutex mutex_;
+  // The digests of the records written.
+  std::unordered_set<Digest, absl::Hash<Digest>> seen_;
+  std::uint64_t written_ = 0;
+  std::uint64_t duplicates_ = 0;
+  bool ok_ = true;
+};
+
+int Main() {
+  RandomMazeParams params;
+  params.height = absl::GetFlag(FLAGS_height);
+  params.width = absl::GetFlag(FLAGS_width);
+  params.max_rooms = absl::GetFlag(FLAGS_max_rooms);
+  params.room_min_size = absl::GetFlag(FLAGS_room_min_size);
+  params.room_max_size = absl::GetFlag(FLAGS_room_max_size);
+  params.retry_count = absl::GetFlag(FLAGS_retry_count);
+  params.extra_connection_probability =
+      absl::GetFlag(FLAGS_extra_connection_probability);
+  params.max_variations = absl::GetFlag(FLAGS_max_variations);
+  params.has_doors = absl::GetFlag(FLAGS_has_doors);
+  params.simplify = absl::GetFlag(FLAGS_simplify);
+  params.spawns_per_room = absl::GetFlag(FLAGS_spawns_per_room);
+  params.spawn_token = absl::GetFlag(FLAGS_spawn_token);
+  params.objects_per_room = absl::GetFlag(FLAGS_objects_per_room);
+  params.object_token = absl::GetFlag(FLAGS_object_token);
+  CHECK(params.height > 0 && params.height % 2 == 1)
+      << "--height shall be a positive odd integer.";
+  CHECK(params.width > 0 && params.width % 2 == 1)
+      << "--width shall be a positive odd integer.";
+  CHECK_EQ(params.spawn_token.size(), std::size_t{1})
+      << "--spawn_token shall be one char.";
+  CHECK_EQ(params.object_token.size(), std::size_t{1})
+      << "--object_token shall be one char.";
+
+  const std::string format_name = absl::GetFlag(FLAGS_format);
+  CHECK(format_name == "text" || format_name == "binary")
+      << "Unknown --format: " << format_name;
+  const Format format = format_name == "text" ? Format::kText : Format::kBinary;
+
+  const Filter filter{absl::GetFlag(FLAGS_filter_min_rooms),
+                      absl::GetFlag(FLAGS_filter_max_rooms),
+                      absl::GetFlag(FLAGS_filter_min_open_cells)};
+
+  const std::uint64_t seed_begin = absl::GetFlag(FLAGS_seed_begin);
+  const std::uint64_t seed_end = absl::GetFlag(FLAGS_seed_end);
+  const int num_threads =
+      internal::ResolveNumThreads(absl::GetFlag(FLAGS_threads));
+
+  const std::string output = absl::GetFlag(FLAGS_output);
+  std::FILE* file = output == "-" ? stdout : std::fopen(output.c_str(), "wb");
+  CHECK(file != nullptr) << "Unable to open " << output;
+
+  const bool dedup = absl::GetFlag(FLAGS_dedup);
+  Writer writer(file, dedup);
+  internal::SeedChunks chunks(seed_begin, seed_end, kChunkSize);
+  std::atomic<std::uint64_t> filtered{0};
+
+  auto worker = [&]() {
+    std::string buffer;
+    std::vector<std::size_t> offsets;
+    std::vector<Digest> digests;
+    std::uint64_t begin, end;
+    while (chunks.Next(&begin, &end)) {
+      buffer.clear();
+      offsets.assign(1, 0);
+      digests.clear();
+      for (std::uint64_t seed = begin; seed < end; ++seed) {
+        RandomMaze random_maze(params, seed);
+        const TextMaze& maze = random_maze.Maze();
+        if (!filter.Accepts(maze)) {
+          ++filtered;
+          continue;
+        }
+        AppendRecord(format, seed, maze, &buffer);
+        offsets.push_back(buffer.size());
+        if (dedup) {
+          digests.push_back(MakeDigest(maze.Serialize()));
+        }
+      }
+      writer.Write(buffer, offsets, digests);
+    }
+  };
+
+  const auto start_time = std::chrono::steady_clock::now();
+  internal::ParallelFor(num_threads, num_threads,
+                        [&worker](int) { worker(); });
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_time;
+
+  CHECK(writer.Finish()) << "Unable to write " << output;
+  if (file != stdout) {
+    CHECK_EQ(std::fclose(file), 0) << "Unable to write " << output;
+  }
+
+  const std::uint64_t generated = seed_end > seed_begin ? seed_end - seed_begin
+                                                        : 0;
+  std::fprintf(stderr,
+               "generated %llu, written %llu, filtered %llu, duplicates %llu "
+               "in %.3fs using %d threads (%.0f mazes/s)\n",
+               static_cast<unsigned long long>(generated),
+               static_cast<unsigned long long>(writer.written()),
+               static_cast<unsigned long long>(filtered.load()),
+               static_cast<unsigned long long>(writer.duplicates()),
+               elapsed.count(), num_threads,
+               elapsed.count() > 0 ? generated / elapsed.count() : 0.0);
+  return 0;
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  return deepmind::labmaze::Main();
+}
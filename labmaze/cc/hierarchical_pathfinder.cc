@@ -0,0 +1,376 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/hierarchical_pathfinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/parallel_for.h"
+#include "labmaze/cc/search_labels.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+constexpr int kUnreached = std::numeric_limits<int>::max();
+
+// Steps to the neighbours above, below, left and right of a cell.
+constexpr Vec kSteps[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+// The labels of the entrances in a search, kept by each thread across
+// searches. Entrance k is labelled in the current search only if epochs[k]
+// equals epoch.
+struct SearchLabels {
+  internal::EpochStamps epochs;
+  std::vector<int> distances;
+  std::vector<int> parents;
+  unsigned int epoch = 0;
+};
+
+// Returns the labels of the calling thread, with room for 'num_entrances'
+// entrances and none of them labelled.
+SearchLabels& ThreadSearchLabels(int num_entrances) {
+  SearchLabels& labels = internal::ThreadLabels<SearchLabels>();
+  labels.epochs.Reserve(num_entrances);
+  internal::ReserveLabels(num_entrances, &labels.distances);
+  internal::ReserveLabels(num_entrances, &labels.parents);
+  labels.epoch = labels.epochs.NewStamps();
+  return labels;
+}
+
+// Returns 'tile_size', which shall be positive, so that it is checked before
+// any division by it.
+int CheckedTileSize(int tile_size) {
+  CHECK_GT(tile_size, 0);
+  return tile_size;
+}
+
+// Returns the row-major index of 'pos' within 'area'.
+int LocalIndex(const Rectangle& area, Pos pos) {
+  return (pos.row - area.pos.row) * area.size.width + pos.col - area.pos.col;
+}
+
+}  // namespace
+
+HierarchicalPathfinder::HierarchicalPathfinder(
+    const TextMaze& maze, TextMaze::Layer layer,
+    const std::vector<char>& wall_chars, int tile_size, int num_threads)
+    : layer_(layer),
+      is_wall_(internal::MakeCharBoolMap(wall_chars)),
+      tile_size_(CheckedTileSize(tile_size)),
+      num_threads_(internal::ResolveNumThreads(num_threads)),
+      area_(maze.Area()),
+      tiles_per_row_((area_.size.width + tile_size_ - 1) / tile_size_),
+      open_(area_.size, 0, 0) {
+  const int tiles_per_column = (area_.size.height + tile_size - 1) / tile_size;
+  tiles_.resize(tiles_per_row_ * tiles_per_column);
+  for (int tile = 0; tile < NumTiles(); ++tile) {
+    tiles_[tile].area =
+        Overlap(area_, {{tile / tiles_per_row_ * tile_size,
+                         tile % tiles_per_row_ * tile_size},
+                        {tile_size, tile_size}});
+  }
+  ReadCells(maze, area_);
+  std::vector<int> tiles(tiles_.size());
+  std::iota(tiles.begin(), tiles.end(), 0);
+  BuildTiles(tiles);
+}
+
+void HierarchicalPathfinder::ReadCells(const TextMaze& maze,
+                                       const Rectangle& rect) {
+  internal::ReadOpenCells(maze, layer_, is_wall_, rect, &open_);
+}
+
+int HierarchicalPathfinder::Update(const TextMaze& maze,
+                                   const Rectangle& rect) {
+  CHECK(maze.Area().size.height == area_.size.height &&
+        maze.Area().size.width == area_.size.width)
+      << "Maze extents changed.";
+  const Rectangle changed = Overlap(area_, rect);
+  if (changed.Area() == 0) {
+    return 0;
+  }
+  ReadCells(maze, changed);
+
+  // A cell on the edge of a tile is also an entrance of the next tile.
+  const int first_row = std::max(0, changed.pos.row - 1) / tile_size_;
+  const int last_row = std::min(area_.size.height - 1,
+                                changed.pos.row + changed.size.height) /
+                       tile_size_;
+  const int first_col = std::max(0, changed.pos.col - 1) / tile_size_;
+  const int last_col =
+      std::min(area_.size.width - 1, changed.pos.col + changed.size.width) /
+      tile_size_;
+  std::vector<int> tiles;
+  for (int row = first_row; row <= last_row; ++row) {
+    for (int col = first_col; col <= last_col; ++col) {
+      tiles.push_back(row * tiles_per_row_ + col);
+    }
+  }
+  BuildTiles(tiles);
+  return tiles.size();
+}
+
+int HierarchicalPathfinder::EntranceTile(int entrance) const {
+  return std::upper_bound(first_entrances_.begin(), first_entrances_.end(),
+                          entrance) -
+         first_entrances_.begin() - 1;
+}
+
+void HierarchicalPathfinder::BuildTiles(const std::vector<int>& tiles) {
+  // Tiles are dealt out in turn, which spreads dense and sparse regions of the
+  // maze across threads.
+  internal::ParallelFor(tiles.size(), num_threads_,
+                        [this, &tiles](int k) { BuildTile(tiles[k]); });
+  first_entrances_.resize(tiles_.size() + 1);
+  first_entrances_[0] = 0;
+  for (std::size_t tile = 0; tile < tiles_.size(); ++tile) {
+    first_entrances_[tile + 1] =
+        first_entrances_[tile] + tiles_[tile].entrances.size();
+  }
+}
+
+void HierarchicalPathfinder::BuildTile(int index) {
+  Tile& tile = tiles_[index];
+  const Rectangle& area = tile.area;
+  const int top = area.pos.row;
+  const int bottom = top + area.size.height - 1;
+  const int left = area.pos.col;
+  const int right = left + area.size.width - 1;
+  auto& entrances = tile.entrances;
+  entrances.clear();
+  const auto add_if_open = [this, &entrances](Pos pos, Vec outwards) {
+    if (IsOpen(pos) && IsOpen(pos + outwards)) {
+      entrances.push_back(pos);
+    }
+  };
+  tile.sides[0] = 0;
+  for (int col = left; col <= right; ++col) {
+    add_if_open({top, col}, kSteps[0]);
+  }
+  tile.sides[1] = entrances.size();
+  for (int col = left; col <= right; ++col) {
+    add_if_open({bottom, col}, kSteps[1]);
+  }
+  tile.sides[2] = entrances.size();
+  for (int row = top; row <= bottom; ++row) {
+    add_if_open({row, left}, kSteps[2]);
+  }
+  tile.sides[3] = entrances.size();
+  for (int row = top; row <= bottom; ++row) {
+    add_if_open({row, right}, kSteps[3]);
+  }
+  tile.sides[4] = entrances.size();
+
+  const int n = entrances.size();
+  tile.distances.assign(n * n, -1);
+  std::vector<int> distances;
+  for (int i = 0; i < n; ++i) {
+    TileDistances(tile, entrances[i], &distances);
+    for (int j = 0; j < n; ++j) {
+      tile.distances[i * n + j] = distances[LocalIndex(area, entrances[j])];
+    }
+  }
+}
+
+void HierarchicalPathfinder::TileDistances(const Tile& tile, Pos source,
+                                           std::vector<int>* distances) const {
+  const Rectangle& area = tile.area;
+  distances->assign(area.Area(), -1);
+  std::vector<Pos> queue;
+  queue.reserve(area.Area());
+  (*distances)[LocalIndex(area, source)] = 0;
+  queue.push_back(source);
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const Pos pos = queue[head];
+    const int distance = (*distances)[LocalIndex(area, pos)] + 1;
+    for (const Vec& step : kSteps) {
+      const Pos next = pos + step;
+      if (area.InBounds(next) && IsOpen(next)) {
+        int& next_distance = (*distances)[LocalIndex(area, next)];
+        if (next_distance == -1) {
+          next_distance = distance;
+          queue.push_back(next);
+        }
+      }
+    }
+  }
+}
+
+int HierarchicalPathfinder::Search(Pos from, Pos to,
+                                   std::vector<Waypoint>* route) const {
+  if (!area_.InBounds(from) || !area_.InBounds(to) || !IsOpen(from) ||
+      !IsOpen(to)) {
+    return -1;
+  }
+  const int start_tile = TileAt(from);
+  const int goal_tile = TileAt(to);
+  if (from == to) {
+    if (route != nullptr) {
+      route->push_back({start_tile, from});
+    }
+    return 0;
+  }
+  std::vector<int> start_distances, goal_distances;
+  TileDistances(tiles_[start_tile], from, &start_distances);
+  TileDistances(tiles_[goal_tile], to, &goal_distances);
+
+  // A* over the entrances, with the Manhattan distance to 'to' as heuristic.
+  // Each entrance keeps the entrance it was reached from, or -1 for 'from'.
+  SearchLabels& labels = ThreadSearchLabels(NumEntrances());
+  const unsigned int epoch = labels.epoch;
+  using Entry = std::pair<int, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  const auto heuristic = [&to](Pos pos) {
+    return std::abs(pos.row - to.row) + std::abs(pos.col - to.col);
+  };
+  const auto reach = [this, &labels, epoch, &queue, &heuristic](
+                         int tile, int entrance, int distance, int parent) {
+    const int key = first_entrances_[tile] + entrance;
+    if (labels.epochs[key] == epoch && labels.distances[key] <= distance) {
+      return;
+    }
+    labels.epochs[key] = epoch;
+    labels.distances[key] = distance;
+    labels.parents[key] = parent;
+    queue.push({distance + heuristic(tiles_[tile].entrances[entrance]), key});
+  };
+
+  // The best route so far ends at the entrance 'last', or goes straight from
+  // 'from' to 'to' within their tile if 'last' is -1.
+  int best = kUnreached;
+  int last = -1;
+  if (start_tile == goal_tile) {
+    const int distance =
+        start_distances[LocalIndex(tiles_[start_tile].area, to)];
+    if (distance >= 0) {
+      best = distance;
+    }
+  }
+  const Tile& start = tiles_[start_tile];
+  const int tile_offsets[] = {-tiles_per_row_, tiles_per_row_, -1, 1};
+  for (int i = 0; i < static_cast<int>(start.entrances.size()); ++i) {
+    const int distance =
+        start_distances[LocalIndex(start.area, start.entrances[i])];
+    if (distance >= 0) {
+      reach(start_tile, i, distance, -1);
+    }
+  }
+
+  while (!queue.empty()) {
+    const int estimate = queue.top().first;
+    const int key = queue.top().second;
+    queue.pop();
+    if (estimate >= best) {
+      break;
+    }
+    const int index = EntranceTile(key);
+    const int i = key - first_entrances_[index];
+    const Tile& tile = tiles_[index];
+    const Pos pos = tile.entrances[i];
+    const int distance = labels.distances[key];
+    if (estimate > distance + heuristic(pos)) {
+      continue;
+    }
+    if (index == goal_tile) {
+      const int rest = goal_distances[LocalIndex(tile.area, pos)];
+      if (rest >= 0 && distance + rest < best) {
+        best = distance + rest;
+        last = key;
+      }
+    }
+    const int n = tile.entrances.size();
+    const int* within = &tile.distances[i * n];
+    for (int j = 0; j < n; ++j) {
+      if (within[j] >= 0 && j != i) {
+        reach(index, j, distance + within[j], key);
+      }
+    }
+    // Cross to the facing entrance of the next tile.
+    int side = 0;
+    while (i >= tile.sides[side + 1]) {
+      ++side;
+    }
+    const int next = index + tile_offsets[side];
+    reach(next, tiles_[next].sides[side ^ 1] + i - tile.sides[side],
+          distance + 1, key);
+  }
+  if (best == kUnreached) {
+    return -1;
+  }
+
+  if (route != nullptr) {
+    route->push_back({goal_tile, to});
+    for (int key = last; key != -1; key = labels.parents[key]) {
+      const int index = EntranceTile(key);
+      route->push_back(
+          {index, tiles_[index].entrances[key - first_entrances_[index]]});
+    }
+    route->push_back({start_tile, from});
+    std::reverse(route->begin(), route->end());
+  }
+  return best;
+}
+
+int HierarchicalPathfinder::Distance(Pos from, Pos to) const {
+  return Search(from, to, nullptr);
+}
+
+std::vector<Pos> HierarchicalPathfinder::ShortestPath(Pos from, Pos to) const {
+  std::vector<Pos> result;
+  std::vector<Waypoint> route;
+  const int distance = Search(from, to, &route);
+  if (distance == -1) {
+    return result;
+  }
+  result.reserve(distance + 1);
+  result.push_back(from);
+  std::vector<int> distances;
+  for (std::size_t k = 1; k < route.size(); ++k) {
+    const Waypoint& target = route[k];
+    if (route[k - 1].tile != target.tile) {
+      result.push_back(target.pos);
+      continue;
+    }
+    // Refine the step within the tile by descending its distances to
+    // 'target'.
+    const Tile& tile = tiles_[target.tile];
+    TileDistances(tile, target.pos, &distances);
+    Pos pos = route[k - 1].pos;
+    for (int remaining = distances[LocalIndex(tile.area, pos)];
+         remaining > 0; --remaining) {
+      for (const Vec& step : kSteps) {
+        const Pos next = pos + step;
+        if (tile.area.InBounds(next) &&
+            distances[LocalIndex(tile.area, next)] == remaining - 1) {
+          pos = next;
+          break;
+        }
+      }
+      result.push_back(pos);
+    }
+  }
+  return result;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
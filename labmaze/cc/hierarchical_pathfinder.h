@@ -0,0 +1,138 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Hierarchical path finding (HPA*) over square tiles of large mazes.
+
+#ifndef LABMAZE_CC_HIERARCHICAL_PATHFINDER_H_
+#define LABMAZE_CC_HIERARCHICAL_PATHFINDER_H_
+
+#include <array>
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Answers shortest path queries between cells of a maze by searching an
+// abstract graph instead of the cells. The maze is cut into square tiles. The
+// nodes of the graph are the entrances of the tiles, which are the open cells
+// on the edge of a tile with an open neighbour in the next tile, and its edges
+// join each entrance to its neighbour across the tile edge and to the other
+// entrances of its tile, weighted by their distance within the tile. Since
+// every crossing between tiles is an entrance, queries return exact distances,
+// unlike HPA* with one entrance per border segment.
+//
+// The distances within tiles are precomputed on several threads. When cells
+// change, Update recomputes only the tiles that contain or border them.
+class HierarchicalPathfinder {
+ public:
+  // Reads the cells of 'layer' of 'maze' that are not in 'wall_chars', and
+  // cuts them into tiles of 'tile_size' x 'tile_size' cells. The precomputation
+  // uses up to 'num_threads' threads, or all cores if 'num_threads' is 0.
+  HierarchicalPathfinder(const TextMaze& maze, TextMaze::Layer layer,
+                         const std::vector<char>& wall_chars,
+                         int tile_size = 16, int num_threads = 0);
+
+  // Re-reads the cells in 'rect' from 'maze', which shall have the extents of
+  // the maze given on construction, and recomputes the tiles whose entrances
+  // or distances they affect. Returns the number of tiles recomputed.
+  int Update(const TextMaze& maze, const Rectangle& rect);
+
+  int TileSize() const { return tile_size_; }
+  int NumTiles() const { return static_cast<int>(tiles_.size()); }
+
+  // Returns the number of entrances of all tiles, which are the nodes of the
+  // abstract graph.
+  int NumEntrances() const { return first_entrances_.back(); }
+
+  // If 'to' is reachable from 'from', returns the minimum distance between
+  // them. Otherwise returns -1.
+  int Distance(Pos from, Pos to) const;
+
+  // If 'to' is reachable from 'from', returns a shortest route from 'from' to
+  // 'to' including both end points. Otherwise returns an empty vector.
+  std::vector<Pos> ShortestPath(Pos from, Pos to) const;
+
+ private:
+  struct Tile {
+    Rectangle area;
+    // Entrances on the top, bottom, left and right edges of the tile, in that
+    // order. Those on edge k are entrances[sides[k]] to
+    // entrances[sides[k + 1] - 1], ordered by column or row, so that the n-th
+    // entrance on an edge faces the n-th on the matching edge of the next
+    // tile.
+    std::array<int, 5> sides;
+    std::vector<Pos> entrances;
+    // Distance within the tile between entrances i and j at
+    // [i * entrances.size() + j], or -1 if there is no path within the tile.
+    std::vector<int> distances;
+  };
+
+  // A route as a list of cells, each in the tile given, such that consecutive
+  // cells are either in the same tile or neighbours across a tile edge.
+  struct Waypoint {
+    int tile;
+    Pos pos;
+  };
+
+  // Returns the tile containing 'pos'.
+  int TileAt(Pos pos) const {
+    return pos.row / tile_size_ * tiles_per_row_ + pos.col / tile_size_;
+  }
+
+  bool IsOpen(Pos pos) const { return open_[open_.Index(pos.row, pos.col)]; }
+
+  // Returns the tile of the entrance numbered 'entrance'.
+  int EntranceTile(int entrance) const;
+
+  // Reads the cells of 'rect' of 'maze'.
+  void ReadCells(const TextMaze& maze, const Rectangle& rect);
+
+  // Recomputes the entrances and distances of tile 'tile'.
+  void BuildTile(int tile);
+
+  // Recomputes the tiles in 'tiles' on up to num_threads_ threads.
+  void BuildTiles(const std::vector<int>& tiles);
+
+  // Fills 'distances' with the distance from 'source' to each cell of the
+  // area of 'tile' within that area, in row-major order within the tile, or -1
+  // for cells that cannot be reached.
+  void TileDistances(const Tile& tile, Pos source,
+                     std::vector<int>* distances) const;
+
+  // Finds a shortest route from 'from' to 'to'. Returns its length, or -1 if
+  // there is none. Fills 'route' with the waypoints of the route, if not
+  // null.
+  int Search(Pos from, Pos to, std::vector<Waypoint>* route) const;
+
+  TextMaze::Layer layer_;
+  internal::CharBoolMap is_wall_;
+  int tile_size_;
+  int num_threads_;
+  Rectangle area_;
+  int tiles_per_row_;
+  BorderedGrid<char> open_;
+  std::vector<Tile> tiles_;
+  // The entrances of all tiles are numbered in order of tile, starting from
+  // first_entrances_[tile] for those of 'tile', and ending with their total.
+  std::vector<int> first_entrances_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_HIERARCHICAL_PATHFINDER_H_
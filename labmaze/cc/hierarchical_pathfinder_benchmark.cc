@@ -0,0 +1,160 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Precomputation, update and query costs of HierarchicalPathfinder on large
+// braided mazes.
+
+#include <cstddef>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/hierarchical_pathfinder.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns a corridor maze of 'size' x 'size' cells with a tenth of its inner
+// walls removed, so that there are many routes between cells. Mazes are
+// cached across runs.
+const TextMaze& GetMaze(int size) {
+  static auto* mazes = new std::map<int, TextMaze>;
+  auto it = mazes->find(size);
+  if (it == mazes->end()) {
+    std::mt19937_64 rng(1);
+    TextMaze maze({size, size});
+    FillSpaceWithMaze(1, 0, &maze, &rng);
+    std::bernoulli_distribution remove(0.1);
+    Rectangle{{1, 1}, {size - 2, size - 2}}.Visit([&maze, &remove, &rng](
+                                                     int i, int j) {
+      if ((i + j) % 2 == 1 && remove(rng)) {
+        maze.SetCell(TextMaze::kEntityLayer, {i, j}, ' ');
+      }
+    });
+    it = mazes->emplace(size, std::move(maze)).first;
+  }
+  return it->second;
+}
+
+// Returns random pairs of open cells of 'maze'.
+std::vector<std::pair<Pos, Pos>> RandomQueries(const TextMaze& maze) {
+  std::mt19937_64 rng(1);
+  const Size& size = maze.Area().size;
+  std::uniform_int_distribution<> row(0, size.height / 2 - 1);
+  std::uniform_int_distribution<> col(0, size.width / 2 - 1);
+  std::vector<std::pair<Pos, Pos>> queries(64);
+  for (auto& query : queries) {
+    query.first = {2 * row(rng) + 1, 2 * col(rng) + 1};
+    query.second = {2 * row(rng) + 1, 2 * col(rng) + 1};
+  }
+  return queries;
+}
+
+// Builds the pathfinder of a maze of state.range(0) cells square with tiles of
+// state.range(1) cells on state.range(2) threads.
+void BM_Build(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state.range(0));
+  for (auto _ : state) {
+    HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer, {'*'},
+                                      state.range(1), state.range(2));
+    benchmark::DoNotOptimize(pathfinder);
+  }
+  state.SetItemsProcessed(state.iterations() * maze.Area().Area());
+}
+BENCHMARK(BM_Build)
+    ->ArgNames({"size", "tile", "threads"})
+    ->Args({1001, 16, 1})
+    ->Args({1001, 16, 4})
+    ->Args({4001, 16, 1})
+    ->Args({4001, 16, 4})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_Update(benchmark::State& state) {
+  TextMaze maze = GetMaze(state.range(0));
+  HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer, {'*'},
+                                    state.range(1), 1);
+  const int middle = state.range(0) / 2;
+  const Pos pos = {middle, middle};
+  for (auto _ : state) {
+    maze.SetCell(TextMaze::kEntityLayer, pos,
+                 maze.GetCell(TextMaze::kEntityLayer, pos) == '*' ? ' ' : '*');
+    benchmark::DoNotOptimize(pathfinder.Update(maze, {pos, {1, 1}}));
+  }
+}
+BENCHMARK(BM_Update)
+    ->ArgNames({"size", "tile"})
+    ->Args({1001, 16})
+    ->Args({1001, 32})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_Distance(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state.range(0));
+  const HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer, {'*'},
+                                          state.range(1), 0);
+  const auto queries = RandomQueries(maze);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const auto& query = queries[k++ % queries.size()];
+    benchmark::DoNotOptimize(pathfinder.Distance(query.first, query.second));
+  }
+}
+BENCHMARK(BM_Distance)
+    ->ArgNames({"size", "tile"})
+    ->Args({1001, 16})
+    ->Args({1001, 32})
+    ->Args({4001, 16})
+    ->Args({4001, 32})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ShortestPath(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state.range(0));
+  const HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer, {'*'},
+                                          state.range(1), 0);
+  const auto queries = RandomQueries(maze);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const auto& query = queries[k++ % queries.size()];
+    benchmark::DoNotOptimize(
+        pathfinder.ShortestPath(query.first, query.second));
+  }
+}
+BENCHMARK(BM_ShortestPath)
+    ->ArgNames({"size", "tile"})
+    ->Args({1001, 16})
+    ->Args({4001, 16})
+    ->Unit(benchmark::kMicrosecond);
+
+// The flood fill that each query would otherwise take.
+void BM_FloodFillDistance(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state.range(0));
+  const auto queries = RandomQueries(maze);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const auto& query = queries[k++ % queries.size()];
+    const FloodFill fill(maze, TextMaze::kEntityLayer, query.second, {'*'});
+    benchmark::DoNotOptimize(fill.DistanceFrom(query.first));
+  }
+}
+BENCHMARK(BM_FloodFillDistance)->Arg(1001)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
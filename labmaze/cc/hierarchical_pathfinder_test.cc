@@ -0,0 +1,140 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/hierarchical_pathfinder.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+TextMaze MakeRandomMaze(int seed) {
+  RandomMazeParams params;
+  params.height = 31;
+  params.width = 41;
+  params.max_rooms = 6;
+  params.extra_connection_probability = 0.1;
+  return RandomMaze(params, seed).Maze();
+}
+
+// Checks distances and paths from all cells to a few goals against FloodFill.
+void ExpectMatchesFloodFill(const TextMaze& maze,
+                            const HierarchicalPathfinder& pathfinder,
+                            std::mt19937_64* rng) {
+  const Size& size = maze.Area().size;
+  std::uniform_int_distribution<> row(0, size.height - 1);
+  std::uniform_int_distribution<> col(0, size.width - 1);
+  for (int k = 0; k < 5; ++k) {
+    const Pos goal = {row(*rng), col(*rng)};
+    const FloodFill fill(maze, TextMaze::kEntityLayer, goal, {'*'});
+    maze.Area().Visit([&](int i, int j) {
+      const int distance = fill.DistanceFrom({i, j});
+      ASSERT_EQ(distance, pathfinder.Distance({i, j}, goal))
+          << "from " << i << ", " << j << " to " << goal.row << ", "
+          << goal.col;
+      const auto path = pathfinder.ShortestPath({i, j}, goal);
+      ASSERT_EQ(distance + 1, static_cast<int>(path.size()));
+      if (path.empty()) {
+        return;
+      }
+      EXPECT_EQ((Pos{i, j}), path.front());
+      EXPECT_EQ(goal, path.back());
+      for (std::size_t step = 1; step < path.size(); ++step) {
+        EXPECT_EQ(1, std::abs(path[step].row - path[step - 1].row) +
+                         std::abs(path[step].col - path[step - 1].col));
+        EXPECT_EQ(distance - static_cast<int>(step),
+                  fill.DistanceFrom(path[step]));
+      }
+    });
+  }
+}
+
+TEST(HierarchicalPathfinderTest, Entrances) {
+  const TextMaze maze = FromCharGrid(CharGrid("****\n"
+                                              "*  *\n"
+                                              "*  *\n"
+                                              "* **\n"));
+  const HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer, {'*'},
+                                          2, 1);
+  EXPECT_EQ(4, pathfinder.NumTiles());
+  // The two cells of the room on each side of each tile edge it crosses.
+  EXPECT_EQ(8, pathfinder.NumEntrances());
+  EXPECT_EQ(3, pathfinder.Distance({1, 2}, {3, 1}));
+  EXPECT_THAT(pathfinder.ShortestPath({3, 1}, {1, 1}),
+              ElementsAre(Pos{3, 1}, Pos{2, 1}, Pos{1, 1}));
+  EXPECT_EQ(-1, pathfinder.Distance({0, 0}, {1, 1}));
+  EXPECT_EQ(-1, pathfinder.Distance({1, 1}, {4, 1}));
+  EXPECT_EQ(0, pathfinder.Distance({2, 2}, {2, 2}));
+}
+
+TEST(HierarchicalPathfinderTest, MatchesFloodFill) {
+  std::mt19937_64 rng(1);
+  for (int seed = 0; seed < 3; ++seed) {
+    const TextMaze maze = MakeRandomMaze(seed);
+    for (int tile_size : {1, 4, 7, 16, 64}) {
+      const HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer,
+                                              {'*'}, tile_size, 3);
+      ExpectMatchesFloodFill(maze, pathfinder, &rng);
+    }
+  }
+}
+
+TEST(HierarchicalPathfinderTest, Update) {
+  std::mt19937_64 rng(2);
+  TextMaze maze = MakeRandomMaze(3);
+  HierarchicalPathfinder pathfinder(maze, TextMaze::kEntityLayer, {'*'}, 8, 2);
+
+  // A cell inside a tile only changes that tile.
+  maze.SetCell(TextMaze::kEntityLayer, {3, 3}, ' ');
+  EXPECT_EQ(1, pathfinder.Update(maze, {{3, 3}, {1, 1}}));
+  ExpectMatchesFloodFill(maze, pathfinder, &rng);
+
+  // A cell in the corner of a tile also changes the entrances of the three
+  // tiles around that corner.
+  maze.SetCell(TextMaze::kEntityLayer, {15, 15}, '*');
+  EXPECT_EQ(4, pathfinder.Update(maze, {{15, 15}, {1, 1}}));
+  ExpectMatchesFloodFill(maze, pathfinder, &rng);
+
+  // Walls across the maze cut it in two.
+  maze.FillRect(TextMaze::kEntityLayer, {{0, 20}, {31, 1}}, '*');
+  EXPECT_EQ(4, pathfinder.Update(maze, {{0, 20}, {31, 1}}));
+  ExpectMatchesFloodFill(maze, pathfinder, &rng);
+  EXPECT_EQ(-1, pathfinder.Distance({1, 1}, {29, 39}));
+
+  EXPECT_EQ(0, pathfinder.Update(maze, {{40, 0}, {5, 5}}));
+}
+
+TEST(HierarchicalPathfinderDeathTest, NonPositiveTileSize) {
+  const TextMaze maze({4, 4});
+  EXPECT_DEATH(HierarchicalPathfinder(maze, TextMaze::kEntityLayer, {'*'}, 0),
+               "tile_size");
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
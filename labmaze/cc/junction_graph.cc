@@ -0,0 +1,313 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/junction_graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include "labmaze/cc/flood_fill.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+constexpr int kUnreached = std::numeric_limits<int>::max();
+
+}  // namespace
+
+JunctionGraph::JunctionGraph(const TextMaze& maze, TextMaze::Layer layer,
+                             const std::vector<char>& wall_chars)
+    : area_(maze.Area()), cell_locations_(area_.size, -1, -1) {
+  const auto is_wall = internal::MakeCharBoolMap(wall_chars);
+  BorderedGrid<char> open(area_.size, 0, 0);
+  maze.VisitRows(layer, [&open, &is_wall](int i, int j, const char* cells,
+                                          int count) {
+    for (int k = 0; k < count; ++k) {
+      open[open.Index(i, j + k)] =
+          !is_wall[static_cast<unsigned char>(cells[k])];
+    }
+  });
+
+  auto& locations = cell_locations_;
+  area_.Visit([this, &open, &locations](int i, int j) {
+    const int index = open.Index(i, j);
+    if (!open[index]) {
+      return;
+    }
+    int degree = 0;
+    for (int neighbour : open.Neighbours(index)) {
+      degree += open[neighbour];
+    }
+    if (degree != 2) {
+      locations[index] = nodes_.size();
+      nodes_.push_back({i, j});
+    }
+  });
+
+  // Adds the edge that leaves 'node' at 'index' through its neighbour 'next'.
+  const auto trace = [this, &open, &locations](int node, int index, int next) {
+    const int edge = edges_.size();
+    Edge result = {node, -1, 1, static_cast<int>(corridor_cells_.size())};
+    int previous = index;
+    while (locations[next] < 0) {
+      locations[next] = -2 - static_cast<int>(corridor_cells_.size());
+      corridor_cells_.push_back(open.ToPos(next));
+      corridor_edges_.push_back(edge);
+      ++result.length;
+      const int current = next;
+      for (int neighbour : open.Neighbours(current)) {
+        if (open[neighbour] && neighbour != previous) {
+          next = neighbour;
+          break;
+        }
+      }
+      previous = current;
+    }
+    result.node_1 = locations[next];
+    edges_.push_back(result);
+  };
+
+  // Each corridor is traced from the first of its ends to be visited.
+  const int num_junctions = NumNodes();
+  for (int node = 0; node < num_junctions; ++node) {
+    const int index = open.Index(nodes_[node].row, nodes_[node].col);
+    for (int next : open.Neighbours(index)) {
+      const int location = locations[next];
+      if (open[next] && (location >= 0 ? location > node : location == -1)) {
+        trace(node, index, next);
+      }
+    }
+  }
+
+  // What remains are loops of cells with two open neighbours each.
+  area_.Visit([this, &open, &locations, &trace](int i, int j) {
+    const int index = open.Index(i, j);
+    if (!open[index] || locations[index] != -1) {
+      return;
+    }
+    const int node = NumNodes();
+    locations[index] = node;
+    nodes_.push_back({i, j});
+    for (int next : open.Neighbours(index)) {
+      if (open[next]) {
+        trace(node, index, next);
+        break;
+      }
+    }
+  });
+
+  node_edge_offsets_.assign(nodes_.size() + 1, 0);
+  for (const Edge& edge : edges_) {
+    ++node_edge_offsets_[edge.node_0 + 1];
+    ++node_edge_offsets_[edge.node_1 + 1];
+  }
+  for (std::size_t node = 0; node < nodes_.size(); ++node) {
+    node_edge_offsets_[node + 1] += node_edge_offsets_[node];
+  }
+  node_edges_.resize(node_edge_offsets_.back());
+  std::vector<int> next(node_edge_offsets_.begin(),
+                        node_edge_offsets_.end() - 1);
+  for (int edge = 0; edge < NumEdges(); ++edge) {
+    node_edges_[next[edges_[edge].node_0]++] = edge;
+    node_edges_[next[edges_[edge].node_1]++] = edge;
+  }
+}
+
+int JunctionGraph::NodeAt(Pos pos) const {
+  if (!area_.InBounds(pos)) {
+    return -1;
+  }
+  const int location = cell_locations_[cell_locations_.Index(pos.row, pos.col)];
+  return location >= 0 ? location : -1;
+}
+
+int JunctionGraph::EdgeAt(Pos pos) const {
+  if (!area_.InBounds(pos)) {
+    return -1;
+  }
+  const int location = cell_locations_[cell_locations_.Index(pos.row, pos.col)];
+  return location <= -2 ? corridor_edges_[-2 - location] : -1;
+}
+
+bool JunctionGraph::Locate(Pos pos, Location* location) const {
+  if (!area_.InBounds(pos)) {
+    return false;
+  }
+  const int value = cell_locations_[cell_locations_.Index(pos.row, pos.col)];
+  if (value == -1) {
+    return false;
+  } else if (value >= 0) {
+    *location = {-1, value};
+  } else {
+    const int cell = -2 - value;
+    const int edge = corridor_edges_[cell];
+    *location = {edge, cell - edges_[edge].cells_begin + 1};
+  }
+  return true;
+}
+
+Pos JunctionGraph::CellAt(int edge, int step) const {
+  const Edge& e = edges_[edge];
+  if (step == 0) {
+    return nodes_[e.node_0];
+  } else if (step == e.length) {
+    return nodes_[e.node_1];
+  } else {
+    return corridor_cells_[e.cells_begin + step - 1];
+  }
+}
+
+int JunctionGraph::Search(const Location& from, const Location& to,
+                          std::vector<Segment>* segments) const {
+  if (from.edge == to.edge && from.step == to.step) {
+    return 0;
+  }
+
+  // Dijkstra's algorithm over the nodes. Each node keeps the segment by which
+  // it was reached and the node that segment starts from, or -1 for 'from'.
+  struct Label {
+    int distance;
+    int parent;
+    Segment segment;
+  };
+  std::vector<Label> labels(nodes_.size(), {kUnreached, -1, {-1, 0, 0}});
+  using Entry = std::pair<int, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  const auto reach = [&labels, &queue](int node, int distance, int parent,
+                                       const Segment& segment) {
+    Label& label = labels[node];
+    if (distance < label.distance) {
+      label = {distance, parent, segment};
+      queue.push({distance, node});
+    }
+  };
+  if (from.edge < 0) {
+    reach(from.step, 0, -1, {-1, 0, 0});
+  } else {
+    const Edge& edge = edges_[from.edge];
+    reach(edge.node_0, from.step, -1, {from.edge, from.step, 0});
+    reach(edge.node_1, edge.length - from.step, -1,
+          {from.edge, from.step, edge.length});
+  }
+
+  // The best route so far ends with 'last' after node 'last_parent'.
+  int best = kUnreached;
+  int last_parent = -1;
+  Segment last = {-1, 0, 0};
+  const auto finish = [&best, &last_parent, &last](int distance, int parent,
+                                                   const Segment& segment) {
+    if (distance < best) {
+      best = distance;
+      last_parent = parent;
+      last = segment;
+    }
+  };
+  if (to.edge >= 0 && to.edge == from.edge) {
+    finish(std::abs(to.step - from.step), -1, {to.edge, from.step, to.step});
+  }
+
+  while (!queue.empty()) {
+    const int distance = queue.top().first;
+    const int node = queue.top().second;
+    queue.pop();
+    if (distance >= best) {
+      break;
+    }
+    if (distance > labels[node].distance) {
+      continue;
+    }
+    if (to.edge < 0) {
+      if (node == to.step) {
+        finish(distance, node, {-1, 0, 0});
+        break;
+      }
+    } else {
+      const Edge& edge = edges_[to.edge];
+      if (node == edge.node_0) {
+        finish(distance + to.step, node, {to.edge, 0, to.step});
+      }
+      if (node == edge.node_1) {
+        finish(distance + edge.length - to.step, node,
+               {to.edge, edge.length, to.step});
+      }
+    }
+    for (int k = node_edge_offsets_[node]; k < node_edge_offsets_[node + 1];
+         ++k) {
+      const Edge& edge = edges_[node_edges_[k]];
+      if (edge.node_0 == edge.node_1) {
+        continue;
+      }
+      const bool forward = edge.node_0 == node;
+      reach(forward ? edge.node_1 : edge.node_0, distance + edge.length, node,
+            {node_edges_[k], forward ? 0 : edge.length,
+             forward ? edge.length : 0});
+    }
+  }
+  if (best == kUnreached) {
+    return -1;
+  }
+
+  if (segments != nullptr) {
+    if (last.edge >= 0) {
+      segments->push_back(last);
+    }
+    for (int node = last_parent; node != -1; node = labels[node].parent) {
+      if (labels[node].segment.edge >= 0) {
+        segments->push_back(labels[node].segment);
+      }
+    }
+    std::reverse(segments->begin(), segments->end());
+  }
+  return best;
+}
+
+int JunctionGraph::Distance(Pos from, Pos to) const {
+  Location from_location, to_location;
+  if (!Locate(from, &from_location) || !Locate(to, &to_location)) {
+    return -1;
+  }
+  return Search(from_location, to_location, nullptr);
+}
+
+std::vector<Pos> JunctionGraph::ShortestPath(Pos from, Pos to) const {
+  std::vector<Pos> result;
+  Location from_location, to_location;
+  if (!Locate(from, &from_location) || !Locate(to, &to_location)) {
+    return result;
+  }
+  std::vector<Segment> segments;
+  const int distance = Search(from_location, to_location, &segments);
+  if (distance == -1) {
+    return result;
+  }
+  result.reserve(distance + 1);
+  result.push_back(from);
+  for (const Segment& segment : segments) {
+    const int direction = segment.to > segment.from ? 1 : -1;
+    for (int step = segment.from; step != segment.to;) {
+      step += direction;
+      result.push_back(CellAt(segment.edge, step));
+    }
+  }
+  return result;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,134 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Contraction of a maze into a weighted graph of its junctions, for shortest
+// path queries that skip over the cells of corridors.
+
+#ifndef LABMAZE_CC_JUNCTION_GRAPH_H_
+#define LABMAZE_CC_JUNCTION_GRAPH_H_
+
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// The open cells of a maze as a graph whose nodes are the cells that do not
+// have exactly two open neighbours: junctions, dead ends and most room cells.
+// Each edge is a corridor, a chain of cells with two open neighbours each that
+// joins two nodes, or a node to itself. A loop made only of such cells gets
+// its first cell in row-major order as a node.
+class JunctionGraph {
+ public:
+  struct Edge {
+    int node_0;
+    int node_1;
+    // Number of steps from node_0 to node_1, one more than the number of
+    // corridor cells.
+    int length;
+    // The corridor cells are CorridorCells()[cells_begin] onwards, in order
+    // from node_0 to node_1.
+    int cells_begin;
+  };
+
+  // Contracts the cells of 'layer' of 'maze' that are not in 'wall_chars'.
+  JunctionGraph(const TextMaze& maze, TextMaze::Layer layer,
+                const std::vector<char>& wall_chars);
+
+  // Nodes are numbered in row-major order of their cells, followed by the
+  // nodes of loops.
+  int NumNodes() const { return static_cast<int>(nodes_.size()); }
+  Pos NodeCell(int node) const { return nodes_[node]; }
+
+  int NumEdges() const { return static_cast<int>(edges_.size()); }
+  const Edge& GetEdge(int edge) const { return edges_[edge]; }
+
+  // Returns the cells of edge 'edge' between its nodes, which number
+  // GetEdge(edge).length - 1.
+  const Pos* CorridorCells(int edge) const {
+    return corridor_cells_.data() + edges_[edge].cells_begin;
+  }
+
+  // Returns the edges of 'node', which number NumEdgesAt(node). A loop at
+  // 'node' appears twice.
+  const int* EdgesAt(int node) const {
+    return node_edges_.data() + node_edge_offsets_[node];
+  }
+  int NumEdgesAt(int node) const {
+    return node_edge_offsets_[node + 1] - node_edge_offsets_[node];
+  }
+
+  // Returns the node at 'pos', or -1 if 'pos' is a corridor cell, a wall or
+  // out of bounds.
+  int NodeAt(Pos pos) const;
+
+  // Returns the edge whose corridor contains 'pos', or -1 if there is none.
+  int EdgeAt(Pos pos) const;
+
+  // If 'to' is reachable from 'from', returns the minimum distance between
+  // them. Otherwise returns -1.
+  int Distance(Pos from, Pos to) const;
+
+  // If 'to' is reachable from 'from', returns a shortest route from 'from' to
+  // 'to' including both end points, as FloodFill::ShortestPathFrom does.
+  // Otherwise returns an empty vector. Among several shortest routes, the one
+  // returned depends only on the graph.
+  std::vector<Pos> ShortestPath(Pos from, Pos to) const;
+
+ private:
+  // A cell as a position along an edge: step 0 is the cell of node_0 and step
+  // 'length' that of node_1. For a node, 'edge' is -1 and 'step' the node.
+  struct Location {
+    int edge;
+    int step;
+  };
+
+  // Part of a route: the cells of 'edge' after step 'from' up to step 'to'.
+  struct Segment {
+    int edge;
+    int from;
+    int to;
+  };
+
+  // Returns the location of 'pos', or false if 'pos' is not an open cell.
+  bool Locate(Pos pos, Location* location) const;
+
+  // Returns the cell at step 'step' of edge 'edge'.
+  Pos CellAt(int edge, int step) const;
+
+  // Finds a shortest route from 'from' to 'to' as a sequence of segments.
+  // Returns its length, or -1 if there is none.
+  int Search(const Location& from, const Location& to,
+             std::vector<Segment>* segments) const;
+
+  Rectangle area_;
+  std::vector<Pos> nodes_;
+  std::vector<Edge> edges_;
+  std::vector<Pos> corridor_cells_;
+  // Edge of each corridor cell.
+  std::vector<int> corridor_edges_;
+  // Edges of each node in compressed sparse row form.
+  std::vector<int> node_edge_offsets_;
+  std::vector<int> node_edges_;
+  // For each cell: its node if it is one, -1 for walls, and -2 - k for
+  // corridor_cells_[k].
+  BorderedGrid<int> cell_locations_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_JUNCTION_GRAPH_H_
@@ -0,0 +1,127 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares point-to-point path queries on a JunctionGraph with flood filling
+// the maze from the goal.
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/junction_graph.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns a maze of state.range(0) x state.range(0) cells, simplified if
+// state.range(1) is non-zero. Mazes are cached across runs, since simplifying
+// large mazes takes seconds.
+const TextMaze& GetMaze(const benchmark::State& state) {
+  static auto* mazes = new std::map<std::pair<int, int>, TextMaze>;
+  const std::pair<int, int> key(state.range(0), state.range(1));
+  auto it = mazes->find(key);
+  if (it == mazes->end()) {
+    RandomMazeParams params;
+    params.height = key.first;
+    params.width = key.first;
+    params.max_rooms = key.first / 4;
+    params.simplify = key.second != 0;
+    it = mazes->emplace(key, RandomMaze(params, 1).Maze()).first;
+  }
+  return it->second;
+}
+
+// Returns the open cells of 'maze' in random order.
+std::vector<Pos> ShuffledOpenCells(const TextMaze& maze) {
+  std::vector<Pos> cells;
+  maze.Visit(TextMaze::kEntityLayer, [&cells](int i, int j, char c) {
+    if (c != '*') {
+      cells.push_back({i, j});
+    }
+  });
+  std::shuffle(cells.begin(), cells.end(), std::mt19937_64(1));
+  return cells;
+}
+
+void SetArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"size", "simplify"})
+      ->Args({101, 0})
+      ->Args({101, 1})
+      ->Args({201, 1})
+      ->Args({1001, 0})
+      ->Unit(benchmark::kMicrosecond);
+}
+
+void BM_Build(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        JunctionGraph(maze, TextMaze::kEntityLayer, {'*'}));
+  }
+  state.SetItemsProcessed(state.iterations() * maze.Area().Area());
+}
+BENCHMARK(BM_Build)->Apply(SetArgs);
+
+void BM_FloodFillShortestPath(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state);
+  const auto cells = ShuffledOpenCells(maze);
+  std::mt19937_64 rng(1);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const FloodFill fill(maze, TextMaze::kEntityLayer, cells[k], {'*'});
+    benchmark::DoNotOptimize(
+        fill.ShortestPathFrom(cells[(k + 1) % cells.size()], &rng));
+    k = (k + 2) % cells.size();
+  }
+}
+BENCHMARK(BM_FloodFillShortestPath)->Apply(SetArgs);
+
+void BM_Distance(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state);
+  const JunctionGraph graph(maze, TextMaze::kEntityLayer, {'*'});
+  const auto cells = ShuffledOpenCells(maze);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        graph.Distance(cells[(k + 1) % cells.size()], cells[k]));
+    k = (k + 2) % cells.size();
+  }
+}
+BENCHMARK(BM_Distance)->Apply(SetArgs);
+
+void BM_ShortestPath(benchmark::State& state) {
+  const TextMaze& maze = GetMaze(state);
+  const JunctionGraph graph(maze, TextMaze::kEntityLayer, {'*'});
+  const auto cells = ShuffledOpenCells(maze);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        graph.ShortestPath(cells[(k + 1) % cells.size()], cells[k]));
+    k = (k + 2) % cells.size();
+  }
+}
+BENCHMARK(BM_ShortestPath)->Apply(SetArgs);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
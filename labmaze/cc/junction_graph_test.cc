@@ -0,0 +1,141 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/junction_graph.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(JunctionGraphTest, ContractsCorridors) {
+  const JunctionGraph graph(FromCharGrid(CharGrid("*****\n"
+                                                  "*   *\n"
+                                                  "* ***\n"
+                                                  "*   *\n"
+                                                  "*****\n")),
+                            TextMaze::kEntityLayer, {'*'});
+  ASSERT_EQ(2, graph.NumNodes());
+  EXPECT_EQ((Pos{1, 3}), graph.NodeCell(0));
+  EXPECT_EQ((Pos{3, 3}), graph.NodeCell(1));
+  ASSERT_EQ(1, graph.NumEdges());
+  const auto& edge = graph.GetEdge(0);
+  EXPECT_EQ(0, edge.node_0);
+  EXPECT_EQ(1, edge.node_1);
+  EXPECT_EQ(6, edge.length);
+  const Pos* cells = graph.CorridorCells(0);
+  EXPECT_THAT(std::vector<Pos>(cells, cells + edge.length - 1),
+              ElementsAre(Pos{1, 2}, Pos{1, 1}, Pos{2, 1}, Pos{3, 1},
+                          Pos{3, 2}));
+  EXPECT_EQ(1, graph.NumEdgesAt(0));
+  EXPECT_EQ(0, graph.EdgesAt(1)[0]);
+
+  EXPECT_EQ(1, graph.NodeAt({3, 3}));
+  EXPECT_EQ(-1, graph.NodeAt({1, 1}));
+  EXPECT_EQ(0, graph.EdgeAt({1, 1}));
+  EXPECT_EQ(-1, graph.EdgeAt({0, 0}));
+
+  EXPECT_EQ(6, graph.Distance({1, 3}, {3, 3}));
+  EXPECT_EQ(3, graph.Distance({3, 2}, {1, 1}));
+  EXPECT_EQ(0, graph.Distance({2, 1}, {2, 1}));
+  EXPECT_EQ(-1, graph.Distance({0, 0}, {2, 1}));
+  EXPECT_THAT(graph.ShortestPath({1, 2}, {3, 3}),
+              ElementsAre(Pos{1, 2}, Pos{1, 1}, Pos{2, 1}, Pos{3, 1},
+                          Pos{3, 2}, Pos{3, 3}));
+  EXPECT_THAT(graph.ShortestPath({3, 1}, {1, 1}),
+              ElementsAre(Pos{3, 1}, Pos{2, 1}, Pos{1, 1}));
+}
+
+TEST(JunctionGraphTest, Loops) {
+  const JunctionGraph graph(FromCharGrid(CharGrid("*******\n"
+                                                  "*  *  *\n"
+                                                  "*  *  *\n"
+                                                  "*******\n")),
+                            TextMaze::kEntityLayer, {'*'});
+  ASSERT_EQ(2, graph.NumNodes());
+  EXPECT_EQ((Pos{1, 1}), graph.NodeCell(0));
+  EXPECT_EQ((Pos{1, 4}), graph.NodeCell(1));
+  ASSERT_EQ(2, graph.NumEdges());
+  EXPECT_EQ(0, graph.GetEdge(0).node_0);
+  EXPECT_EQ(0, graph.GetEdge(0).node_1);
+  EXPECT_EQ(4, graph.GetEdge(0).length);
+  EXPECT_EQ(2, graph.NumEdgesAt(0));
+
+  EXPECT_EQ(2, graph.Distance({1, 2}, {2, 1}));
+  EXPECT_EQ(1, graph.Distance({2, 1}, {1, 1}));
+  EXPECT_EQ(-1, graph.Distance({1, 1}, {1, 4}));
+  EXPECT_THAT(graph.ShortestPath({1, 5}, {2, 4}),
+              ElementsAre(Pos{1, 5}, Pos{2, 5}, Pos{2, 4}));
+  EXPECT_TRUE(graph.ShortestPath({1, 1}, {1, 5}).empty());
+}
+
+TEST(JunctionGraphTest, MatchesFloodFill) {
+  RandomMazeParams params;
+  params.height = 31;
+  params.width = 41;
+  params.max_rooms = 6;
+  params.extra_connection_probability = 0.1;
+  std::mt19937_64 rng(1);
+  for (bool simplify : {false, true}) {
+    params.simplify = simplify;
+    for (int seed = 0; seed < 4; ++seed) {
+      const RandomMaze random_maze(params, seed);
+      const TextMaze& maze = random_maze.Maze();
+      const JunctionGraph graph(maze, TextMaze::kEntityLayer, {'*'});
+      std::uniform_int_distribution<> row(0, params.height - 1);
+      std::uniform_int_distribution<> col(0, params.width - 1);
+      for (int k = 0; k < 20; ++k) {
+        const Pos goal = {row(rng), col(rng)};
+        const FloodFill fill(maze, TextMaze::kEntityLayer, goal, {'*'});
+        maze.Area().Visit([&](int i, int j) {
+          const int distance = fill.DistanceFrom({i, j});
+          ASSERT_EQ(distance, graph.Distance({i, j}, goal))
+              << "from " << i << ", " << j << " to " << goal.row << ", "
+              << goal.col;
+          const auto path = graph.ShortestPath({i, j}, goal);
+          ASSERT_EQ(distance + 1, static_cast<int>(path.size()));
+          if (path.empty()) {
+            return;
+          }
+          EXPECT_EQ((Pos{i, j}), path.front());
+          EXPECT_EQ(goal, path.back());
+          for (std::size_t step = 1; step < path.size(); ++step) {
+            EXPECT_EQ(1, std::abs(path[step].row - path[step - 1].row) +
+                             std::abs(path[step].col - path[step - 1].col));
+            EXPECT_EQ(distance - static_cast<int>(step),
+                      fill.DistanceFrom(path[step]));
+          }
+        });
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,122 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/local_flood_fill.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace deepmind {
+namespace labmaze {
+
+LocalFloodFill::LocalFloodFill(const std::vector<char>& wall_chars)
+    : is_wall_(internal::MakeCharBoolMap(wall_chars)) {}
+
+void LocalFloodFill::Reserve(int radius, int area) {
+  // At most 2r(r + 1) + 1 cells are within r steps. Keeping the table at most
+  // half full keeps probes short.
+  const std::int64_t r = std::min(std::max(radius, 0), area);
+  const std::int64_t max_cells =
+      std::min<std::int64_t>(2 * r * (r + 1) + 1, area);
+  const auto min_size = static_cast<std::size_t>(2 * max_cells);
+  std::size_t size = 16;
+  int size_bits = 4;
+  while (size < min_size) {
+    size *= 2;
+    ++size_bits;
+  }
+  if (slot_epochs_.size() < size) {
+    hash_shift_ = 64 - size_bits;
+    slot_epochs_.assign(size, 0);
+    slot_keys_.resize(size);
+    slot_distances_.resize(size);
+    epoch_ = 0;
+  }
+}
+
+bool LocalFloodFill::Insert(int key, int distance) {
+  const int mask = static_cast<int>(slot_epochs_.size()) - 1;
+  for (int slot = HomeSlot(key);; slot = (slot + 1) & mask) {
+    if (slot_epochs_[slot] != epoch_) {
+      slot_epochs_[slot] = epoch_;
+      slot_keys_[slot] = key;
+      slot_distances_[slot] = distance;
+      return true;
+    }
+    if (slot_keys_[slot] == key) {
+      return false;
+    }
+  }
+}
+
+int LocalFloodFill::DistanceTo(Pos pos) const {
+  if (cells_.empty() || pos.row < 0 || pos.col < 0 || pos.col >= width_) {
+    return -1;
+  }
+  const int key = pos.row * width_ + pos.col;
+  const int mask = static_cast<int>(slot_epochs_.size()) - 1;
+  for (int slot = HomeSlot(key); slot_epochs_[slot] == epoch_;
+       slot = (slot + 1) & mask) {
+    if (slot_keys_[slot] == key) {
+      return slot_distances_[slot];
+    }
+  }
+  return -1;
+}
+
+bool LocalFloodFill::Fill(const TextMaze& maze, TextMaze::Layer layer,
+                          Pos start, int radius) {
+  cells_.clear();
+  offsets_.assign(1, 0);
+  if (!maze.Area().InBounds(start) ||
+      is_wall_[static_cast<unsigned char>(maze.GetCell(layer, start))]) {
+    return false;
+  }
+  const Rectangle& area = maze.Area();
+  width_ = area.size.width;
+  Reserve(radius, area.Area());
+  if (++epoch_ == 0) {
+    std::fill(slot_epochs_.begin(), slot_epochs_.end(), 0);
+    epoch_ = 1;
+  }
+
+  Insert(start.row * width_ + start.col, 0);
+  cells_.push_back(start);
+  offsets_.push_back(1);
+  for (int distance = 1; distance <= radius; ++distance) {
+    const int begin = offsets_[distance - 1];
+    const int end = offsets_[distance];
+    for (int k = begin; k < end; ++k) {
+      // A copy, since cells_ grows while the neighbours are visited.
+      const Pos cell = cells_[k];
+      area.VisitNeighbours(cell, [&](int i, int j) {
+        const char c = maze.GetCell(layer, {i, j});
+        if (!is_wall_[static_cast<unsigned char>(c)] &&
+            Insert(i * width_ + j, distance)) {
+          cells_.push_back({i, j});
+        }
+      });
+    }
+    if (static_cast<int>(cells_.size()) == end) {
+      break;
+    }
+    offsets_.push_back(cells_.size());
+  }
+  return true;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,90 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Flood fills limited to a small neighbourhood of a cell.
+
+#ifndef LABMAZE_CC_LOCAL_FLOOD_FILL_H_
+#define LABMAZE_CC_LOCAL_FLOOD_FILL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Finds the cells within a number of steps of a cell, without reading or
+// allocating anything for the rest of the maze. Visited cells are kept in an
+// open-addressing hash set sized for the radius and stamped with the fill
+// they belong to, so it is allocated once and never cleared: a fill of radius
+// r costs O(r^2) however large the maze. Reuse one object for repeated fills.
+class LocalFloodFill {
+ public:
+  // Cells whose character is in 'wall_chars' cannot be entered.
+  explicit LocalFloodFill(const std::vector<char>& wall_chars);
+
+  // Fills from 'start' over the cells of 'layer' of 'maze' up to 'radius'
+  // steps away. Returns false, and finds no cells, if 'start' is out of bounds
+  // or a wall.
+  bool Fill(const TextMaze& maze, TextMaze::Layer layer, Pos start,
+            int radius);
+
+  // The largest distance of a cell found, which is at most the radius, or -1
+  // if none were.
+  int MaxDistance() const { return static_cast<int>(offsets_.size()) - 2; }
+
+  // The cells found, in order of distance from 'start'.
+  const std::vector<Pos>& Cells() const { return cells_; }
+
+  // Cells()[CellsBegin(d)] to Cells()[CellsBegin(d + 1) - 1] are the cells
+  // at distance 'd', for d from 0 to MaxDistance().
+  int CellsBegin(int distance) const { return offsets_[distance]; }
+
+  // Returns the distance of 'pos' found by the last fill, or -1 if it was not
+  // found within the radius.
+  int DistanceTo(Pos pos) const;
+
+ private:
+  // Adds the cell with row-major index 'key' at 'distance' unless present.
+  // Returns whether it was added.
+  bool Insert(int key, int distance);
+
+  // Returns the slot where the probe for 'key' starts, by Fibonacci hashing.
+  int HomeSlot(int key) const {
+    return static_cast<int>((static_cast<std::uint64_t>(key) *
+                             0x9E3779B97F4A7C15u) >>
+                            hash_shift_);
+  }
+
+  // Sizes the table for fills of 'radius' on mazes of 'area' cells.
+  void Reserve(int radius, int area);
+
+  internal::CharBoolMap is_wall_;
+  int width_ = 0;
+  int hash_shift_ = 64;
+  unsigned int epoch_ = 0;
+  std::vector<unsigned int> slot_epochs_;
+  std::vector<int> slot_keys_;
+  std::vector<int> slot_distances_;
+  std::vector<Pos> cells_;
+  std::vector<int> offsets_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_LOCAL_FLOOD_FILL_H_
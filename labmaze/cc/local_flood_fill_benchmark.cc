@@ -0,0 +1,86 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares finding the cells within a radius of a cell by a LocalFloodFill
+// and by a FloodFill of the whole maze.
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/benchmark_util.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/local_flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns open cells of 'maze' to fill from.
+std::vector<Pos> MakeStarts(const TextMaze& maze) {
+  std::mt19937_64 rng(2);
+  const int size = maze.Area().size.height;
+  std::uniform_int_distribution<> coordinate(0, size - 1);
+  std::vector<Pos> starts;
+  while (starts.size() < 256) {
+    const Pos pos = {coordinate(rng), coordinate(rng)};
+    if (maze.GetCell(TextMaze::kEntityLayer, pos) != '*') {
+      starts.push_back(pos);
+    }
+  }
+  return starts;
+}
+
+// The cells within state.range(1) steps of a cell of a maze state.range(0)
+// cells square.
+void BM_LocalFloodFill(benchmark::State& state) {
+  const TextMaze maze = MakeNoiseMaze(state.range(0));
+  const auto starts = MakeStarts(maze);
+  LocalFloodFill fill({'*'});
+  std::size_t k = 0;
+  for (auto _ : state) {
+    fill.Fill(maze, TextMaze::kEntityLayer, starts[k], state.range(1));
+    benchmark::DoNotOptimize(fill.Cells().data());
+    if (++k == starts.size()) k = 0;
+  }
+}
+BENCHMARK(BM_LocalFloodFill)
+    ->ArgNames({"size", "radius"})
+    ->Args({101, 10})
+    ->Args({1001, 10})
+    ->Args({1001, 30})
+    ->Unit(benchmark::kMicrosecond);
+
+// As BM_LocalFloodFill, with a FloodFill of the whole maze.
+void BM_FloodFill(benchmark::State& state) {
+  const TextMaze maze = MakeNoiseMaze(state.range(0));
+  const auto starts = MakeStarts(maze);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const FloodFill fill(maze, TextMaze::kEntityLayer, starts[k], {'*'});
+    benchmark::DoNotOptimize(fill.DistanceFrom(starts[k]));
+    if (++k == starts.size()) k = 0;
+  }
+}
+BENCHMARK(BM_FloodFill)
+    ->ArgNames({"size"})
+    ->Arg(101)
+    ->Arg(1001)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,139 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/local_flood_fill.h"
+
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+
+// Returns the cells of 'fill' at 'distance'.
+std::vector<Pos> CellsAt(const LocalFloodFill& fill, int distance) {
+  return std::vector<Pos>(fill.Cells().begin() + fill.CellsBegin(distance),
+                          fill.Cells().begin() + fill.CellsBegin(distance + 1));
+}
+
+TEST(LocalFloodFillTest, GroupsByDistance) {
+  const TextMaze maze = FromCharGrid(CharGrid("*****\n"
+                                              "*   *\n"
+                                              "* * *\n"
+                                              "*   *\n"
+                                              "*****\n"));
+  LocalFloodFill fill({'*'});
+  ASSERT_TRUE(fill.Fill(maze, TextMaze::kEntityLayer, {1, 1}, 3));
+  EXPECT_EQ(3, fill.MaxDistance());
+  EXPECT_THAT(CellsAt(fill, 0), UnorderedElementsAre(Pos{1, 1}));
+  EXPECT_THAT(CellsAt(fill, 1), UnorderedElementsAre(Pos{2, 1}, Pos{1, 2}));
+  EXPECT_THAT(CellsAt(fill, 2), UnorderedElementsAre(Pos{3, 1}, Pos{1, 3}));
+  EXPECT_THAT(CellsAt(fill, 3), UnorderedElementsAre(Pos{3, 2}, Pos{2, 3}));
+  EXPECT_EQ(7u, fill.Cells().size());
+  EXPECT_EQ(2, fill.DistanceTo({1, 3}));
+  EXPECT_EQ(-1, fill.DistanceTo({3, 3}));  // Beyond the radius.
+  EXPECT_EQ(-1, fill.DistanceTo({2, 2}));  // A wall.
+  EXPECT_EQ(-1, fill.DistanceTo({9, 9}));
+
+  // The fill stops early once no more cells are reachable.
+  ASSERT_TRUE(fill.Fill(maze, TextMaze::kEntityLayer, {3, 3}, 100));
+  EXPECT_EQ(4, fill.MaxDistance());
+  EXPECT_EQ(8u, fill.Cells().size());
+  EXPECT_EQ(4, fill.DistanceTo({1, 1}));
+  EXPECT_EQ(-1, fill.DistanceTo({1, 0}));
+
+  ASSERT_TRUE(fill.Fill(maze, TextMaze::kEntityLayer, {3, 3}, 0));
+  EXPECT_EQ(0, fill.MaxDistance());
+  EXPECT_THAT(fill.Cells(), UnorderedElementsAre(Pos{3, 3}));
+  EXPECT_EQ(-1, fill.DistanceTo({1, 1}));
+}
+
+TEST(LocalFloodFillTest, InvalidStart) {
+  const TextMaze maze = FromCharGrid(CharGrid(" *\n"));
+  LocalFloodFill fill({'*'});
+  ASSERT_TRUE(fill.Fill(maze, TextMaze::kEntityLayer, {0, 0}, 2));
+  EXPECT_FALSE(fill.Fill(maze, TextMaze::kEntityLayer, {0, 1}, 2));
+  EXPECT_EQ(-1, fill.MaxDistance());
+  EXPECT_TRUE(fill.Cells().empty());
+  EXPECT_EQ(-1, fill.DistanceTo({0, 0}));
+  EXPECT_FALSE(fill.Fill(maze, TextMaze::kEntityLayer, {1, 0}, 2));
+}
+
+TEST(LocalFloodFillTest, MatchesFloodFill) {
+  std::mt19937_64 rng(1);
+  LocalFloodFill local({'*'});
+  for (int seed = 0; seed < 3; ++seed) {
+    RandomMazeParams params;
+    params.height = 41 + 10 * seed;
+    params.width = 61;
+    params.max_rooms = 6;
+    params.extra_connection_probability = 0.3;
+    const TextMaze maze = RandomMaze(params, seed).Maze();
+    std::uniform_int_distribution<> row(0, params.height - 1);
+    std::uniform_int_distribution<> col(0, params.width - 1);
+    for (int query = 0; query < 100; ++query) {
+      const Pos start = {row(rng), col(rng)};
+      const int radius = query % 20;
+      const FloodFill fill(maze, TextMaze::kEntityLayer, start, {'*'});
+      if (!local.Fill(maze, TextMaze::kEntityLayer, start, radius)) {
+        EXPECT_EQ(-1, fill.DistanceFrom(start));
+        continue;
+      }
+      int expected_cells = 0;
+      fill.Visit([&](int i, int j, int distance) {
+        if (distance <= radius) ++expected_cells;
+        EXPECT_EQ(distance <= radius ? distance : -1, local.DistanceTo({i, j}));
+      });
+      ASSERT_EQ(expected_cells, static_cast<int>(local.Cells().size()));
+      for (int distance = 0; distance <= local.MaxDistance(); ++distance) {
+        for (int k = local.CellsBegin(distance);
+             k < local.CellsBegin(distance + 1); ++k) {
+          EXPECT_EQ(distance, fill.DistanceFrom(local.Cells()[k]));
+        }
+      }
+    }
+  }
+}
+
+TEST(LocalFloodFillTest, SpawnsNearDoors) {
+  const TextMaze maze = FromCharGrid(CharGrid("*********\n"
+                                              "*   *   *\n"
+                                              "*P  D  P*\n"
+                                              "*   *  P*\n"
+                                              "*********\n"));
+  LocalFloodFill fill({'*'});
+  ASSERT_TRUE(fill.Fill(maze, TextMaze::kEntityLayer, {2, 4}, 3));
+  std::vector<Pos> spawns;
+  for (const Pos& cell : fill.Cells()) {
+    if (maze.GetCell(TextMaze::kEntityLayer, cell) == 'P') {
+      spawns.push_back(cell);
+    }
+  }
+  EXPECT_THAT(spawns, UnorderedElementsAre(Pos{2, 1}, Pos{2, 7}));
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,127 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/maze_cache.h"
+
+#include <utility>
+
+#include "labmaze/cc/algorithm.h"
+
+namespace deepmind {
+namespace labmaze {
+
+std::shared_ptr<const CachedMaze> MakeCachedMaze(const MazeCacheKey& key) {
+  RandomMaze random_maze(key.params, key.seed);
+  const TextMaze& maze = random_maze.Maze();
+  const std::vector<char> wall_chars = {'*'};
+  const char object_token = key.params.object_token[0];
+
+  std::vector<Pos> goals;
+  maze.Visit(TextMaze::kEntityLayer,
+             [&goals, object_token](int i, int j, char c) {
+               if (c == object_token) goals.push_back({i, j});
+             });
+  std::vector<FloodFill> goal_distances;
+  goal_distances.reserve(goals.size());
+  for (const auto& goal : goals) {
+    goal_distances.emplace_back(maze, TextMaze::kEntityLayer, goal, wall_chars);
+  }
+  auto rooms = FindRooms(maze, wall_chars);
+
+  const std::size_t num_cells = maze.Area().Area();
+  std::size_t byte_size = sizeof(CachedMaze);
+  // RandomMaze releases the id layer once generation is done.
+  byte_size += 2 * (num_cells + maze.Area().size.height);
+  for (const auto& room : rooms) {
+    byte_size += sizeof(room) + room.size() * sizeof(Pos);
+  }
+  byte_size += goals.size() * sizeof(Pos);
+  // Each distance field holds a distance per cell, border included, and at
+  // most one connected position per cell.
+  const std::size_t num_bordered_cells =
+      (maze.Area().size.height + 2) * (maze.Area().size.width + 2);
+  byte_size += goal_distances.size() *
+               (sizeof(FloodFill) + num_bordered_cells * sizeof(int) +
+                num_cells * sizeof(Pos));
+
+  return std::make_shared<const CachedMaze>(
+      CachedMaze{maze, std::move(rooms), std::move(goals),
+                 std::move(goal_distances), byte_size});
+}
+
+double MazeCache::Stats::HitRate() const {
+  const auto lookups = hits + misses;
+  return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+}
+
+MazeCache::MazeCache(std::size_t byte_budget) : byte_budget_(byte_budget) {}
+
+std::shared_ptr<const CachedMaze> MazeCache::Get(
+    const RandomMazeParams& params, std::mt19937_64::result_type seed) {
+  MazeCacheKey key{params, seed};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+    ++misses_;
+  }
+
+  auto result = MakeCachedMaze(key);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Another thread generated the same maze in the meantime.
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+  if (result->byte_size > byte_budget_) {
+    return result;
+  }
+  lru_.emplace_front(std::move(key), result);
+  index_.emplace(lru_.front().first, lru_.begin());
+  bytes_ += result->byte_size;
+  EvictLocked();
+  return result;
+}
+
+void MazeCache::EvictLocked() {
+  while (bytes_ > byte_budget_ && !lru_.empty()) {
+    const auto& entry = lru_.back();
+    bytes_ -= entry.second->byte_size;
+    index_.erase(entry.first);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+MazeCache::Stats MazeCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {hits_, misses_, evictions_, lru_.size(), bytes_};
+}
+
+void MazeCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
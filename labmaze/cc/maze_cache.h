@@ -0,0 +1,123 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#ifndef LABMAZE_CC_MAZE_CACHE_H_
+#define LABMAZE_CC_MAZE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Identifies the first maze generated by a RandomMaze constructed from
+// 'params' and 'seed'.
+struct MazeCacheKey {
+  RandomMazeParams params;
+  std::mt19937_64::result_type seed;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const MazeCacheKey& key) {
+    return H::combine(std::move(h), key.params, key.seed);
+  }
+
+  friend bool operator==(const MazeCacheKey& lhs, const MazeCacheKey& rhs) {
+    return lhs.seed == rhs.seed && lhs.params == rhs.params;
+  }
+};
+
+// An immutable generated maze together with its analysis results. Walls are
+// the '*' cells of the entity layer.
+struct CachedMaze {
+  TextMaze maze;
+
+  // Result of FindRooms on 'maze'.
+  std::vector<std::vector<Pos>> rooms;
+
+  // Positions of the object tokens in row-major order, and the distance field
+  // to each of them.
+  std::vector<Pos> goals;
+  std::vector<FloodFill> goal_distances;
+
+  // Approximate memory held by this entry, charged against the cache budget.
+  std::size_t byte_size;
+};
+
+// Generates a RandomMaze from 'key' and computes its analysis results.
+std::shared_ptr<const CachedMaze> MakeCachedMaze(const MazeCacheKey& key);
+
+// Thread-safe least-recently-used cache of generated mazes, bounded by the
+// total byte_size of the entries it retains. Generation happens outside the
+// lock, so concurrent misses on different keys do not serialize.
+class MazeCache {
+ public:
+  struct Stats {
+    std::int64_t hits;
+    std::int64_t misses;
+    std::int64_t evictions;
+    std::size_t entries;
+    std::size_t bytes;
+
+    // Returns hits / (hits + misses), or 0 if there have been no lookups.
+    double HitRate() const;
+  };
+
+  explicit MazeCache(std::size_t byte_budget);
+
+  MazeCache(const MazeCache&) = delete;
+  MazeCache& operator=(const MazeCache&) = delete;
+
+  // Returns the maze for 'params' and 'seed', generating it on a miss. Entries
+  // larger than the whole budget are returned but not retained.
+  std::shared_ptr<const CachedMaze> Get(
+      const RandomMazeParams& params, std::mt19937_64::result_type seed);
+
+  Stats GetStats() const;
+
+  // Drops all entries. Counters are kept.
+  void Clear();
+
+ private:
+  using Entry = std::pair<MazeCacheKey, std::shared_ptr<const CachedMaze>>;
+
+  // Evicts least-recently-used entries until 'bytes_' fits in the budget.
+  // Requires 'mutex_' to be held.
+  void EvictLocked();
+
+  const std::size_t byte_budget_;
+  mutable std::mutex mutex_;
+  std::list<Entry> lru_;  // Most recently used at the front.
+  absl::flat_hash_map<MazeCacheKey, std::list<Entry>::iterator> index_;
+  std::size_t bytes_ = 0;
+  std::int64_t hits_ = 0;
+  std::int64_t misses_ = 0;
+  std::int64_t evictions_ = 0;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_MAZE_CACHE_H_
@@ -0,0 +1,118 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/maze_cache.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "labmaze/cc/random_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+RandomMazeParams TestParams() {
+  RandomMazeParams params;
+  params.height = 15;
+  params.width = 17;
+  params.objects_per_room = 1;
+  return params;
+}
+
+TEST(MazeCacheTest, MatchesRandomMaze) {
+  MazeCache cache(1 << 20);
+  auto cached = cache.Get(TestParams(), 7);
+  RandomMaze maze(TestParams(), 7);
+  EXPECT_EQ(maze.EntityLayer(), cached->maze.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(maze.VariationsLayer(),
+            cached->maze.Text(TextMaze::kVariationsLayer));
+  EXPECT_EQ(FindRooms(maze.Maze(), {'*'}).size(), cached->rooms.size());
+  ASSERT_EQ(cached->goals.size(), cached->goal_distances.size());
+  for (std::size_t i = 0; i < cached->goals.size(); ++i) {
+    EXPECT_EQ(0, cached->goal_distances[i].DistanceFrom(cached->goals[i]));
+  }
+}
+
+TEST(MazeCacheTest, HitsAndMisses) {
+  MazeCache cache(1 << 20);
+  auto first = cache.Get(TestParams(), 1);
+  auto second = cache.Get(TestParams(), 1);
+  auto other = cache.Get(TestParams(), 2);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_NE(first.get(), other.get());
+
+  auto params = TestParams();
+  params.simplify = false;
+  EXPECT_NE(first.get(), cache.Get(params, 1).get());
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(3, stats.misses);
+  EXPECT_EQ(0, stats.evictions);
+  EXPECT_EQ(3, stats.entries);
+  EXPECT_DOUBLE_EQ(0.25, stats.HitRate());
+}
+
+TEST(MazeCacheTest, EvictsLeastRecentlyUsed) {
+  const std::size_t entry_size = MakeCachedMaze({TestParams(), 1})->byte_size;
+  MazeCache cache(entry_size * 2 + entry_size / 2);
+  auto first = cache.Get(TestParams(), 1);
+  cache.Get(TestParams(), 2);
+  cache.Get(TestParams(), 1);
+  cache.Get(TestParams(), 3);  // Evicts seed 2.
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(1, stats.evictions);
+  EXPECT_EQ(2, stats.entries);
+  EXPECT_LE(stats.bytes, entry_size * 2 + entry_size / 2);
+
+  EXPECT_EQ(first.get(), cache.Get(TestParams(), 1).get());
+  EXPECT_EQ(2, cache.GetStats().hits);
+  cache.Get(TestParams(), 2);
+  EXPECT_EQ(4, cache.GetStats().misses);
+}
+
+TEST(MazeCacheTest, EntryLargerThanBudgetIsNotRetained) {
+  MazeCache cache(1);
+  auto maze = cache.Get(TestParams(), 1);
+  ASSERT_NE(nullptr, maze);
+  EXPECT_EQ(0, cache.GetStats().entries);
+  EXPECT_EQ(0, cache.GetStats().bytes);
+}
+
+TEST(MazeCacheTest, ConcurrentLookups) {
+  MazeCache cache(1 << 24);
+  constexpr int kNumThreads = 4;
+  constexpr int kNumSeeds = 8;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&cache] {
+      for (int seed = 0; seed < kNumSeeds; ++seed) {
+        cache.Get(TestParams(), seed);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(kNumThreads * kNumSeeds, stats.hits + stats.misses);
+  EXPECT_EQ(kNumSeeds, stats.entries);
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
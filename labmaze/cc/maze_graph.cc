@@ -0,0 +1,159 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/maze_graph.h"
+
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/parallel_for.h"
+
+namespace deepmind {
+namespace labmaze {
+MazeGraph::MazeGraph(const TextMaze& maze, TextMaze::Layer layer,
+                     const std::vector<char>& wall_chars,
+                     const MazeGraphFeatures& features)
+    : MazeGraph(std::vector<const TextMaze*>{&maze}, layer, wall_chars,
+                features, 1) {}
+
+MazeGraph::MazeGraph(const std::vector<const TextMaze*>& mazes,
+                     TextMaze::Layer layer,
+                     const std::vector<char>& wall_chars,
+                     const MazeGraphFeatures& features, int num_threads) {
+  const auto& sources = features.distance_sources;
+  CHECK(sources.empty() || sources.size() == mazes.size())
+      << "Need one distance source per maze.";
+  const int num_graphs = mazes.size();
+  cell_offsets_.assign(num_graphs + 1, 0);
+  for (int k = 0; k < num_graphs; ++k) {
+    cell_offsets_[k + 1] = cell_offsets_[k] + mazes[k]->Area().Area();
+  }
+  cell_nodes_.resize(cell_offsets_.back());
+
+  // First pass: number the open cells of each maze from 0 and count the
+  // edges between them.
+  const auto is_wall = internal::MakeCharBoolMap(wall_chars);
+  std::vector<int> num_edges(num_graphs);
+  graph_offsets_.assign(num_graphs + 1, 0);
+  internal::ParallelFor(num_graphs, num_threads, [&](int k) {
+    const int width = mazes[k]->Area().size.width;
+    int* nodes = &cell_nodes_[cell_offsets_[k]];
+    int num_nodes = 0;
+    int edges = 0;
+    mazes[k]->VisitRows(layer, [&](int i, int, const char* cells, int count) {
+      int* row = nodes + i * width;
+      for (int j = 0; j < count; ++j) {
+        if (is_wall[static_cast<unsigned char>(cells[j])]) {
+          row[j] = -1;
+          continue;
+        }
+        row[j] = num_nodes++;
+        edges += 2 * ((j > 0 && row[j - 1] >= 0) +
+                      (i > 0 && row[j - width] >= 0));
+      }
+    });
+    graph_offsets_[k + 1] = num_nodes;
+    num_edges[k] = edges;
+  });
+
+  std::vector<int> edge_offsets(num_graphs + 1, 0);
+  for (int k = 0; k < num_graphs; ++k) {
+    graph_offsets_[k + 1] += graph_offsets_[k];
+    edge_offsets[k + 1] = edge_offsets[k] + num_edges[k];
+  }
+  row_offsets_.resize(NumNodes() + 1);
+  row_offsets_.back() = edge_offsets.back();
+  neighbours_.resize(NumEdges());
+  node_cells_.resize(NumNodes());
+  if (features.variations) {
+    node_variations_.resize(NumNodes());
+  }
+  if (features.directions) {
+    edge_directions_.resize(NumEdges());
+  }
+  if (!sources.empty()) {
+    node_distances_.assign(NumNodes(), -1);
+  }
+
+  // Second pass: store the edges and features of each maze, and renumber its
+  // cells by their global node numbers.
+  internal::ParallelFor(num_graphs, num_threads, [&](int k) {
+    const TextMaze& maze = *mazes[k];
+    const Size& size = maze.Area().size;
+    const int first_node = graph_offsets_[k];
+    int* nodes = &cell_nodes_[cell_offsets_[k]];
+    int edge = edge_offsets[k];
+    const auto add_edge = [this, first_node, &edge](int node,
+                                                    Direction direction) {
+      neighbours_[edge] = first_node + node;
+      if (!edge_directions_.empty()) {
+        edge_directions_[edge] = direction;
+      }
+      ++edge;
+    };
+    for (int i = 0; i < size.height; ++i) {
+      const int* row = nodes + i * size.width;
+      for (int j = 0; j < size.width; ++j) {
+        if (row[j] < 0) {
+          continue;
+        }
+        const int node = first_node + row[j];
+        node_cells_[node] = {i, j};
+        row_offsets_[node] = edge;
+        if (i > 0 && row[j - size.width] >= 0) {
+          add_edge(row[j - size.width], kUp);
+        }
+        if (j > 0 && row[j - 1] >= 0) {
+          add_edge(row[j - 1], kLeft);
+        }
+        if (j + 1 < size.width && row[j + 1] >= 0) {
+          add_edge(row[j + 1], kRight);
+        }
+        if (i + 1 < size.height && row[j + size.width] >= 0) {
+          add_edge(row[j + size.width], kDown);
+        }
+      }
+    }
+    const int area = size.height * size.width;
+    for (int cell = 0; cell < area; ++cell) {
+      if (nodes[cell] >= 0) {
+        nodes[cell] += first_node;
+      }
+    }
+
+    if (!node_variations_.empty()) {
+      maze.VisitRows(TextMaze::kVariationsLayer,
+                     [this, nodes, &size](int i, int, const char* cells,
+                                          int count) {
+                       const int* row = nodes + i * size.width;
+                       for (int j = 0; j < count; ++j) {
+                         if (row[j] >= 0) {
+                           node_variations_[row[j]] = cells[j];
+                         }
+                       }
+                     });
+    }
+    if (!sources.empty() && maze.Area().InBounds(sources[k])) {
+      const FloodFill fill(maze, layer, sources[k], wall_chars);
+      fill.Visit([this, nodes, &size](int i, int j, int distance) {
+        node_distances_[nodes[i * size.width + j]] = distance;
+      });
+    }
+  });
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,105 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Export of mazes as graphs in compressed sparse row (CSR) form.
+
+#ifndef LABMAZE_CC_MAZE_GRAPH_H_
+#define LABMAZE_CC_MAZE_GRAPH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "labmaze/cc/direction.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Optional features of the nodes and edges of a MazeGraph.
+struct MazeGraphFeatures {
+  // Whether to store the variations layer character of each node.
+  bool variations = false;
+  // Whether to store the direction of each edge.
+  bool directions = false;
+  // Either empty, or one cell per maze from which to store the FloodFill
+  // distance of each node of that maze.
+  std::vector<Pos> distance_sources;
+};
+
+// The open cells of one or more mazes as a graph whose nodes are the cells and
+// whose edges join neighbouring cells both ways. Nodes are numbered in
+// row-major order of their cells, maze after maze, and the edges are stored
+// in CSR form: the neighbours of node n are
+// Neighbours()[RowOffsets()[n]] to Neighbours()[RowOffsets()[n + 1] - 1], in
+// ascending order. A graph of several mazes is the disjoint union of their
+// graphs, as batched by graph neural network libraries.
+class MazeGraph {
+ public:
+  // Builds the graph of the cells of 'layer' of 'maze' that are not in
+  // 'wall_chars'.
+  MazeGraph(const TextMaze& maze, TextMaze::Layer layer,
+            const std::vector<char>& wall_chars,
+            const MazeGraphFeatures& features = MazeGraphFeatures());
+
+  // Builds the graph of all of 'mazes' on up to 'num_threads' threads, or all
+  // cores if 'num_threads' is 0.
+  MazeGraph(const std::vector<const TextMaze*>& mazes, TextMaze::Layer layer,
+            const std::vector<char>& wall_chars,
+            const MazeGraphFeatures& features = MazeGraphFeatures(),
+            int num_threads = 0);
+
+  int NumGraphs() const { return static_cast<int>(graph_offsets_.size()) - 1; }
+  int NumNodes() const { return graph_offsets_.back(); }
+  int NumEdges() const { return row_offsets_.back(); }
+
+  // The nodes of maze k are GraphOffsets()[k] to GraphOffsets()[k + 1] - 1.
+  const std::vector<int>& GraphOffsets() const { return graph_offsets_; }
+
+  const std::vector<int>& RowOffsets() const { return row_offsets_; }
+  const std::vector<int>& Neighbours() const { return neighbours_; }
+
+  // The cell of each node within its maze.
+  const std::vector<Pos>& NodeCells() const { return node_cells_; }
+
+  // The node of each cell, or -1 for walls. Cells are in row-major order,
+  // with those of maze k starting at CellOffsets()[k].
+  const std::vector<int>& CellOffsets() const { return cell_offsets_; }
+  const std::vector<int>& CellNodes() const { return cell_nodes_; }
+
+  // The features requested on construction, or empty vectors. Distances are
+  // -1 for nodes that cannot reach the source of their maze. Edge directions
+  // are Direction values, from a node to its neighbour.
+  const std::vector<char>& NodeVariations() const { return node_variations_; }
+  const std::vector<int>& NodeDistances() const { return node_distances_; }
+  const std::vector<std::uint8_t>& EdgeDirections() const {
+    return edge_directions_;
+  }
+
+ private:
+  std::vector<int> graph_offsets_;
+  std::vector<int> row_offsets_;
+  std::vector<int> neighbours_;
+  std::vector<Pos> node_cells_;
+  std::vector<int> cell_offsets_;
+  std::vector<int> cell_nodes_;
+  std::vector<char> node_variations_;
+  std::vector<int> node_distances_;
+  std::vector<std::uint8_t> edge_directions_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_MAZE_GRAPH_H_
@@ -0,0 +1,96 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Cost of exporting single mazes and batches of mazes as CSR graphs.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/maze_graph.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns the features enabled by 'enabled'.
+MazeGraphFeatures Features(bool enabled, int num_mazes) {
+  MazeGraphFeatures features;
+  if (enabled) {
+    features.variations = true;
+    features.directions = true;
+    features.distance_sources.assign(num_mazes, Pos{1, 1});
+  }
+  return features;
+}
+
+// Exports a maze of state.range(0) cells square, with all features if
+// state.range(1) is non-zero.
+void BM_Single(benchmark::State& state) {
+  RandomMazeParams params;
+  params.height = state.range(0);
+  params.width = state.range(0);
+  params.max_rooms = state.range(0) / 4;
+  params.simplify = false;
+  const TextMaze maze = RandomMaze(params, 1).Maze();
+  const MazeGraphFeatures features = Features(state.range(1) != 0, 1);
+  for (auto _ : state) {
+    const MazeGraph graph(maze, TextMaze::kEntityLayer, {'*'}, features);
+    benchmark::DoNotOptimize(graph.Neighbours().data());
+  }
+  state.SetItemsProcessed(state.iterations() * maze.Area().Area());
+}
+BENCHMARK(BM_Single)
+    ->ArgNames({"size", "features"})
+    ->Args({101, 0})
+    ->Args({101, 1})
+    ->Args({1001, 0})
+    ->Args({1001, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+// Exports a batch of 512 default-sized mazes on state.range(1) threads, with
+// all features if state.range(0) is non-zero.
+void BM_Batch(benchmark::State& state) {
+  std::vector<TextMaze> mazes;
+  std::vector<const TextMaze*> maze_ptrs;
+  RandomMazeParams params;
+  params.height = 31;
+  params.width = 31;
+  for (int seed = 0; seed < 512; ++seed) {
+    mazes.push_back(RandomMaze(params, seed).Maze());
+  }
+  for (const TextMaze& maze : mazes) {
+    maze_ptrs.push_back(&maze);
+  }
+  const MazeGraphFeatures features =
+      Features(state.range(0) != 0, mazes.size());
+  for (auto _ : state) {
+    const MazeGraph graph(maze_ptrs, TextMaze::kEntityLayer, {'*'}, features,
+                          state.range(1));
+    benchmark::DoNotOptimize(graph.Neighbours().data());
+  }
+  state.SetItemsProcessed(state.iterations() * mazes.size());
+}
+BENCHMARK(BM_Batch)
+    ->ArgNames({"features", "threads"})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({1, 4})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
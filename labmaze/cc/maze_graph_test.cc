@@ -0,0 +1,140 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/maze_graph.h"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/direction.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(MazeGraphTest, Structure) {
+  const MazeGraph graph(FromCharGrid(CharGrid(" * \n"
+                                              "   \n")),
+                        TextMaze::kEntityLayer, {'*'});
+  EXPECT_EQ(1, graph.NumGraphs());
+  EXPECT_EQ(5, graph.NumNodes());
+  EXPECT_EQ(8, graph.NumEdges());
+  EXPECT_THAT(graph.GraphOffsets(), ElementsAre(0, 5));
+  EXPECT_THAT(graph.RowOffsets(), ElementsAre(0, 1, 2, 4, 6, 8));
+  EXPECT_THAT(graph.Neighbours(), ElementsAre(2, 4, 0, 3, 2, 4, 1, 3));
+  EXPECT_THAT(graph.NodeCells(), ElementsAre(Pos{0, 0}, Pos{0, 2}, Pos{1, 0},
+                                             Pos{1, 1}, Pos{1, 2}));
+  EXPECT_THAT(graph.CellOffsets(), ElementsAre(0, 6));
+  EXPECT_THAT(graph.CellNodes(), ElementsAre(0, -1, 1, 2, 3, 4));
+  EXPECT_THAT(graph.NodeVariations(), IsEmpty());
+  EXPECT_THAT(graph.NodeDistances(), IsEmpty());
+  EXPECT_THAT(graph.EdgeDirections(), IsEmpty());
+}
+
+TEST(MazeGraphTest, Features) {
+  MazeGraphFeatures features;
+  features.variations = true;
+  features.directions = true;
+  features.distance_sources = {{0, 2}};
+  const MazeGraph graph(FromCharGrid(CharGrid(" * \n"
+                                              "   \n"),
+                                     CharGrid("A.B\n"
+                                              "..C\n")),
+                        TextMaze::kEntityLayer, {'*'}, features);
+  EXPECT_THAT(graph.NodeVariations(), ElementsAre('A', 'B', '.', '.', 'C'));
+  EXPECT_THAT(graph.NodeDistances(), ElementsAre(4, 0, 3, 2, 1));
+  EXPECT_THAT(graph.EdgeDirections(),
+              ElementsAre(kDown, kDown, kUp, kRight, kLeft, kRight, kUp,
+                          kLeft));
+}
+
+TEST(MazeGraphTest, BatchMatchesSingleMazes) {
+  std::vector<TextMaze> mazes;
+  for (int seed = 0; seed < 5; ++seed) {
+    RandomMazeParams params;
+    params.height = 11 + 4 * seed;
+    params.width = 31 - 2 * seed;
+    params.max_rooms = 3;
+    mazes.push_back(RandomMaze(params, seed).Maze());
+  }
+  std::vector<const TextMaze*> maze_ptrs;
+  MazeGraphFeatures features;
+  features.variations = true;
+  features.directions = true;
+  for (const TextMaze& maze : mazes) {
+    maze_ptrs.push_back(&maze);
+    features.distance_sources.push_back({1, 1});
+  }
+  // An out of bounds source leaves all distances of its maze at -1.
+  features.distance_sources[2] = {-1, 0};
+  const MazeGraph batch(maze_ptrs, TextMaze::kEntityLayer, {'*'}, features, 3);
+  ASSERT_EQ(5, batch.NumGraphs());
+
+  int num_edges = 0;
+  for (int k = 0; k < batch.NumGraphs(); ++k) {
+    MazeGraphFeatures single_features = features;
+    single_features.distance_sources = {features.distance_sources[k]};
+    const MazeGraph single(mazes[k], TextMaze::kEntityLayer, {'*'},
+                           single_features);
+    const int first_node = batch.GraphOffsets()[k];
+    ASSERT_EQ(single.NumNodes(), batch.GraphOffsets()[k + 1] - first_node);
+    const FloodFill fill(mazes[k], TextMaze::kEntityLayer, {1, 1}, {'*'});
+    for (int node = 0; node < single.NumNodes(); ++node) {
+      const int batch_node = first_node + node;
+      ASSERT_EQ(single.NodeCells()[node], batch.NodeCells()[batch_node]);
+      EXPECT_EQ(single.NodeVariations()[node],
+                batch.NodeVariations()[batch_node]);
+      const int distance =
+          k == 2 ? -1 : fill.DistanceFrom(single.NodeCells()[node]);
+      EXPECT_EQ(distance, single.NodeDistances()[node]);
+      EXPECT_EQ(distance, batch.NodeDistances()[batch_node]);
+      const int degree =
+          single.RowOffsets()[node + 1] - single.RowOffsets()[node];
+      ASSERT_EQ(degree, batch.RowOffsets()[batch_node + 1] -
+                            batch.RowOffsets()[batch_node]);
+      for (int d = 0; d < degree; ++d) {
+        const int edge = single.RowOffsets()[node] + d;
+        const int batch_edge = batch.RowOffsets()[batch_node] + d;
+        EXPECT_EQ(first_node + single.Neighbours()[edge],
+                  batch.Neighbours()[batch_edge]);
+        EXPECT_EQ(single.EdgeDirections()[edge],
+                  batch.EdgeDirections()[batch_edge]);
+      }
+    }
+    num_edges += single.NumEdges();
+
+    const int first_cell = batch.CellOffsets()[k];
+    ASSERT_EQ(mazes[k].Area().Area(), batch.CellOffsets()[k + 1] - first_cell);
+    for (int cell = 0; cell < mazes[k].Area().Area(); ++cell) {
+      const int node = single.CellNodes()[cell];
+      EXPECT_EQ(node < 0 ? -1 : first_node + node,
+                batch.CellNodes()[first_cell + cell]);
+    }
+  }
+  EXPECT_EQ(num_edges, batch.NumEdges());
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
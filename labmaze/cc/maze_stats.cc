@@ -0,0 +1,187 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/maze_stats.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/connected_components.h"
+#include "labmaze/cc/parallel_for.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Flags of the cells in the grid of ComputeStats. A cell without kOpen is a
+// wall. Each kind of region a cell may belong to has a flag of its own for
+// the search that counts the region.
+enum CellFlags : std::uint8_t {
+  kOpen = 1,
+  kObject = 2,
+  kCorridor = 4,
+  kReachedOpen = 8,
+  kReachedCorridor = 16,
+};
+
+// Searches breadth-first from 'start' over the cells of 'cells' that have
+// flag 'kind' but not 'reached', and sets 'reached' on them. 'start' shall be
+// such a cell. Returns the number of cells reached. If 'object_distance' is
+// not null, stores in it the distance to the nearest object, or -1 if none is
+// reached.
+int ReachRegion(int start, std::uint8_t kind, std::uint8_t reached,
+                BorderedGrid<std::uint8_t>* cells, std::vector<int>* queue,
+                int* object_distance) {
+  auto& grid = *cells;
+  const std::array<int, 4> offsets = grid.NeighbourOffsets();
+  const std::uint8_t mask = kind | reached;
+  grid[start] |= reached;
+  queue->assign(1, start);
+  // The cells of 'queue' from 'head' up to 'level_end' are at 'distance'.
+  std::size_t level_end = 1;
+  int distance = 0;
+  for (std::size_t head = 0; head < queue->size(); ++head) {
+    if (head == level_end) {
+      level_end = queue->size();
+      ++distance;
+    }
+    const int cell = (*queue)[head];
+    if (object_distance != nullptr && *object_distance < 0 &&
+        (grid[cell] & kObject)) {
+      *object_distance = distance;
+    }
+    for (int offset : offsets) {
+      const int neighbour = cell + offset;
+      if ((grid[neighbour] & mask) == kind) {
+        grid[neighbour] |= reached;
+        queue->push_back(neighbour);
+      }
+    }
+  }
+  return static_cast<int>(queue->size());
+}
+
+}  // namespace
+
+MazeStats ComputeStats(const TextMaze& maze,
+                       const std::vector<char>& wall_chars, char spawn_token,
+                       char object_token) {
+  MazeStats stats;
+  const Rectangle& area = maze.Area();
+  if (area.Area() == 0) {
+    return stats;
+  }
+
+  // First pass: the open cells, spawn points and objects.
+  const auto is_wall = internal::MakeCharBoolMap(wall_chars);
+  BorderedGrid<std::uint8_t> cells(area.size, 0, 0);
+  int spawn = -1;
+  maze.VisitRows(TextMaze::kEntityLayer, [&](int i, int j, const char* row,
+                                             int count) {
+    std::uint8_t* flags = &cells[cells.Index(i, j)];
+    for (int k = 0; k < count; ++k) {
+      if (is_wall[static_cast<unsigned char>(row[k])]) continue;
+      flags[k] = kOpen;
+      ++stats.open_cells;
+      if (row[k] == object_token) {
+        flags[k] |= kObject;
+      } else if (row[k] == spawn_token && spawn < 0) {
+        spawn = cells.Index(i, j + k);
+      }
+    }
+  });
+  stats.wall_density =
+      1.0 - static_cast<double>(stats.open_cells) / area.Area();
+
+  // Rooms are those of FindRooms, so that the definitions cannot drift.
+  const ConnectedComponents rooms = FindRoomComponents(maze, wall_chars, 1);
+  stats.rooms = rooms.NumComponents();
+  stats.room_cells = static_cast<int>(rooms.cells.size());
+
+  // Second pass: the neighbours of every open cell, which classify it. Cells
+  // are classified with arithmetic rather than branches, which the layout of
+  // a maze makes hard to predict.
+  const int stride = cells.stride();
+  const int width = area.size.width;
+  std::int64_t total_neighbours = 0;
+  for (int i = 0; i < area.size.height; ++i) {
+    const int* room_labels = &rooms.labels[i * width];
+    for (int j = 0; j < width; ++j) {
+      const int idx = cells.Index(i, j);
+      const int neighbours =
+          (cells[idx] & kOpen) *
+          ((cells[idx - stride] & kOpen) + (cells[idx + stride] & kOpen) +
+           (cells[idx - 1] & kOpen) + (cells[idx + 1] & kOpen));
+      const int room = room_labels[j] >= 0;
+      total_neighbours += neighbours;
+      stats.dead_ends += neighbours == 1;
+      stats.junctions += (1 - room) & (neighbours >= 3);
+      cells[idx] |= ((1 - room) & (neighbours == 2)) * kCorridor;
+    }
+  }
+  if (stats.open_cells > 0) {
+    stats.branching_factor =
+        static_cast<double>(total_neighbours) / stats.open_cells - 1.0;
+  }
+
+  // Third pass: the regions of each kind, each counted from its first cell in
+  // row-major order. The component of the spawn point is searched first, which
+  // also finds the distance to the nearest object.
+  std::vector<int> queue;
+  if (spawn >= 0) {
+    stats.largest_component = ReachRegion(spawn, kOpen, kReachedOpen, &cells,
+                                          &queue, &stats.spawn_goal_distance);
+    stats.components = 1;
+  }
+  for (int i = 0; i < area.size.height; ++i) {
+    for (int j = 0; j < area.size.width; ++j) {
+      const int idx = cells.Index(i, j);
+      const std::uint8_t flags = cells[idx];
+      if ((flags & (kOpen | kReachedOpen)) == kOpen) {
+        stats.largest_component = std::max(
+            stats.largest_component,
+            ReachRegion(idx, kOpen, kReachedOpen, &cells, &queue, nullptr));
+        ++stats.components;
+      }
+      if ((flags & (kCorridor | kReachedCorridor)) == kCorridor) {
+        const int length = ReachRegion(idx, kCorridor, kReachedCorridor,
+                                       &cells, &queue, nullptr);
+        if (static_cast<int>(stats.corridor_lengths.size()) <= length) {
+          stats.corridor_lengths.resize(length + 1, 0);
+        }
+        ++stats.corridor_lengths[length];
+      }
+    }
+  }
+  return stats;
+}
+
+std::vector<MazeStats> ComputeStats(const std::vector<const TextMaze*>& mazes,
+                                    const std::vector<char>& wall_chars,
+                                    char spawn_token, char object_token,
+                                    int num_threads) {
+  std::vector<MazeStats> result(mazes.size());
+  internal::ParallelFor(mazes.size(), num_threads, [&](int k) {
+    result[k] = ComputeStats(*mazes[k], wall_chars, spawn_token, object_token);
+  });
+  return result;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
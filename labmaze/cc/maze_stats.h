@@ -0,0 +1,71 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Summary statistics of mazes, for sorting generated mazes by difficulty.
+
+#ifndef LABMAZE_CC_MAZE_STATS_H_
+#define LABMAZE_CC_MAZE_STATS_H_
+
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Statistics of the entity layer of a maze.
+struct MazeStats {
+  // Number of open cells, and the fraction of all cells that are walls.
+  int open_cells = 0;
+  double wall_density = 0;
+  // Open cells with exactly one open neighbour.
+  int dead_ends = 0;
+  // Open cells outside rooms with three or more open neighbours.
+  int junctions = 0;
+  // corridor_lengths[n] is the number of corridors of n cells. A corridor is
+  // a maximal chain of open cells outside rooms that have exactly two open
+  // neighbours each.
+  std::vector<int> corridor_lengths;
+  // Number of rooms, as found by FindRooms, and of cells in them.
+  int rooms = 0;
+  int room_cells = 0;
+  // Number of connected components of open cells, and cells in the largest.
+  int components = 0;
+  int largest_component = 0;
+  // Distance from the first spawn point in row-major order to the nearest
+  // object, or -1 if there is no spawn point, no object or no route.
+  int spawn_goal_distance = -1;
+  // Mean number of open neighbours of open cells less one: the mean number of
+  // ways on from a cell entered.
+  double branching_factor = 0;
+};
+
+// Computes the statistics of 'maze', whose cells in 'wall_chars' are walls
+// and whose spawn points and objects are 'spawn_token' and 'object_token'.
+MazeStats ComputeStats(const TextMaze& maze,
+                       const std::vector<char>& wall_chars, char spawn_token,
+                       char object_token);
+
+// Computes the statistics of each of 'mazes' on up to 'num_threads' threads,
+// or all cores if 'num_threads' is 0.
+std::vector<MazeStats> ComputeStats(const std::vector<const TextMaze*>& mazes,
+                                    const std::vector<char>& wall_chars,
+                                    char spawn_token, char object_token,
+                                    int num_threads = 0);
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_MAZE_STATS_H_
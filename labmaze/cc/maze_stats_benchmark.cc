@@ -0,0 +1,91 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Measures ComputeStats against the generation of the mazes it summarises.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/maze_stats.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Simplification is left out: it dominates the generation of large mazes.
+RandomMazeParams MakeParams(int size) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = size / 8;
+  params.extra_connection_probability = 0.05;
+  params.spawns_per_room = 1;
+  params.objects_per_room = 1;
+  params.simplify = false;
+  return params;
+}
+
+// Statistics of a maze state.range(0) cells square.
+void BM_ComputeStats(benchmark::State& state) {
+  const TextMaze maze = RandomMaze(MakeParams(state.range(0)), 1).Maze();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ComputeStats(maze, {'*'}, 'P', 'G'));
+  }
+}
+BENCHMARK(BM_ComputeStats)
+    ->Arg(21)
+    ->Arg(101)
+    ->Arg(1001)
+    ->Unit(benchmark::kMicrosecond);
+
+// Generation of the mazes of BM_ComputeStats.
+void BM_RandomMaze(benchmark::State& state) {
+  const RandomMazeParams params = MakeParams(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RandomMaze(params, 1));
+  }
+}
+BENCHMARK(BM_RandomMaze)
+    ->Arg(21)
+    ->Arg(101)
+    ->Arg(1001)
+    ->Unit(benchmark::kMicrosecond);
+
+// Statistics of a batch of state.range(0) mazes 21 cells square on
+// state.range(1) threads.
+void BM_ComputeStatsBatch(benchmark::State& state) {
+  std::vector<TextMaze> mazes;
+  for (int seed = 0; seed < state.range(0); ++seed) {
+    mazes.push_back(RandomMaze(MakeParams(21), seed).Maze());
+  }
+  std::vector<const TextMaze*> maze_ptrs;
+  for (const auto& maze : mazes) maze_ptrs.push_back(&maze);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        ComputeStats(maze_ptrs, {'*'}, 'P', 'G', state.range(1)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComputeStatsBatch)
+    ->ArgNames({"mazes", "threads"})
+    ->Args({1024, 1})
+    ->Args({1024, 4})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
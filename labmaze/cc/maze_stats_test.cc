@@ -0,0 +1,179 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+
+#include "labmaze/cc/maze_stats.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::ElementsAre;
+
+TEST(MazeStatsTest, Corridor) {
+  const TextMaze maze = FromCharGrid(CharGrid("*****\n"
+                                              "*  P*\n"
+                                              "* ***\n"
+                                              "*  G*\n"
+                                              "*****\n"));
+  const MazeStats stats = ComputeStats(maze, {'*'}, 'P', 'G');
+  EXPECT_EQ(7, stats.open_cells);
+  EXPECT_THAT(stats.wall_density, DoubleEq(18.0 / 25));
+  EXPECT_EQ(2, stats.dead_ends);
+  EXPECT_EQ(0, stats.junctions);
+  EXPECT_THAT(stats.corridor_lengths, ElementsAre(0, 0, 0, 0, 0, 1));
+  EXPECT_EQ(0, stats.rooms);
+  EXPECT_EQ(0, stats.room_cells);
+  EXPECT_EQ(1, stats.components);
+  EXPECT_EQ(7, stats.largest_component);
+  EXPECT_EQ(6, stats.spawn_goal_distance);
+  EXPECT_THAT(stats.branching_factor, DoubleEq(12.0 / 7 - 1));
+}
+
+TEST(MazeStatsTest, RoomAndJunctions) {
+  const TextMaze maze = FromCharGrid(CharGrid("*********\n"
+                                              "*   *   *\n"
+                                              "*   * * *\n"
+                                              "*     * *\n"
+                                              "***** * *\n"
+                                              "*G      *\n"
+                                              "*********\n"
+                                              "* *******\n"));
+  const MazeStats stats = ComputeStats(maze, {'*'}, 'P', 'G');
+  EXPECT_EQ(1, stats.rooms);
+  EXPECT_EQ(9, stats.room_cells);
+  // The goal is a dead end; the isolated cell at the bottom is not.
+  EXPECT_EQ(1, stats.dead_ends);
+  EXPECT_EQ(2, stats.junctions);
+  EXPECT_THAT(stats.corridor_lengths,
+              ElementsAre(0, 2, 0, 1, 0, 0, 0, 0, 0, 1));
+  EXPECT_EQ(2, stats.components);
+  EXPECT_EQ(26, stats.largest_component);
+  // No spawn point.
+  EXPECT_EQ(-1, stats.spawn_goal_distance);
+}
+
+TEST(MazeStatsTest, AllWalls) {
+  const TextMaze maze = FromCharGrid(CharGrid("***\n"
+                                              "***\n"));
+  const MazeStats stats = ComputeStats(maze, {'*'}, 'P', 'G');
+  EXPECT_EQ(0, stats.open_cells);
+  EXPECT_THAT(stats.wall_density, DoubleEq(1.0));
+  EXPECT_EQ(0, stats.components);
+  EXPECT_EQ(0, stats.largest_component);
+  EXPECT_TRUE(stats.corridor_lengths.empty());
+  EXPECT_THAT(stats.branching_factor, DoubleEq(0.0));
+}
+
+// Checks the statistics of generated mazes against counts made cell by cell.
+TEST(MazeStatsTest, MatchesCellCounts) {
+  for (int seed = 0; seed < 5; ++seed) {
+    RandomMazeParams params;
+    params.height = 31;
+    params.width = 41;
+    params.extra_connection_probability = 0.1;
+    params.simplify = seed % 2 == 0;
+    params.spawns_per_room = 1;
+    params.objects_per_room = 1;
+    const TextMaze maze = RandomMaze(params, seed).Maze();
+    const MazeStats stats = ComputeStats(maze, {'*'}, 'P', 'G');
+
+    const auto rooms = FindRooms(maze, {'*'});
+    std::set<std::pair<int, int>> room_cells;
+    for (const auto& room : rooms) {
+      for (const Pos& pos : room) room_cells.insert({pos.row, pos.col});
+    }
+    const auto is_open = [&maze](Pos pos) {
+      return maze.Area().InBounds(pos) &&
+             maze.GetCell(TextMaze::kEntityLayer, pos) != '*';
+    };
+    int open_cells = 0, dead_ends = 0, junctions = 0, corridor_cells = 0;
+    maze.Area().Visit([&](int i, int j) {
+      if (!is_open({i, j})) return;
+      ++open_cells;
+      int neighbours = 0;
+      maze.Area().VisitNeighbours(
+          {i, j}, [&](int ni, int nj) { neighbours += is_open({ni, nj}); });
+      dead_ends += neighbours == 1;
+      if (room_cells.count({i, j}) == 0) {
+        junctions += neighbours >= 3;
+        corridor_cells += neighbours == 2;
+      }
+    });
+    EXPECT_EQ(open_cells, stats.open_cells);
+    EXPECT_EQ(dead_ends, stats.dead_ends);
+    EXPECT_EQ(junctions, stats.junctions);
+    int counted_corridor_cells = 0;
+    for (std::size_t n = 0; n < stats.corridor_lengths.size(); ++n) {
+      counted_corridor_cells += n * stats.corridor_lengths[n];
+    }
+    EXPECT_EQ(corridor_cells, counted_corridor_cells);
+    EXPECT_EQ(static_cast<int>(rooms.size()), stats.rooms);
+    EXPECT_EQ(static_cast<int>(room_cells.size()), stats.room_cells);
+
+    // Generated mazes are connected.
+    EXPECT_EQ(1, stats.components);
+    EXPECT_EQ(open_cells, stats.largest_component);
+
+    Pos spawn = {-1, -1};
+    maze.Visit(TextMaze::kEntityLayer, [&spawn](int i, int j, char c) {
+      if (c == 'P' && spawn.row < 0) spawn = {i, j};
+    });
+    ASSERT_GE(spawn.row, 0);
+    const FloodFill fill(maze, TextMaze::kEntityLayer, 'G', {'*'});
+    EXPECT_EQ(fill.DistanceFrom(spawn), stats.spawn_goal_distance);
+    EXPECT_GT(stats.spawn_goal_distance, 0);
+  }
+}
+
+TEST(MazeStatsTest, Batch) {
+  std::vector<TextMaze> mazes;
+  for (int seed = 0; seed < 7; ++seed) {
+    RandomMazeParams params;
+    params.height = 21;
+    params.width = 21;
+    mazes.push_back(RandomMaze(params, seed).Maze());
+  }
+  std::vector<const TextMaze*> maze_ptrs;
+  for (const auto& maze : mazes) maze_ptrs.push_back(&maze);
+  const std::vector<MazeStats> batch =
+      ComputeStats(maze_ptrs, {'*'}, 'P', 'G', 3);
+  ASSERT_EQ(mazes.size(), batch.size());
+  for (std::size_t k = 0; k < mazes.size(); ++k) {
+    const MazeStats stats = ComputeStats(mazes[k], {'*'}, 'P', 'G');
+    EXPECT_EQ(stats.open_cells, batch[k].open_cells);
+    EXPECT_EQ(stats.dead_ends, batch[k].dead_ends);
+    EXPECT_EQ(stats.corridor_lengths, batch[k].corridor_lengths);
+    EXPECT_EQ(stats.rooms, batch[k].rooms);
+    EXPECT_EQ(stats.spawn_goal_distance, batch[k].spawn_goal_distance);
+  }
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
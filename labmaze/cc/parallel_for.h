@@ -0,0 +1,65 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Running work on several threads.
+
+#ifndef LABMAZE_CC_PARALLEL_FOR_H_
+#define LABMAZE_CC_PARALLEL_FOR_H_
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace deepmind {
+namespace labmaze {
+namespace internal {
+
+// Returns 'num_threads' if positive, or else the number of hardware threads.
+inline int ResolveNumThreads(int num_threads) {
+  return num_threads > 0
+             ? num_threads
+             : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls f(k) for each k in [0, count) on up to 'num_threads' threads, or on
+// up to ResolveNumThreads(num_threads) threads if 'num_threads' is not
+// positive. One of them is the calling thread. Values are dealt out in turn,
+// which spreads large and small items across threads; with as many threads as
+// values, f(k) runs on thread k, so 'f' may keep per-thread state by looping
+// over its own share.
+template <typename F>
+void ParallelFor(int count, int num_threads, const F& f) {
+  num_threads = std::max(1, std::min(ResolveNumThreads(num_threads), count));
+  const auto run = [count, num_threads, &f](int thread) {
+    for (int k = thread; k < count; k += num_threads) {
+      f(k);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int thread = 1; thread < num_threads; ++thread) {
+    threads.emplace_back(run, thread);
+  }
+  run(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace internal
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_PARALLEL_FOR_H_
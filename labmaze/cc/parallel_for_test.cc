@@ -0,0 +1,62 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/parallel_for.h"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace internal {
+namespace {
+
+TEST(ParallelForTest, CallsEachValueOnce) {
+  for (int num_threads : {-1, 0, 1, 3, 20}) {
+    std::vector<std::atomic<int>> calls(10);
+    ParallelFor(calls.size(), num_threads, [&calls](int k) { ++calls[k]; });
+    for (const auto& count : calls) {
+      EXPECT_EQ(1, count.load()) << "num_threads: " << num_threads;
+    }
+  }
+  ParallelFor(0, 4, [](int) { ADD_FAILURE() << "Called with no values."; });
+}
+
+TEST(ParallelForTest, OneThreadPerValue) {
+  std::vector<std::thread::id> ids(4);
+  ParallelFor(ids.size(), ids.size(),
+              [&ids](int k) { ids[k] = std::this_thread::get_id(); });
+  EXPECT_EQ(std::this_thread::get_id(), ids[0]);
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    for (std::size_t j = i + 1; j < ids.size(); ++j) {
+      EXPECT_NE(ids[i], ids[j]);
+    }
+  }
+}
+
+TEST(ParallelForTest, ResolveNumThreads) {
+  EXPECT_EQ(3, ResolveNumThreads(3));
+  EXPECT_GE(ResolveNumThreads(0), 1);
+  EXPECT_EQ(ResolveNumThreads(0), ResolveNumThreads(-2));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,59 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/policy_field.h"
+
+namespace deepmind {
+namespace labmaze {
+
+PolicyField::PolicyField(const FloodFill& fill, bool with_ties,
+                         std::mt19937_64* rng)
+    : area_(fill.Area()), directions_((area_.Area() + 3) / 4, 0) {
+  if (with_ties) {
+    ties_.assign((area_.Area() + 1) / 2, 0);
+  }
+  fill.Visit([this, &fill, rng](int i, int j, int distance) {
+    if (distance == 0) {
+      return;
+    }
+    int ties = 0;
+    int num_ties = 0;
+    for (int direction = 0; direction < 4; ++direction) {
+      if (fill.DistanceFrom(Pos{i, j} + DirectionStep(direction)) ==
+          distance - 1) {
+        ties |= 1 << direction;
+        ++num_ties;
+      }
+    }
+    // Takes the pick-th optimal direction.
+    int pick = rng != nullptr && num_ties > 1
+                   ? std::uniform_int_distribution<>(0, num_ties - 1)(*rng)
+                   : 0;
+    int direction = 0;
+    for (;; ++direction) {
+      if ((ties & (1 << direction)) && pick-- == 0) {
+        break;
+      }
+    }
+    const int cell = CellIndex({i, j});
+    directions_[cell >> 2] |= direction << ((cell & 3) << 1);
+    if (!ties_.empty()) {
+      ties_[cell >> 1] |= ties << ((cell & 1) << 2);
+    }
+  });
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
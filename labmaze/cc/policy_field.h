@@ -0,0 +1,83 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compact fields of optimal actions towards a goal.
+
+#ifndef LABMAZE_CC_POLICY_FIELD_H_
+#define LABMAZE_CC_POLICY_FIELD_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "labmaze/cc/direction.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// The first step of a shortest path to the goal of a FloodFill from every
+// cell, packed into 2 bits per cell, and optionally the set of all such steps
+// in 4 bits per cell. Looking up an action is a shift and a mask, so expert
+// policies need not trace a path on every step.
+class PolicyField {
+ public:
+  // Builds the field of 'fill'. Stores the sets of optimal directions too if
+  // 'with_ties'. Where several directions are optimal, the direction field
+  // holds the first of them, or one picked uniformly with 'rng' if not null.
+  PolicyField(const FloodFill& fill, bool with_ties,
+              std::mt19937_64* rng = nullptr);
+
+  const Rectangle& Area() const { return area_; }
+
+  // Returns the direction of the first step of a shortest path from the
+  // in-bounds cell 'pos' to the goal. Meaningless for the goal and cells
+  // that cannot reach it, for which it is 0.
+  int GetDirection(Pos pos) const {
+    const int cell = CellIndex(pos);
+    return (directions_[cell >> 2] >> ((cell & 3) << 1)) & 3;
+  }
+
+  bool HasTies() const { return !ties_.empty(); }
+
+  // Returns the set of directions from the in-bounds cell 'pos' that start a
+  // shortest path to the goal, with direction d in bit d. The set is empty
+  // for the goal and cells that cannot reach it. Requires HasTies().
+  int GetTies(Pos pos) const {
+    const int cell = CellIndex(pos);
+    return (ties_[cell >> 1] >> ((cell & 1) << 2)) & 15;
+  }
+
+  // The packed fields. Cells are numbered in row-major order; cell k is in
+  // bits 2 * (k % 4) and up of directions byte k / 4, and in bits 4 * (k % 2)
+  // and up of ties byte k / 2.
+  const std::vector<std::uint8_t>& PackedDirections() const {
+    return directions_;
+  }
+  const std::vector<std::uint8_t>& PackedTies() const { return ties_; }
+
+ private:
+  int CellIndex(Pos pos) const { return pos.row * area_.size.width + pos.col; }
+
+  Rectangle area_;
+  std::vector<std::uint8_t> directions_;
+  std::vector<std::uint8_t> ties_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_POLICY_FIELD_H_
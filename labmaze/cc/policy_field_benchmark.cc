@@ -0,0 +1,91 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares the expert action from a PolicyField with tracing a shortest path
+// on every step, and times building fields.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/benchmark_util.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/policy_field.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns the open cells of 'maze' that reach the goal of 'fill', shuffled.
+std::vector<Pos> ReachableCells(const FloodFill& fill) {
+  std::vector<Pos> cells;
+  fill.Visit([&cells](int i, int j, int distance) {
+    if (distance > 0) cells.push_back({i, j});
+  });
+  std::shuffle(cells.begin(), cells.end(), std::mt19937_64(2));
+  return cells;
+}
+
+// One expert action from a PolicyField, on a maze of state.range(0) cells
+// square.
+void BM_PolicyFieldAction(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+  std::mt19937_64 rng(3);
+  const PolicyField field(fill, false, &rng);
+  const std::vector<Pos> cells = ReachableCells(fill);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(field.GetDirection(cells[k]));
+    if (++k == cells.size()) k = 0;
+  }
+}
+BENCHMARK(BM_PolicyFieldAction)->Arg(101)->Arg(1001);
+
+// As BM_PolicyFieldAction, tracing a shortest path for every action.
+void BM_ShortestPathAction(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+  std::mt19937_64 rng(3);
+  const std::vector<Pos> cells = ReachableCells(fill);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const std::vector<Pos> path = fill.ShortestPathFrom(cells[k], &rng);
+    benchmark::DoNotOptimize(path[1]);
+    if (++k == cells.size()) k = 0;
+  }
+}
+BENCHMARK(BM_ShortestPathAction)->Arg(101)->Arg(1001);
+
+// Building a field with tie sets and random tie-breaks.
+void BM_BuildPolicyField(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+  std::mt19937_64 rng(3);
+  for (auto _ : state) {
+    const PolicyField field(fill, true, &rng);
+    benchmark::DoNotOptimize(field.PackedDirections().data());
+  }
+}
+BENCHMARK(BM_BuildPolicyField)
+    ->Arg(101)
+    ->Arg(1001)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
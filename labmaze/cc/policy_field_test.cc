@@ -0,0 +1,118 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/policy_field.h"
+
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/direction.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(PolicyFieldTest, Packing) {
+  const TextMaze maze = FromCharGrid(CharGrid("   \n"
+                                              " * \n"
+                                              "   \n"));
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {2, 2}, {'*'});
+  const PolicyField field(fill, true);
+  EXPECT_TRUE(field.HasTies());
+  // Directions, row-major, with ties broken by the first direction:
+  //   D R D
+  //   D - D
+  //   R R -
+  EXPECT_EQ(kDown, field.GetDirection({0, 0}));
+  EXPECT_EQ(kRight, field.GetDirection({0, 1}));
+  EXPECT_EQ(kDown, field.GetDirection({1, 0}));
+  EXPECT_EQ(kRight, field.GetDirection({2, 1}));
+  EXPECT_EQ((1 << kDown) | (1 << kRight),
+            field.GetTies({0, 0}));
+  EXPECT_EQ(0, field.GetTies({1, 1}));
+  EXPECT_EQ(0, field.GetTies({2, 2}));
+  EXPECT_THAT(field.PackedDirections(),
+              ElementsAre(1 | 3 << 2 | 1 << 4 | 1 << 6,
+                          1 << 2 | 3 << 4 | 3 << 6, 0));
+  EXPECT_THAT(field.PackedTies(),
+              ElementsAre(10 | 8 << 4, 2 | 2 << 4, 0 | 2 << 4, 8 | 8 << 4,
+                          0));
+}
+
+TEST(PolicyFieldTest, FollowsShortestPaths) {
+  RandomMazeParams params;
+  params.height = 41;
+  params.width = 51;
+  params.max_rooms = 5;
+  params.extra_connection_probability = 0.2;
+  params.simplify = false;
+  const TextMaze maze = RandomMaze(params, 2).Maze();
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+  std::mt19937_64 rng(3);
+  const PolicyField first(fill, false);
+  const PolicyField random(fill, true, &rng);
+  EXPECT_FALSE(first.HasTies());
+  int num_differences = 0;
+  maze.Area().Visit([&](int i, int j) {
+    const int distance = fill.DistanceFrom({i, j});
+    int ties = 0;
+    if (distance > 0) {
+      for (int direction = 0; direction < 4; ++direction) {
+        if (fill.DistanceFrom(Pos{i, j} + DirectionStep(direction)) ==
+            distance - 1) {
+          ties |= 1 << direction;
+        }
+      }
+    }
+    EXPECT_EQ(ties, random.GetTies({i, j}));
+    if (ties == 0) {
+      EXPECT_EQ(0, first.GetDirection({i, j}));
+      EXPECT_EQ(0, random.GetDirection({i, j}));
+      return;
+    }
+    EXPECT_TRUE(ties & (1 << random.GetDirection({i, j})));
+    num_differences +=
+        first.GetDirection({i, j}) != random.GetDirection({i, j});
+    // The first optimal direction.
+    int direction = 0;
+    while (!(ties & (1 << direction))) {
+      ++direction;
+    }
+    EXPECT_EQ(direction, first.GetDirection({i, j}));
+
+    // Following either field reaches the goal in 'distance' steps.
+    for (const PolicyField* field : {&first, &random}) {
+      Pos pos = {i, j};
+      for (int step = 0; step < distance; ++step) {
+        pos = pos + DirectionStep(field->GetDirection(pos));
+      }
+      EXPECT_EQ((Pos{1, 1}), pos);
+    }
+  });
+  EXPECT_GT(num_differences, 0);
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
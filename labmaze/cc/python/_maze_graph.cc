@@ -0,0 +1,122 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/maze_graph.h"
+#include "labmaze/cc/text_maze.h"
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+#include "pybind11/pytypes.h"
+#include "pybind11/stl.h"
+
+namespace deepmind {
+namespace labmaze {
+
+namespace py = pybind11;
+
+namespace {
+
+// Returns a NumPy array that views 'data' and keeps 'owner' alive.
+template <typename T>
+py::array_t<T> ArrayView(const std::vector<T>& data, py::handle owner) {
+  return py::array_t<T>(data.size(), data.data(), owner);
+}
+
+}  // namespace
+
+PYBIND11_MODULE(_maze_graph, m) {
+  m.def(
+      "export_graphs",
+      [](const std::vector<std::string>& entity_layers,
+         const std::vector<std::string>& variations_layers,
+         const std::string& wall_chars, bool variations, bool directions,
+         const std::vector<std::pair<int, int>>& distance_sources,
+         int num_threads) {
+        if (variations_layers.size() != entity_layers.size()) {
+          throw py::value_error("Need one variations layer per maze.");
+        }
+        if (!distance_sources.empty() &&
+            distance_sources.size() != entity_layers.size()) {
+          throw py::value_error("Need one distance source per maze.");
+        }
+        MazeGraphFeatures features;
+        features.variations = variations;
+        features.directions = directions;
+        for (const auto& source : distance_sources) {
+          features.distance_sources.push_back({source.first, source.second});
+        }
+        std::unique_ptr<MazeGraph> graph;
+        {
+          py::gil_scoped_release release;
+          std::vector<TextMaze> mazes;
+          mazes.reserve(entity_layers.size());
+          std::vector<const TextMaze*> maze_ptrs;
+          for (std::size_t k = 0; k < entity_layers.size(); ++k) {
+            mazes.push_back(FromCharGrid(CharGrid(entity_layers[k]),
+                                         CharGrid(variations_layers[k])));
+            maze_ptrs.push_back(&mazes.back());
+          }
+          graph.reset(new MazeGraph(
+              maze_ptrs, TextMaze::kEntityLayer,
+              std::vector<char>(wall_chars.begin(), wall_chars.end()),
+              features, num_threads));
+        }
+
+        // The arrays share the memory of the graph, which lives as long as
+        // any of them.
+        const MazeGraph& g = *graph;
+        const py::capsule owner(graph.release(), [](void* graph) {
+          delete static_cast<MazeGraph*>(graph);
+        });
+        py::dict result;
+        result["graph_offsets"] = ArrayView(g.GraphOffsets(), owner);
+        result["row_offsets"] = ArrayView(g.RowOffsets(), owner);
+        result["neighbours"] = ArrayView(g.Neighbours(), owner);
+        result["node_cells"] = py::array_t<int>(
+            {static_cast<py::ssize_t>(g.NumNodes()), py::ssize_t{2}},
+            {static_cast<py::ssize_t>(sizeof(Pos)),
+             static_cast<py::ssize_t>(sizeof(int))},
+            reinterpret_cast<const int*>(g.NodeCells().data()), owner);
+        result["cell_offsets"] = ArrayView(g.CellOffsets(), owner);
+        result["cell_nodes"] = ArrayView(g.CellNodes(), owner);
+        if (variations) {
+          result["node_variations"] = py::array_t<std::uint8_t>(
+              g.NodeVariations().size(),
+              reinterpret_cast<const std::uint8_t*>(
+                  g.NodeVariations().data()),
+              owner);
+        }
+        if (directions) {
+          result["edge_directions"] = ArrayView(g.EdgeDirections(), owner);
+        }
+        if (!distance_sources.empty()) {
+          result["node_distances"] = ArrayView(g.NodeDistances(), owner);
+        }
+        return result;
+      },
+      py::arg("entity_layers"), py::arg("variations_layers"),
+      py::arg("wall_chars"), py::arg("variations"), py::arg("directions"),
+      py::arg("distance_sources"), py::arg("num_threads"));
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,129 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/maze_stats.h"
+#include "labmaze/cc/text_maze.h"
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+#include "pybind11/pytypes.h"
+#include "pybind11/stl.h"
+
+namespace deepmind {
+namespace labmaze {
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(_maze_stats, m) {
+  m.def(
+      "compute_stats",
+      [](const std::vector<std::string>& entity_layers,
+         const std::string& wall_chars, char spawn_token, char object_token,
+         int corridor_bins, int num_threads) {
+        if (corridor_bins < 1) {
+          throw py::value_error("corridor_bins shall be positive.");
+        }
+        const py::ssize_t num_mazes = entity_layers.size();
+        py::array_t<std::int32_t> open_cells(num_mazes);
+        py::array_t<double> wall_density(num_mazes);
+        py::array_t<std::int32_t> dead_ends(num_mazes);
+        py::array_t<std::int32_t> junctions(num_mazes);
+        py::array_t<std::int32_t> corridor_lengths(
+            {num_mazes, static_cast<py::ssize_t>(corridor_bins)});
+        py::array_t<std::int32_t> rooms(num_mazes);
+        py::array_t<std::int32_t> room_cells(num_mazes);
+        py::array_t<std::int32_t> components(num_mazes);
+        py::array_t<std::int32_t> largest_component(num_mazes);
+        py::array_t<std::int32_t> spawn_goal_distance(num_mazes);
+        py::array_t<double> branching_factor(num_mazes);
+        {
+          auto open_cells_view = open_cells.mutable_unchecked<1>();
+          auto wall_density_view = wall_density.mutable_unchecked<1>();
+          auto dead_ends_view = dead_ends.mutable_unchecked<1>();
+          auto junctions_view = junctions.mutable_unchecked<1>();
+          auto corridor_lengths_view = corridor_lengths.mutable_unchecked<2>();
+          auto rooms_view = rooms.mutable_unchecked<1>();
+          auto room_cells_view = room_cells.mutable_unchecked<1>();
+          auto components_view = components.mutable_unchecked<1>();
+          auto largest_component_view =
+              largest_component.mutable_unchecked<1>();
+          auto spawn_goal_distance_view =
+              spawn_goal_distance.mutable_unchecked<1>();
+          auto branching_factor_view = branching_factor.mutable_unchecked<1>();
+
+          py::gil_scoped_release release;
+          std::vector<TextMaze> mazes;
+          mazes.reserve(entity_layers.size());
+          std::vector<const TextMaze*> maze_ptrs;
+          for (const auto& entity_layer : entity_layers) {
+            mazes.push_back(FromCharGrid(CharGrid(entity_layer)));
+            maze_ptrs.push_back(&mazes.back());
+          }
+          const std::vector<MazeStats> stats =
+              ComputeStats(maze_ptrs,
+                           std::vector<char>(wall_chars.begin(),
+                                             wall_chars.end()),
+                           spawn_token, object_token, num_threads);
+          for (py::ssize_t k = 0; k < num_mazes; ++k) {
+            const MazeStats& s = stats[k];
+            open_cells_view(k) = s.open_cells;
+            wall_density_view(k) = s.wall_density;
+            dead_ends_view(k) = s.dead_ends;
+            junctions_view(k) = s.junctions;
+            // The last bin counts all corridors of corridor_bins - 1 cells or
+            // more.
+            for (int n = 0; n < corridor_bins; ++n) {
+              corridor_lengths_view(k, n) = 0;
+            }
+            for (int n = 0; n < static_cast<int>(s.corridor_lengths.size());
+                 ++n) {
+              corridor_lengths_view(k, std::min(n, corridor_bins - 1)) +=
+                  s.corridor_lengths[n];
+            }
+            rooms_view(k) = s.rooms;
+            room_cells_view(k) = s.room_cells;
+            components_view(k) = s.components;
+            largest_component_view(k) = s.largest_component;
+            spawn_goal_distance_view(k) = s.spawn_goal_distance;
+            branching_factor_view(k) = s.branching_factor;
+          }
+        }
+        py::dict result;
+        result["open_cells"] = open_cells;
+        result["wall_density"] = wall_density;
+        result["dead_ends"] = dead_ends;
+        result["junctions"] = junctions;
+        result["corridor_lengths"] = corridor_lengths;
+        result["rooms"] = rooms;
+        result["room_cells"] = room_cells;
+        result["components"] = components;
+        result["largest_component"] = largest_component;
+        result["spawn_goal_distance"] = spawn_goal_distance;
+        result["branching_factor"] = branching_factor;
+        return result;
+      },
+      py::arg("entity_layers"), py::arg("wall_chars"), py::arg("spawn_token"),
+      py::arg("object_token"), py::arg("corridor_bins"),
+      py::arg("num_threads"));
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,104 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/policy_field.h"
+#include "labmaze/cc/text_maze.h"
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+#include "pybind11/pytypes.h"
+#include "pybind11/stl.h"
+
+namespace deepmind {
+namespace labmaze {
+
+namespace py = pybind11;
+
+namespace {
+
+// Returns a NumPy array that views 'data' and keeps 'owner' alive.
+py::array_t<std::uint8_t> ArrayView(const std::vector<std::uint8_t>& data,
+                                    py::handle owner) {
+  return py::array_t<std::uint8_t>(data.size(), data.data(), owner);
+}
+
+}  // namespace
+
+PYBIND11_MODULE(_policy_field, m) {
+  m.def(
+      "policy_field",
+      [](const std::string& entity_layer, const std::pair<int, int>& goal,
+         const std::string& wall_chars, bool with_ties, bool random_ties,
+         int random_seed) {
+        std::unique_ptr<PolicyField> field;
+        {
+          py::gil_scoped_release release;
+          const TextMaze maze = FromCharGrid(CharGrid(entity_layer));
+          const FloodFill fill(
+              maze, TextMaze::kEntityLayer, {goal.first, goal.second},
+              std::vector<char>(wall_chars.begin(), wall_chars.end()));
+          std::mt19937_64 rng(random_seed);
+          field.reset(
+              new PolicyField(fill, with_ties, random_ties ? &rng : nullptr));
+        }
+
+        // Unpacked fields of one byte per cell, for direct indexing.
+        const Size size = field->Area().size;
+        py::array_t<std::uint8_t> directions({size.height, size.width});
+        py::array_t<std::uint8_t> ties;
+        if (with_ties) {
+          ties = py::array_t<std::uint8_t>({size.height, size.width});
+        }
+        auto directions_view = directions.mutable_unchecked<2>();
+        field->Area().Visit([&](int i, int j) {
+          directions_view(i, j) = field->GetDirection({i, j});
+        });
+        if (with_ties) {
+          auto ties_view = ties.mutable_unchecked<2>();
+          field->Area().Visit([&](int i, int j) {
+            ties_view(i, j) = field->GetTies({i, j});
+          });
+        }
+
+        // The packed arrays share the memory of the field, which lives as
+        // long as either of them.
+        const PolicyField& f = *field;
+        const py::capsule owner(field.release(), [](void* field) {
+          delete static_cast<PolicyField*>(field);
+        });
+        py::dict result;
+        result["directions"] = directions;
+        result["packed_directions"] = ArrayView(f.PackedDirections(), owner);
+        if (with_ties) {
+          result["ties"] = ties;
+          result["packed_ties"] = ArrayView(f.PackedTies(), owner);
+        }
+        return result;
+      },
+      py::arg("entity_layer"), py::arg("goal"), py::arg("wall_chars"),
+      py::arg("with_ties"), py::arg("random_ties"), py::arg("random_seed"));
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -14,8 +14,12 @@
 // ============================================================================
 
 #include <string>
+#include <utility>
 
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
 #include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/pytypes.h"
 
@@ -44,9 +48,71 @@ PYBIND11_MODULE(_random_maze, m) {
            py::arg("objects_per_room"),
            py::arg("object_token"),
            py::arg("random_seed"))
+      .def_static(
+          "restore",
+          [](int height, int width, int max_rooms, int room_min_size,
+             int room_max_size, int retry_count,
+             double extra_connection_probability, int max_variations,
+             bool has_doors, bool simplify, int spawns_per_room,
+             std::string spawn_token, int objects_per_room,
+             std::string object_token, const py::bytes& prng_state,
+             const std::string& entity_layer,
+             const std::string& variations_layer) {
+            const RandomMazeParams params{height,
+                                          width,
+                                          max_rooms,
+                                          room_min_size,
+                                          room_max_size,
+                                          retry_count,
+                                          extra_connection_probability,
+                                          max_variations,
+                                          has_doors,
+                                          simplify,
+                                          spawns_per_room,
+                                          std::move(spawn_token),
+                                          objects_per_room,
+                                          std::move(object_token)};
+            return RandomMaze::Restore(
+                params, prng_state,
+                FromCharGrid(CharGrid(entity_layer),
+                             CharGrid(variations_layer)));
+          },
+          py::arg("height"),
+          py::arg("width"),
+          py::arg("max_rooms"),
+          py::arg("room_min_size"),
+          py::arg("room_max_size"),
+          py::arg("retry_count"),
+          py::arg("extra_connection_probability"),
+          py::arg("max_variations"),
+          py::arg("has_doors"),
+          py::arg("simplify"),
+          py::arg("spawns_per_room"),
+          py::arg("spawn_token"),
+          py::arg("objects_per_room"),
+          py::arg("object_token"),
+          py::arg("prng_state"),
+          py::arg("entity_layer"),
+          py::arg("variations_layer"))
       .def("regenerate", &RandomMaze::Regenerate)
       .def_property_readonly("entity_layer", &RandomMaze::EntityLayer)
-      .def_property_readonly("variations_layer", &RandomMaze::VariationsLayer);
+      .def_property_readonly("variations_layer", &RandomMaze::VariationsLayer)
+      .def_property(
+          "prng_state",
+          [](const RandomMaze& maze) { return py::bytes(maze.PrngState()); },
+          [](RandomMaze& maze, const py::bytes& state) {
+            maze.SetPrngState(state);
+          })
+      .def_property_readonly("num_rooms", &RandomMaze::NumRooms)
+      .def_property_readonly("region_doors", [](const RandomMaze& maze) {
+        py::list doors;
+        for (const auto& door : maze.RegionDoors()) {
+          doors.append(py::make_tuple(
+              door.id_0, door.id_1, py::make_tuple(door.pos.row, door.pos.col),
+              py::make_tuple(door.direction.d_row, door.direction.d_col)));
+        }
+        return doors;
+      });
 }
 
 }  // namespace labmaze
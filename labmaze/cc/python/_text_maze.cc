@@ -0,0 +1,91 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <string>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/text_maze.h"
+#include "pybind11/pybind11.h"
+#include "pybind11/pytypes.h"
+
+namespace deepmind {
+namespace labmaze {
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(_text_maze, m) {
+  py::class_<TextMaze> text_maze_class(m, "TextMaze");
+  text_maze_class
+      .def(py::init([](const std::string& entity_layer,
+                       const std::string& variations_layer) {
+             return FromCharGrid(CharGrid(entity_layer),
+                                 CharGrid(variations_layer));
+           }),
+           py::arg("entity_layer"),
+           py::arg("variations_layer"))
+      .def_property_readonly("entity_layer",
+                             [](const TextMaze& maze) -> const std::string& {
+                               return maze.Text(TextMaze::kEntityLayer);
+                             })
+      .def_property_readonly("variations_layer",
+                             [](const TextMaze& maze) -> const std::string& {
+                               return maze.Text(TextMaze::kVariationsLayer);
+                             })
+      .def(
+          "diff",
+          [](const TextMaze& maze, const TextMaze& target) {
+            const Size& size = maze.Area().size;
+            const Size& target_size = target.Area().size;
+            if (size.height != target_size.height ||
+                size.width != target_size.width) {
+              throw py::value_error("Mazes have different extents.");
+            }
+            return py::bytes(maze.Diff(target));
+          },
+          py::arg("target"))
+      .def(
+          "apply_diff",
+          [](TextMaze* maze, const std::string& diff) {
+            if (!maze->ApplyDiff(diff)) {
+              throw py::value_error(
+                  "Malformed diff or diff for a maze of different extents.");
+            }
+          },
+          py::arg("diff"));
+
+  m.def(
+      "serialize",
+      [](const std::string& entity_layer, const std::string& variations_layer) {
+        return py::bytes(FromCharGrid(CharGrid(entity_layer),
+                                      CharGrid(variations_layer))
+                             .Serialize());
+      },
+      py::arg("entity_layer"), py::arg("variations_layer"));
+  m.def(
+      "deserialize",
+      [](const std::string& data) {
+        TextMaze maze({0, 0});
+        if (!TextMaze::Deserialize(data, &maze)) {
+          throw py::value_error("Malformed serialized maze.");
+        }
+        return py::make_tuple(maze.Text(TextMaze::kEntityLayer),
+                              maze.Text(TextMaze::kVariationsLayer));
+      },
+      py::arg("data"));
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,116 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/text_maze.h"
+#include "labmaze/cc/weighted_flood_fill.h"
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+#include "pybind11/pytypes.h"
+#include "pybind11/stl.h"
+
+namespace deepmind {
+namespace labmaze {
+
+namespace py = pybind11;
+
+namespace {
+
+// Returns a CharCostMap of 'costs', keyed by single characters, with
+// 'default_cost' for all other characters, and stores its largest cost in
+// '*max_cost'. Raises ValueError if a key is not a single character or a cost
+// is below 'min_cost' or above kMaxCellCost.
+CharCostMap ToCharCostMap(const std::map<std::string, int>& costs,
+                          int default_cost, int min_cost, int* max_cost) {
+  CharCostMap result;
+  result.fill(default_cost);
+  *max_cost = default_cost;
+  for (const auto& cost : costs) {
+    if (cost.first.size() != 1) {
+      throw py::value_error("Costs shall be keyed by single characters.");
+    }
+    if (cost.second < min_cost) {
+      throw py::value_error("Cost of '" + cost.first + "' is too low.");
+    }
+    if (cost.second > kMaxCellCost) {
+      throw py::value_error("Cost of '" + cost.first + "' is too high.");
+    }
+    result[static_cast<unsigned char>(cost.first[0])] = cost.second;
+    *max_cost = std::max(*max_cost, cost.second);
+  }
+  return result;
+}
+
+}  // namespace
+
+PYBIND11_MODULE(_weighted_flood_fill, m) {
+  m.def(
+      "weighted_distances",
+      [](const std::string& entity_layer, const std::string& variations_layer,
+         const std::pair<int, int>& goal, const std::string& wall_chars,
+         const std::map<std::string, int>& entity_costs,
+         const std::map<std::string, int>& variation_costs,
+         int default_cost) {
+        if (default_cost < 1 || default_cost > kMaxCellCost) {
+          throw py::value_error("default_cost shall be positive and at most " +
+                                std::to_string(kMaxCellCost) + ".");
+        }
+        // Variation costs are positive and entity costs are not negative,
+        // so every open cell costs something.
+        int max_entity_cost;
+        CharCostMap entity_map =
+            ToCharCostMap(entity_costs, 0, 0, &max_entity_cost);
+        for (char c : wall_chars) {
+          entity_map[static_cast<unsigned char>(c)] = -1;
+        }
+        int max_variation_cost;
+        const CharCostMap variation_map = ToCharCostMap(
+            variation_costs, default_cost, 1, &max_variation_cost);
+        if (max_entity_cost + max_variation_cost > kMaxCellCost) {
+          throw py::value_error("Entity and variation costs shall sum to at "
+                                "most " +
+                                std::to_string(kMaxCellCost) + ".");
+        }
+
+        const TextMaze maze = FromCharGrid(CharGrid(entity_layer),
+                                           CharGrid(variations_layer));
+        const Size size = maze.Area().size;
+        py::array_t<std::int32_t> distances({size.height, size.width});
+        auto view = distances.mutable_unchecked<2>();
+        {
+          py::gil_scoped_release release;
+          const WeightedFloodFill fill(maze, {goal.first, goal.second},
+                                       entity_map, variation_map);
+          maze.Area().Visit([&view](int i, int j) { view(i, j) = -1; });
+          fill.Visit([&view](int i, int j, int distance) {
+            view(i, j) = distance;
+          });
+        }
+        return distances;
+      },
+      py::arg("entity_layer"), py::arg("variations_layer"), py::arg("goal"),
+      py::arg("wall_chars"), py::arg("entity_costs"),
+      py::arg("variation_costs"), py::arg("default_cost"));
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
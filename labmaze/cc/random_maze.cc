@@ -15,8 +15,15 @@
 
 #include "labmaze/cc/random_maze.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include <string>
+#include <tuple>
+#include <utility>
+
+#include "labmaze/cc/logging.h"
 
 namespace deepmind {
 namespace labmaze {
@@ -28,28 +35,70 @@ RandomMaze::RandomMaze(int height, int width,
                        int spawns_per_room, absl::string_view spawn_token,
                        int objects_per_room, absl::string_view object_token,
                        std::mt19937_64::result_type random_seed)
-    : maze_size_{height, width},
+    : RandomMaze(RandomMazeParams{height, width, max_rooms, room_min_size,
+                                  room_max_size, retry_count,
+                                  extra_connection_probability,
+                                  max_variations, has_doors, simplify,
+                                  spawns_per_room, std::string(spawn_token),
+                                  objects_per_room, std::string(object_token)},
+                 random_seed) {}
+
+bool operator==(const RandomMazeParams& lhs, const RandomMazeParams& rhs) {
+  auto tie = [](const RandomMazeParams& p) {
+    return std::tie(p.height, p.width, p.max_rooms, p.room_min_size,
+                    p.room_max_size, p.retry_count,
+                    p.extra_connection_probability, p.max_variations,
+                    p.has_doors, p.simplify, p.spawns_per_room, p.spawn_token,
+                    p.objects_per_room, p.object_token);
+  };
+  return tie(lhs) == tie(rhs);
+}
+
+RandomMaze::RandomMaze(const RandomMazeParams& params)
+    : maze_size_{params.height, params.width},
       maze_params_{},
-      extra_connection_probability_{extra_connection_probability},
-      max_variations_{max_variations},
-      has_doors_{has_doors},
-      simplify_{simplify},
-      spawns_per_room_{spawns_per_room},
-      spawn_token_{spawn_token},
-      objects_per_room_{objects_per_room},
-      object_token_{object_token},
-      prng_{random_seed},
+      extra_connection_probability_{params.extra_connection_probability},
+      max_variations_{params.max_variations},
+      has_doors_{params.has_doors},
+      simplify_{params.simplify},
+      spawns_per_room_{params.spawns_per_room},
+      spawn_token_{params.spawn_token},
+      objects_per_room_{params.objects_per_room},
+      object_token_{params.object_token},
       maze_{maze_size_} {
-  maze_params_.min_size = Size{room_min_size, room_min_size};
-  maze_params_.max_size = Size{room_max_size, room_max_size};
-  maze_params_.retry_count = retry_count;
-  maze_params_.max_rects = max_rooms;
+  maze_params_.min_size = Size{params.room_min_size, params.room_min_size};
+  maze_params_.max_size = Size{params.room_max_size, params.room_max_size};
+  maze_params_.retry_count = params.retry_count;
+  maze_params_.max_rects = params.max_rooms;
   maze_params_.density = 1.0;
+}
+
+RandomMaze::RandomMaze(const RandomMazeParams& params,
+                       std::mt19937_64::result_type random_seed)
+    : RandomMaze(params) {
+  prng_.seed(random_seed);
+  seed_ = random_seed;
+  counted_prng_ = prng_;
   Regenerate();
 }
 
+RandomMaze RandomMaze::Restore(const RandomMazeParams& params,
+                               const std::string& prng_state, TextMaze maze) {
+  CHECK(maze.Area().size.height == params.height &&
+        maze.Area().size.width == params.width)
+      << "The maze does not have the size of the parameters.";
+  RandomMaze random_maze(params);
+  random_maze.SetPrngState(prng_state);
+  random_maze.maze_ = std::move(maze);
+  return random_maze;
+}
+
 void RandomMaze::Regenerate() {
-  maze_ = TextMaze(maze_size_);
+  // Rooms and corridor regions each contain at least one cell with odd
+  // coordinates, which bounds the number of region ids.
+  const unsigned int max_id =
+      std::max(1, (maze_size_.height / 2) * (maze_size_.width / 2));
+  maze_ = TextMaze(maze_size_, max_id);
   // Create random rooms.
   const auto rects = MakeSeparateRectangles(maze_.Area(), maze_params_, &prng_);
   const auto num_rooms = rects.size();
@@ -65,8 +114,8 @@ void RandomMaze::Regenerate() {
   FillSpaceWithMaze(num_rooms + 1, 0, &maze_, &prng_);
 
   // Connect adjacent regions at least once.
-  auto conns =
-      RandomConnectRegions(-1, extra_connection_probability_, &maze_, &prng_);
+  auto conns = RandomConnectRegionGraph(-1, extra_connection_probability_,
+                                        &maze_, &prng_);
 
   // Simplify the maze_ if requested.
   if (simplify_) {
@@ -75,14 +124,7 @@ void RandomMaze::Regenerate() {
   }
 
   // Add variations.
-  maze_.VisitMutable(
-      TextMaze::kVariationsLayer,
-      [this, num_rooms](int i, int j, char* cell) {
-        auto id = maze_.GetCellId({i, j});
-        if (id > 0 && id <= num_rooms) {
-          *cell = 'A' + (id - 1) % max_variations_;
-        }
-      });
+  AddRoomVariations(num_rooms, max_variations_, &maze_);
 
   // Add entities and spawn points.
   AddNEntitiesToEachRoom(rects, spawns_per_room_, spawn_token_[0], ' ', &maze_,
@@ -91,19 +133,74 @@ void RandomMaze::Regenerate() {
                          &maze_, &prng_);
 
   // Set each connection cell connection type.
+  num_rooms_ = static_cast<int>(num_rooms);
+  doors_.clear();
   for (const auto& conn : conns) {
     char connection_type;
     // Set to wall if connected to nowhere.
-    if (maze_.GetCell(TextMaze::kEntityLayer,
-                      conn.first + conn.second) == '*') {
+    if (maze_.GetCell(TextMaze::kEntityLayer, conn.pos + conn.direction) ==
+        '*') {
       connection_type = '*';
     } else if (has_doors_) {
-      connection_type = (conn.second.d_col == 0) ? 'H' : 'I';
+      connection_type = (conn.direction.d_col == 0) ? 'H' : 'I';
     } else {
       connection_type = ' ';
     }
-    maze_.SetCell(TextMaze::kEntityLayer, conn.first, connection_type);
+    maze_.SetCell(TextMaze::kEntityLayer, conn.pos, connection_type);
+    if (connection_type != '*' &&
+        maze_.GetCell(TextMaze::kEntityLayer, conn.pos - conn.direction) !=
+            '*') {
+      doors_.push_back(conn);
+    }
+  }
+
+  // Region ids are only needed during generation.
+  maze_.ReleaseIds();
+}
+
+std::string RandomMaze::PrngState() const {
+  // The generator algorithms take a std::mt19937_64, so draws are not counted
+  // as they happen. Instead counted_prng_ steps forward until it produces the
+  // next values of prng_; 256 matching bits only occur at the same state.
+  std::mt19937_64 target = prng_;
+  std::mt19937_64::result_type next[4];
+  for (auto& value : next) {
+    value = target();
+  }
+  while (true) {
+    if (counted_prng_() == next[0]) {
+      std::mt19937_64 probe = counted_prng_;
+      if (probe() == next[1] && probe() == next[2] && probe() == next[3]) {
+        counted_prng_ = prng_;
+        break;
+      }
+    }
+    ++draws_;
+  }
+  std::string state;
+  for (std::uint64_t value : {std::uint64_t{seed_}, draws_}) {
+    for (int i = 0; i < 8; ++i) {
+      state.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+  return state;
+}
+
+void RandomMaze::SetPrngState(const std::string& state) {
+  CHECK_EQ(state.size(), std::size_t{16})
+      << "Invalid random number generator state.";
+  std::uint64_t values[2] = {0, 0};
+  for (int k = 0; k < 2; ++k) {
+    for (int i = 0; i < 8; ++i) {
+      values[k] |= std::uint64_t{static_cast<unsigned char>(state[8 * k + i])}
+                   << (8 * i);
+    }
   }
+  seed_ = values[0];
+  draws_ = values[1];
+  prng_.seed(seed_);
+  prng_.discard(draws_);
+  counted_prng_ = prng_;
 }
 
 std::string RandomMaze::EntityLayer() const {
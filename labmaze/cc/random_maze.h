@@ -16,16 +16,50 @@
 #ifndef LABMAZE_CC_RANDOM_MAZE_H_
 #define LABMAZE_CC_RANDOM_MAZE_H_
 
+#include <cstdint>
 #include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/defaults.h"
 #include "labmaze/cc/text_maze.h"
 
 namespace deepmind {
 namespace labmaze {
 
+// Parameters of a RandomMaze, excluding the random seed. Defaults match those
+// of the Python `labmaze.RandomMaze` API.
+struct RandomMazeParams {
+  int height = 11;
+  int width = 11;
+  int max_rooms = defaults::kMaxRooms;
+  int room_min_size = defaults::kRoomMinSize;
+  int room_max_size = defaults::kRoomMaxSize;
+  int retry_count = defaults::kRetryCount;
+  double extra_connection_probability = defaults::kExtraConnectionProbability;
+  int max_variations = defaults::kMaxVariations;
+  bool has_doors = defaults::kHasDoors;
+  bool simplify = defaults::kSimplify;
+  int spawns_per_room = defaults::kSpawnCount;
+  std::string spawn_token = defaults::kSpawnToken;
+  int objects_per_room = defaults::kObjectCount;
+  std::string object_token = defaults::kObjectToken;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const RandomMazeParams& p) {
+    return H::combine(std::move(h), p.height, p.width, p.max_rooms,
+                      p.room_min_size, p.room_max_size, p.retry_count,
+                      p.extra_connection_probability, p.max_variations,
+                      p.has_doors, p.simplify, p.spawns_per_room,
+                      p.spawn_token, p.objects_per_room, p.object_token);
+  }
+};
+
+bool operator==(const RandomMazeParams& lhs, const RandomMazeParams& rhs);
+
 // This class generates random text mazes of a specified size. Walls in the maze
 // are represented by '*'. Optionally, the generated maze can be structured into
 // rooms. In this case, the number and size of the rooms can also be configured.
@@ -41,6 +75,16 @@ class RandomMaze {
                       int objects_per_room, absl::string_view object_token,
                       std::mt19937_64::result_type random_seed);
 
+  RandomMaze(const RandomMazeParams& params,
+             std::mt19937_64::result_type random_seed);
+
+  // Returns a RandomMaze whose generator state is 'prng_state', as returned by
+  // PrngState, and whose latest maze is 'maze', without generating one.
+  // 'maze' shall have the size of 'params'. NumRooms() and RegionDoors() of
+  // the result are empty.
+  static RandomMaze Restore(const RandomMazeParams& params,
+                            const std::string& prng_state, TextMaze maze);
+
   // Generates a new random maze.
   void Regenerate();
 
@@ -51,7 +95,32 @@ class RandomMaze {
   // latest maze generated.
   std::string VariationsLayer() const;
 
+  // Returns the state of the random number generator, which determines all
+  // subsequently generated mazes, as 16 bytes: the seed and the number of
+  // values drawn since seeding, in little-endian. Counting the draws takes
+  // time linear in the draws since the previous call.
+  std::string PrngState() const;
+
+  // Restores a random number generator state returned by PrngState. Does not
+  // regenerate the current maze.
+  void SetPrngState(const std::string& state);
+
+  // Returns the latest maze generated.
+  const TextMaze& Maze() const { return maze_; }
+
+  // Returns the number of rooms of the latest maze generated. Regions 1 to
+  // NumRooms() of RegionDoors are rooms and higher ids are corridors.
+  int NumRooms() const { return num_rooms_; }
+
+  // Returns the open doors of the latest maze generated, which are the edges of
+  // the graph of its rooms and corridors. Connections that were walled off
+  // when simplifying the maze are omitted.
+  const std::vector<RegionDoor>& RegionDoors() const { return doors_; }
+
  private:
+  // Sets up the parameters without generating a maze.
+  explicit RandomMaze(const RandomMazeParams& params);
+
   Size maze_size_;
   SeparateRectangleParams maze_params_;
   double extra_connection_probability_;
@@ -63,7 +132,14 @@ class RandomMaze {
   int objects_per_room_;
   std::string object_token_;
   std::mt19937_64 prng_;
+  // The seed of prng_, and a copy of prng_ after 'draws_' values were drawn
+  // from that seed. PrngState advances them to prng_.
+  std::mt19937_64::result_type seed_ = 0;
+  mutable std::mt19937_64 counted_prng_;
+  mutable std::uint64_t draws_ = 0;
   TextMaze maze_;
+  int num_rooms_ = 0;
+  std::vector<RegionDoor> doors_;
 };
 
 }  // namespace labmaze
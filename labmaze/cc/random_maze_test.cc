@@ -15,8 +15,15 @@
 
 #include "labmaze/cc/random_maze.h"
 
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
 #include "labmaze/cc/defaults.h"
 
 // This file provides a quick sanity check for the C++ bindings layer.
@@ -80,5 +87,91 @@ TEST(RandomMazeTest, TestGolden7x9Maze) {
                   ".........\n");
 }
 
+TEST(RandomMazeTest, RegionDoorsConnectAllRegions) {
+  RandomMazeParams params;
+  params.height = 31;
+  params.width = 31;
+  params.max_rooms = 8;
+  params.extra_connection_probability = 0.1;
+  for (int seed = 0; seed < 10; ++seed) {
+    const RandomMaze maze(params, seed);
+    ASSERT_LT(0, maze.NumRooms());
+    const auto& doors = maze.RegionDoors();
+    ASSERT_FALSE(doors.empty());
+
+    // Every door is open and the doors join all regions into one graph.
+    std::map<unsigned int, unsigned int> parents;
+    std::function<unsigned int(unsigned int)> find = [&](unsigned int id) {
+      auto it = parents.emplace(id, id).first;
+      return it->second == id ? id : it->second = find(it->second);
+    };
+    for (const auto& door : doors) {
+      EXPECT_LT(door.id_0, door.id_1);
+      EXPECT_NE('*', maze.Maze().GetCell(TextMaze::kEntityLayer, door.pos));
+      EXPECT_NE('*', maze.Maze().GetCell(TextMaze::kEntityLayer,
+                                         door.pos - door.direction));
+      EXPECT_NE('*', maze.Maze().GetCell(TextMaze::kEntityLayer,
+                                         door.pos + door.direction));
+      parents[find(door.id_1)] = find(door.id_0);
+    }
+    const unsigned int root = find(1);
+    for (unsigned int id = 2; id <= static_cast<unsigned int>(maze.NumRooms());
+         ++id) {
+      EXPECT_EQ(root, find(id)) << "seed " << seed << " room " << id;
+    }
+    for (const auto& parent : parents) {
+      EXPECT_EQ(root, find(parent.first)) << "seed " << seed;
+    }
+  }
+}
+
+TEST(RandomMazeTest, RestoreContinuesSequence) {
+  RandomMazeParams params;
+  params.height = 21;
+  params.width = 31;
+  RandomMaze maze(params, 7);
+  // Draws are counted from the previous call on.
+  const std::string first_state = maze.PrngState();
+  maze.Regenerate();
+  const std::string state = maze.PrngState();
+  EXPECT_EQ(16u, state.size());
+  EXPECT_NE(first_state, state);
+  RandomMaze restored = RandomMaze::Restore(params, state, maze.Maze());
+  EXPECT_EQ(maze.EntityLayer(), restored.EntityLayer());
+  EXPECT_EQ(maze.VariationsLayer(), restored.VariationsLayer());
+  for (int k = 0; k < 3; ++k) {
+    maze.Regenerate();
+    restored.Regenerate();
+    EXPECT_EQ(maze.EntityLayer(), restored.EntityLayer());
+    EXPECT_EQ(maze.VariationsLayer(), restored.VariationsLayer());
+  }
+  EXPECT_EQ(maze.PrngState(), restored.PrngState());
+}
+
+TEST(RandomMazeTest, CopiesAndDeserializedMazesTakeIds) {
+  RandomMazeParams params;
+  params.height = 21;
+  params.width = 31;
+  RandomMaze random_maze(params, 5);
+  TextMaze copy = random_maze.Maze();
+  TextMaze restored({1, 1});
+  ASSERT_TRUE(TextMaze::Deserialize(copy.Serialize(), &restored));
+  // The maze is connected, so a path joins its first and last open cells.
+  std::vector<Pos> open_cells;
+  copy.Visit(TextMaze::kEntityLayer, [&open_cells](int i, int j, char cell) {
+    if (cell != '*') open_cells.push_back({i, j});
+  });
+  ASSERT_GE(open_cells.size(), 2u);
+  const Pos from = open_cells.front();
+  const Pos to = open_cells.back();
+  for (TextMaze* maze : {&copy, &restored}) {
+    std::mt19937_64 prbg(11);
+    std::vector<Pos> path = FindRandomPath(from, to, {'*'}, maze, &prbg);
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(from, path.front());
+    EXPECT_EQ(to, path.back());
+  }
+}
+
 }  // namespace labmaze
 }  // namespace deepmind
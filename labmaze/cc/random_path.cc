@@ -0,0 +1,200 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/random_path.h"
+
+#include <array>
+#include <vector>
+
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/search_labels.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// The labels of the cells in a query, kept by each thread across queries.
+// 'visited' marks the cells visited by the current search, and 'reached' the
+// cells that are distances[k] steps from the end of the current query.
+struct PathLabels {
+  internal::EpochStamps visited;
+  internal::EpochStamps reached;
+  std::vector<int> distances;
+  std::vector<int> path;
+  std::vector<int> queue;
+};
+
+// Returns the labels of the calling thread, with room for 'num_cells' cells.
+PathLabels& ThreadPathLabels(int num_cells) {
+  PathLabels& labels = internal::ThreadLabels<PathLabels>();
+  labels.visited.Reserve(num_cells);
+  labels.reached.Reserve(num_cells);
+  internal::ReserveLabels(num_cells, &labels.distances);
+  return labels;
+}
+
+// Returns the offsets of the cells of 'grid' in the order of
+// internal::PathDirections(), in which FindRandomPath tries them.
+std::array<int, 4> PathOffsets(const BorderedGrid<char>& grid) {
+  const std::array<Vec, 4> directions = internal::PathDirections();
+  std::array<int, 4> offsets;
+  for (int k = 0; k < 4; ++k) {
+    offsets[k] = directions[k].d_row * grid.stride() + directions[k].d_col;
+  }
+  return offsets;
+}
+
+// Searches depth-first from cell 'from' of 'open' for cell 'to' as
+// FindRandomPath does, stepping only onto cells for which 'admit(cell, steps)'
+// holds, 'steps' being the length of the route to the cell, and ending only
+// at routes of at least 'min_length' steps. Leaves the route found, if any,
+// in 'labels->path'.
+template <typename Admit>
+bool Search(const BorderedGrid<char>& open, int from, int to, int min_length,
+            Admit admit, PathLabels* labels, std::mt19937_64* rng) {
+  const unsigned int stamp = labels->visited.NewStamps();
+  const std::array<int, 4> offsets = PathOffsets(open);
+  std::vector<int>& path = labels->path;
+  path.assign(1, from);
+  labels->visited[from] = stamp;
+  while (!path.empty()) {
+    const int cell = path.back();
+    const int steps = static_cast<int>(path.size());
+    int candidates[4];
+    int num_candidates = 0;
+    for (int offset : offsets) {
+      const int neighbour = cell + offset;
+      if (neighbour == to) {
+        if (steps >= min_length) {
+          path.push_back(neighbour);
+          return true;
+        }
+        continue;
+      }
+      if (open[neighbour] && labels->visited[neighbour] != stamp &&
+          admit(neighbour, steps)) {
+        candidates[num_candidates++] = neighbour;
+      }
+    }
+    if (num_candidates == 0) {
+      path.pop_back();
+      continue;
+    }
+    const int next = candidates[std::uniform_int_distribution<>(
+        0, num_candidates - 1)(*rng)];
+    labels->visited[next] = stamp;
+    path.push_back(next);
+  }
+  return false;
+}
+
+}  // namespace
+
+RandomPathFinder::RandomPathFinder(const TextMaze& maze, TextMaze::Layer layer,
+                                   const std::vector<char>& wall_chars)
+    : layer_(layer),
+      is_wall_(internal::MakeCharBoolMap(wall_chars)),
+      area_(maze.Area()),
+      open_(area_.size, 0, 0) {
+  Update(maze, area_);
+}
+
+void RandomPathFinder::Update(const TextMaze& maze, const Rectangle& rect) {
+  internal::ReadOpenCells(maze, layer_, is_wall_, rect, &open_);
+}
+
+std::vector<Pos> RandomPathFinder::FindPath(Pos from, Pos to,
+                                            std::mt19937_64* rng) const {
+  std::vector<Pos> result;
+  if (from == to) {
+    result.push_back(from);
+    return result;
+  }
+  if (!area_.InBounds(from) || !area_.InBounds(to)) {
+    return result;
+  }
+  PathLabels& labels = ThreadPathLabels((area_.size.height + 2) *
+                                        open_.stride());
+  if (Search(open_, open_.Index(from.row, from.col),
+             open_.Index(to.row, to.col), 0, [](int, int) { return true; },
+             &labels, rng)) {
+    result.reserve(labels.path.size());
+    for (int cell : labels.path) {
+      result.push_back(open_.ToPos(cell));
+    }
+  }
+  return result;
+}
+
+std::vector<Pos> RandomPathFinder::FindPath(Pos from, Pos to, int min_length,
+                                            int max_length, int max_attempts,
+                                            std::mt19937_64* rng) const {
+  std::vector<Pos> result;
+  if (from == to) {
+    if (min_length <= 0) result.push_back(from);
+    return result;
+  }
+  if (!area_.InBounds(from) || !area_.InBounds(to)) {
+    return result;
+  }
+  PathLabels& labels = ThreadPathLabels((area_.size.height + 2) *
+                                        open_.stride());
+  const int from_cell = open_.Index(from.row, from.col);
+  const int to_cell = open_.Index(to.row, to.col);
+
+  // Labels the cells within 'max_length' steps of 'to' with their distance
+  // from it, breadth-first, so that routes are only extended towards cells
+  // from which 'to' can be reached in time.
+  const unsigned int reached = labels.reached.NewStamps();
+  const std::array<int, 4> offsets = open_.NeighbourOffsets();
+  labels.reached[to_cell] = reached;
+  labels.distances[to_cell] = 0;
+  labels.queue.assign(1, to_cell);
+  for (std::size_t k = 0; k < labels.queue.size(); ++k) {
+    const int cell = labels.queue[k];
+    const int distance = labels.distances[cell] + 1;
+    if (max_length >= 0 && distance > max_length) break;
+    for (int offset : offsets) {
+      const int neighbour = cell + offset;
+      if ((open_[neighbour] || neighbour == from_cell) &&
+          labels.reached[neighbour] != reached) {
+        labels.reached[neighbour] = reached;
+        labels.distances[neighbour] = distance;
+        labels.queue.push_back(neighbour);
+      }
+    }
+  }
+  if (labels.reached[from_cell] != reached) {
+    return result;
+  }
+
+  const auto admit = [&labels, reached, max_length](int cell, int steps) {
+    return labels.reached[cell] == reached &&
+           (max_length < 0 || steps + labels.distances[cell] <= max_length);
+  };
+  for (int attempt = 0; attempt < max_attempts; ++attempt) {
+    if (Search(open_, from_cell, to_cell, min_length, admit, &labels, rng)) {
+      result.reserve(labels.path.size());
+      for (int cell : labels.path) {
+        result.push_back(open_.ToPos(cell));
+      }
+      return result;
+    }
+  }
+  return result;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
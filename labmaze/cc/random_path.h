@@ -0,0 +1,71 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Random path queries that leave the maze untouched.
+
+#ifndef LABMAZE_CC_RANDOM_PATH_H_
+#define LABMAZE_CC_RANDOM_PATH_H_
+
+#include <random>
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// Finds random paths between cells of a maze by the randomised depth-first
+// search of FindRandomPath. Unlike FindRandomPath, a query neither writes the
+// ids of the maze nor reads all of its cells: the open cells are read once on
+// construction, and visited cells are stamped in arrays kept by each thread
+// across queries. A query thus costs time in proportion to the cells it
+// explores, and queries may run concurrently from any number of threads.
+class RandomPathFinder {
+ public:
+  // Reads the cells of 'layer' of 'maze' that are not in 'wall_chars'.
+  RandomPathFinder(const TextMaze& maze, TextMaze::Layer layer,
+                   const std::vector<char>& wall_chars);
+
+  // Re-reads the cells in 'rect' from 'maze', which shall have the extents of
+  // the maze given on construction.
+  void Update(const TextMaze& maze, const Rectangle& rect);
+
+  // Returns the path that FindRandomPath(from, to, wall_chars, &maze, rng)
+  // returns if 'layer' is the entity layer of 'maze', drawing the same numbers
+  // from 'rng': a random route from 'from' to 'to' including
+  // both end points, or an empty vector if there is none. Returns an empty
+  // vector if 'from' or 'to' is out of bounds and they differ.
+  std::vector<Pos> FindPath(Pos from, Pos to, std::mt19937_64* rng) const;
+
+  // As FindPath, but returns only routes of at least 'min_length' steps and,
+  // unless 'max_length' is negative, at most 'max_length' steps. Branches too
+  // far from 'to' to end within 'max_length' steps are not explored. Makes up
+  // to 'max_attempts' searches and returns an empty vector if none finds
+  // such a route.
+  std::vector<Pos> FindPath(Pos from, Pos to, int min_length, int max_length,
+                            int max_attempts, std::mt19937_64* rng) const;
+
+ private:
+  TextMaze::Layer layer_;
+  internal::CharBoolMap is_wall_;
+  Rectangle area_;
+  BorderedGrid<char> open_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_RANDOM_PATH_H_
@@ -0,0 +1,103 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares random path queries by RandomPathFinder with FindRandomPath, which
+// rewrites the ids of the whole maze on each query, for end points near each
+// other and far apart.
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/benchmark_util.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/random_path.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Random paths between cells of a maze state.range(0) cells square, up to
+// 2 * state.range(1) rows and columns apart.
+void BM_RandomPathFinder(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  const auto queries = MakeOddCellQueries(state.range(0), state.range(1));
+  std::mt19937_64 rng(3);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        finder.FindPath(queries[k].first, queries[k].second, &rng));
+    if (++k == queries.size()) k = 0;
+  }
+}
+BENCHMARK(BM_RandomPathFinder)
+    ->ArgNames({"size", "spread"})
+    ->Args({201, 10})
+    ->Args({1001, 10})
+    ->Args({1001, 1000})
+    ->Unit(benchmark::kMicrosecond);
+
+// As BM_RandomPathFinder, with routes of at most twice the Manhattan distance
+// between the end points, or 10 steps more if shorter.
+void BM_RandomPathFinderMaxLength(benchmark::State& state) {
+  const TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  const auto queries = MakeOddCellQueries(state.range(0), state.range(1));
+  std::mt19937_64 rng(3);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    const Pos& from = queries[k].first;
+    const Pos& to = queries[k].second;
+    const int manhattan =
+        std::abs(from.row - to.row) + std::abs(from.col - to.col);
+    benchmark::DoNotOptimize(finder.FindPath(
+        from, to, 0, std::max(2 * manhattan, manhattan + 10), 4, &rng));
+    if (++k == queries.size()) k = 0;
+  }
+}
+BENCHMARK(BM_RandomPathFinderMaxLength)
+    ->ArgNames({"size", "spread"})
+    ->Args({201, 10})
+    ->Args({1001, 10})
+    ->Unit(benchmark::kMicrosecond);
+
+// As BM_RandomPathFinder, with FindRandomPath, which writes the ids of the
+// maze.
+void BM_FindRandomPath(benchmark::State& state) {
+  TextMaze maze = MakeUnsimplifiedMaze(state.range(0));
+  const auto queries = MakeOddCellQueries(state.range(0), state.range(1));
+  std::mt19937_64 rng(3);
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindRandomPath(
+        queries[k].first, queries[k].second, {'*'}, &maze, &rng));
+    if (++k == queries.size()) k = 0;
+  }
+}
+BENCHMARK(BM_FindRandomPath)
+    ->ArgNames({"size", "spread"})
+    ->Args({201, 10})
+    ->Args({1001, 10})
+    ->Args({1001, 1000})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
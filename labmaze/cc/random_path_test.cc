@@ -0,0 +1,235 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+
+#include "labmaze/cc/random_path.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Checks that 'path' is a route without repeated cells from 'from' to 'to'
+// over open cells of 'maze'.
+void ExpectRoute(const TextMaze& maze, Pos from, Pos to,
+                 const std::vector<Pos>& path) {
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(from, path.front());
+  EXPECT_EQ(to, path.back());
+  for (std::size_t k = 0; k < path.size(); ++k) {
+    EXPECT_NE('*', maze.GetCell(TextMaze::kEntityLayer, path[k]));
+    if (k > 0) {
+      EXPECT_EQ(1, std::abs(path[k].row - path[k - 1].row) +
+                       std::abs(path[k].col - path[k - 1].col));
+    }
+    for (std::size_t l = 0; l < k; ++l) {
+      EXPECT_FALSE(path[l] == path[k]);
+    }
+  }
+}
+
+TextMaze MakeMaze(int size, int seed) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = 3;
+  params.extra_connection_probability = 0.1;
+  params.simplify = false;
+  return RandomMaze(params, seed).Maze();
+}
+
+// Returns a copy of the entity layer of 'maze' with an id layer.
+TextMaze WithIds(const TextMaze& maze) {
+  TextMaze copy(maze.Area().size);
+  maze.Visit(TextMaze::kEntityLayer, [&copy](int i, int j, char cell) {
+    copy.SetCell(TextMaze::kEntityLayer, {i, j}, cell);
+  });
+  return copy;
+}
+
+TEST(RandomPathFinderTest, Simple) {
+  const TextMaze maze = FromCharGrid(CharGrid("*****\n"
+                                              "*   *\n"
+                                              "* * *\n"
+                                              "*   *\n"
+                                              "*****\n"));
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  std::mt19937_64 rng(1);
+  EXPECT_THAT(finder.FindPath({1, 1}, {1, 1}, &rng), ElementsAre(Pos{1, 1}));
+  EXPECT_THAT(finder.FindPath({1, 1}, {1, 2}, &rng),
+              ElementsAre(Pos{1, 1}, Pos{1, 2}));
+  for (int k = 0; k < 10; ++k) {
+    const std::vector<Pos> path = finder.FindPath({1, 1}, {3, 3}, &rng);
+    ExpectRoute(maze, {1, 1}, {3, 3}, path);
+    EXPECT_EQ(5u, path.size());
+  }
+  EXPECT_TRUE(finder.FindPath({1, 1}, {5, 1}, &rng).empty());
+  EXPECT_TRUE(finder.FindPath({-1, 1}, {1, 1}, &rng).empty());
+}
+
+TEST(RandomPathFinderTest, Unreachable) {
+  const TextMaze maze = FromCharGrid(CharGrid("  *   \n"
+                                              "  *   \n"));
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  std::mt19937_64 rng(1);
+  EXPECT_TRUE(finder.FindPath({0, 0}, {1, 5}, &rng).empty());
+  EXPECT_TRUE(finder.FindPath({0, 0}, {1, 5}, 0, -1, 10, &rng).empty());
+}
+
+TEST(RandomPathFinderTest, MatchesFindRandomPath) {
+  for (int seed = 0; seed < 5; ++seed) {
+    const TextMaze maze = MakeMaze(31, seed);
+    const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+    std::mt19937_64 pick(seed);
+    std::uniform_int_distribution<> odd(0, 14);
+    for (int query = 0; query < 20; ++query) {
+      const Pos from = {2 * odd(pick) + 1, 2 * odd(pick) + 1};
+      const Pos to = {2 * odd(pick) + 1, 2 * odd(pick) + 1};
+      TextMaze scratch = WithIds(maze);
+      std::mt19937_64 expected_rng(query);
+      const std::vector<Pos> expected =
+          FindRandomPath(from, to, {'*'}, &scratch, &expected_rng);
+      std::mt19937_64 rng(query);
+      const std::vector<Pos> path = finder.FindPath(from, to, &rng);
+      ASSERT_EQ(expected, path);
+      EXPECT_EQ(expected_rng(), rng());
+      ExpectRoute(maze, from, to, path);
+    }
+  }
+}
+
+TEST(RandomPathFinderTest, LeavesMazeUntouched) {
+  TextMaze maze = WithIds(MakeMaze(21, 3));
+  maze.SetCellId({1, 1}, 7);
+  const std::string entities = maze.Text(TextMaze::kEntityLayer);
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  std::mt19937_64 rng(1);
+  ExpectRoute(maze, {1, 1}, {19, 19}, finder.FindPath({1, 1}, {19, 19}, &rng));
+  EXPECT_EQ(7u, maze.GetCellId({1, 1}));
+  EXPECT_EQ(entities, maze.Text(TextMaze::kEntityLayer));
+}
+
+TEST(RandomPathFinderTest, Update) {
+  TextMaze maze = FromCharGrid(CharGrid("   \n"
+                                        "***\n"
+                                        "   \n"));
+  RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  std::mt19937_64 rng(1);
+  EXPECT_TRUE(finder.FindPath({0, 0}, {2, 0}, &rng).empty());
+  maze.SetCell(TextMaze::kEntityLayer, {1, 2}, ' ');
+  finder.Update(maze, {{1, 2}, {1, 1}});
+  EXPECT_THAT(finder.FindPath({0, 0}, {2, 0}, &rng),
+              ElementsAre(Pos{0, 0}, Pos{0, 1}, Pos{0, 2}, Pos{1, 2},
+                          Pos{2, 2}, Pos{2, 1}, Pos{2, 0}));
+}
+
+TEST(RandomPathFinderTest, LengthBounds) {
+  // Two routes from the top left to (3, 1): 4 steps down the left, or 10
+  // steps around the block.
+  const TextMaze maze = FromCharGrid(CharGrid("     \n"
+                                              " *** \n"
+                                              " *** \n"
+                                              "     \n"));
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  std::mt19937_64 rng(1);
+  for (int k = 0; k < 10; ++k) {
+    EXPECT_THAT(finder.FindPath({0, 0}, {3, 1}, 0, 9, 1, &rng),
+                ElementsAre(Pos{0, 0}, Pos{1, 0}, Pos{2, 0}, Pos{3, 0},
+                            Pos{3, 1}));
+    const std::vector<Pos> longer =
+        finder.FindPath({0, 0}, {3, 1}, 5, -1, 1, &rng);
+    ExpectRoute(maze, {0, 0}, {3, 1}, longer);
+    EXPECT_EQ(11u, longer.size());
+  }
+  EXPECT_TRUE(finder.FindPath({0, 0}, {3, 1}, 0, 3, 10, &rng).empty());
+  EXPECT_TRUE(finder.FindPath({0, 0}, {3, 1}, 5, 9, 10, &rng).empty());
+  EXPECT_TRUE(finder.FindPath({0, 0}, {0, 0}, 1, -1, 10, &rng).empty());
+  EXPECT_THAT(finder.FindPath({0, 0}, {0, 0}, 0, 0, 1, &rng),
+              ElementsAre(Pos{0, 0}));
+}
+
+TEST(RandomPathFinderTest, LengthBoundsInMaze) {
+  const TextMaze maze = MakeMaze(41, 4);
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  const int distance =
+      FloodFill(maze, TextMaze::kEntityLayer, {39, 39}, {'*'})
+          .DistanceFrom({1, 1});
+  ASSERT_GT(distance, 0);
+  std::mt19937_64 rng(2);
+  for (int max_length : {distance, distance + 10, 2 * distance}) {
+    for (int k = 0; k < 20; ++k) {
+      const std::vector<Pos> path =
+          finder.FindPath({1, 1}, {39, 39}, 0, max_length, 100, &rng);
+      ExpectRoute(maze, {1, 1}, {39, 39}, path);
+      EXPECT_GE(max_length + 1, static_cast<int>(path.size()));
+      const std::vector<Pos> long_path =
+          finder.FindPath({1, 1}, {39, 39}, max_length, -1, 100, &rng);
+      if (!long_path.empty()) {
+        ExpectRoute(maze, {1, 1}, {39, 39}, long_path);
+        EXPECT_LE(max_length + 1, static_cast<int>(long_path.size()));
+      }
+    }
+  }
+}
+
+TEST(RandomPathFinderTest, ConcurrentQueries) {
+  const TextMaze maze = MakeMaze(61, 5);
+  const RandomPathFinder finder(maze, TextMaze::kEntityLayer, {'*'});
+  constexpr int kThreads = 4;
+  constexpr int kQueries = 50;
+  std::vector<std::vector<Pos>> expected(kQueries);
+  for (int query = 0; query < kQueries; ++query) {
+    std::mt19937_64 rng(query);
+    expected[query] = finder.FindPath({1, 1}, {59, 2 * (query % 30) + 1}, &rng);
+  }
+  std::vector<int> mismatches(kThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int query = 0; query < kQueries; ++query) {
+        std::mt19937_64 rng(query);
+        if (finder.FindPath({1, 1}, {59, 2 * (query % 30) + 1}, &rng) !=
+            expected[query]) {
+          ++mismatches[t];
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    EXPECT_EQ(0, mismatches[t]);
+  }
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,101 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Building blocks shared by the path searches over the open cells of a maze:
+// reading which cells are open, and per-thread labels that need no clearing
+// between searches.
+
+#ifndef LABMAZE_CC_SEARCH_LABELS_H_
+#define LABMAZE_CC_SEARCH_LABELS_H_
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace internal {
+
+// Sets the cells of 'open' within 'rect' to whether the cells of 'layer' of
+// 'maze' are not walls. 'open' shall have the extents of the maze.
+inline void ReadOpenCells(const TextMaze& maze, TextMaze::Layer layer,
+                          const CharBoolMap& is_wall, const Rectangle& rect,
+                          BorderedGrid<char>* open) {
+  const auto read_row = [open, &is_wall](int i, int j, const char* cells,
+                                         int count) {
+    char* row = &(*open)[open->Index(i, j)];
+    for (int k = 0; k < count; ++k) {
+      row[k] = !is_wall[static_cast<unsigned char>(cells[k])];
+    }
+  };
+  maze.VisitRowsIntersection(layer, rect, read_row);
+}
+
+// Stamps of the elements labelled by a search, kept across searches. Element
+// k is labelled by the current search only if its stamp is one that
+// NewStamps returned for that search, which spares clearing the stamps for
+// each search.
+class EpochStamps {
+ public:
+  // Makes room for 'size' elements; new elements are unlabelled.
+  void Reserve(int size) {
+    if (static_cast<int>(stamps_.size()) < size) {
+      stamps_.resize(size, 0);
+    }
+  }
+
+  // Returns the first of 'count' consecutive stamps that no element carries.
+  unsigned int NewStamps(unsigned int count = 1) {
+    if (last_ > std::numeric_limits<unsigned int>::max() - count) {
+      std::fill(stamps_.begin(), stamps_.end(), 0);
+      last_ = 0;
+    }
+    const unsigned int first = last_ + 1;
+    last_ += count;
+    return first;
+  }
+
+  unsigned int& operator[](int k) { return stamps_[k]; }
+  unsigned int operator[](int k) const { return stamps_[k]; }
+
+ private:
+  std::vector<unsigned int> stamps_;
+  unsigned int last_ = 0;
+};
+
+// Returns the 'Labels' of the calling thread, kept across searches so that
+// their memory is reused.
+template <typename Labels>
+Labels& ThreadLabels() {
+  thread_local Labels labels;
+  return labels;
+}
+
+// Grows 'values' to at least 'size' elements.
+template <typename T>
+void ReserveLabels(int size, std::vector<T>* values) {
+  if (static_cast<int>(values->size()) < size) {
+    values->resize(size);
+  }
+}
+
+}  // namespace internal
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_SEARCH_LABELS_H_
@@ -0,0 +1,85 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/search_labels.h"
+
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace internal {
+namespace {
+
+TEST(SearchLabelsTest, ReadOpenCells) {
+  TextMaze maze({2, 3});
+  maze.SetCell(TextMaze::kEntityLayer, {0, 1}, ' ');
+  maze.SetCell(TextMaze::kEntityLayer, {1, 2}, 'G');
+  const CharBoolMap is_wall = MakeCharBoolMap(std::vector<char>{'*'});
+  BorderedGrid<char> open(maze.Area().size, 0, 0);
+  ReadOpenCells(maze, TextMaze::kEntityLayer, is_wall, maze.Area(), &open);
+  const char expected[2][3] = {{0, 1, 0}, {0, 0, 1}};
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(expected[i][j], open[open.Index(i, j)]) << i << ", " << j;
+    }
+  }
+
+  // Only the cells within the rectangle are read again.
+  maze.SetCell(TextMaze::kEntityLayer, {0, 0}, ' ');
+  maze.SetCell(TextMaze::kEntityLayer, {1, 2}, '*');
+  ReadOpenCells(maze, TextMaze::kEntityLayer, is_wall, {{0, 0}, {1, 1}},
+                &open);
+  EXPECT_EQ(1, open[open.Index(0, 0)]);
+  EXPECT_EQ(1, open[open.Index(1, 2)]);
+}
+
+TEST(SearchLabelsTest, NewStampsAreUnused) {
+  EpochStamps stamps;
+  stamps.Reserve(3);
+  const unsigned int first = stamps.NewStamps(2);
+  stamps[0] = first;
+  stamps[1] = first + 1;
+  const unsigned int second = stamps.NewStamps();
+  EXPECT_NE(first, second);
+  EXPECT_NE(first + 1, second);
+  EXPECT_NE(0u, second);
+  stamps[2] = second;
+  stamps.Reserve(4);
+  EXPECT_EQ(0u, stamps[3]);
+}
+
+TEST(SearchLabelsTest, StampsWrapAround) {
+  EpochStamps stamps;
+  stamps.Reserve(2);
+  const unsigned int first =
+      stamps.NewStamps(std::numeric_limits<unsigned int>::max() - 1);
+  stamps[0] = first;
+  stamps[1] = std::numeric_limits<unsigned int>::max() - 1;
+  // The stamps run out, so all elements are unlabelled again.
+  const unsigned int stamp = stamps.NewStamps(2);
+  EXPECT_EQ(1u, stamp);
+  EXPECT_EQ(0u, stamps[0]);
+  EXPECT_EQ(0u, stamps[1]);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace labmaze
+}  // namespace deepmind
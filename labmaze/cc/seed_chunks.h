@@ -0,0 +1,68 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Dealing out a range of seeds to worker threads.
+
+#ifndef LABMAZE_CC_SEED_CHUNKS_H_
+#define LABMAZE_CC_SEED_CHUNKS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace deepmind {
+namespace labmaze {
+namespace internal {
+
+// Splits the seeds [begin, end) into chunks of up to 'chunk_size' seeds that
+// threads claim in turn. Chunks are claimed by index, so no counter moves past
+// 'end' and ranges ending near the largest seed are safe.
+class SeedChunks {
+ public:
+  SeedChunks(std::uint64_t begin, std::uint64_t end, std::uint64_t chunk_size)
+      : begin_(begin),
+        end_(end),
+        chunk_size_(chunk_size),
+        num_chunks_(end > begin ? (end - begin - 1) / chunk_size + 1 : 0),
+        next_chunk_(0) {}
+
+  SeedChunks(const SeedChunks&) = delete;
+  SeedChunks& operator=(const SeedChunks&) = delete;
+
+  // Claims the next chunk, whose seeds are [*chunk_begin, *chunk_end).
+  // Returns false once all chunks are claimed. Thread-safe.
+  bool Next(std::uint64_t* chunk_begin, std::uint64_t* chunk_end) {
+    const std::uint64_t chunk = next_chunk_.fetch_add(1);
+    if (chunk >= num_chunks_) {
+      return false;
+    }
+    *chunk_begin = begin_ + chunk * chunk_size_;
+    *chunk_end = *chunk_begin + std::min(chunk_size_, end_ - *chunk_begin);
+    return true;
+  }
+
+ private:
+  const std::uint64_t begin_;
+  const std::uint64_t end_;
+  const std::uint64_t chunk_size_;
+  const std::uint64_t num_chunks_;
+  std::atomic<std::uint64_t> next_chunk_;
+};
+
+}  // namespace internal
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_SEED_CHUNKS_H_
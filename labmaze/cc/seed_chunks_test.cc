@@ -0,0 +1,70 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/seed_chunks.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+
+std::vector<std::pair<std::uint64_t, std::uint64_t>> ClaimAll(
+    SeedChunks* chunks) {
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> result;
+  std::uint64_t begin, end;
+  while (chunks->Next(&begin, &end)) {
+    result.emplace_back(begin, end);
+  }
+  return result;
+}
+
+TEST(SeedChunksTest, SplitsRange) {
+  SeedChunks chunks(3, 10, 3);
+  EXPECT_THAT(ClaimAll(&chunks),
+              ElementsAre(Pair(3, 6), Pair(6, 9), Pair(9, 10)));
+  std::uint64_t begin, end;
+  EXPECT_FALSE(chunks.Next(&begin, &end));
+}
+
+TEST(SeedChunksTest, EmptyRange) {
+  SeedChunks empty(5, 5, 4);
+  EXPECT_THAT(ClaimAll(&empty), IsEmpty());
+  SeedChunks reversed(6, 5, 4);
+  EXPECT_THAT(ClaimAll(&reversed), IsEmpty());
+}
+
+TEST(SeedChunksTest, EndsAtLargestSeed) {
+  constexpr std::uint64_t kMax = std::numeric_limits<std::uint64_t>::max();
+  SeedChunks chunks(kMax - 5, kMax, 4);
+  EXPECT_THAT(ClaimAll(&chunks),
+              ElementsAre(Pair(kMax - 5, kMax - 1), Pair(kMax - 1, kMax)));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace labmaze
+}  // namespace deepmind
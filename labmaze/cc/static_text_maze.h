@@ -0,0 +1,256 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#ifndef LABMAZE_CC_STATIC_TEXT_MAZE_H_
+#define LABMAZE_CC_STATIC_TEXT_MAZE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "labmaze/cc/logging.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// A maze with the cell interface of TextMaze and extents of H rows by W
+// columns fixed at compile time. Both layers and the id layer are stored
+// inline, so a StaticTextMaze never allocates and all index math is constant.
+// It is intended for the small mazes used in most tasks; a batch of them fits
+// in the L1 cache. All algorithm.h functions that take a maze accept it.
+template <int H, int W>
+class StaticTextMaze {
+ public:
+  static_assert(H > 0 && W > 0, "StaticTextMaze extents must be positive.");
+  static_assert(H * W <= 1 << 16, "StaticTextMaze is meant for small mazes.");
+
+  using Layer = TextMaze::Layer;
+  using Id = std::uint16_t;
+
+  // Creates a maze with the entity layer filled with '*', the variations layer
+  // filled with '.' and all ids set to 0.
+  StaticTextMaze() {
+    cells_[TextMaze::kEntityLayer].fill('*');
+    cells_[TextMaze::kVariationsLayer].fill('.');
+    ids_.fill(0);
+  }
+
+  // Copies both layers and the ids of 'maze', whose extents shall be H x W and
+  // whose ids shall not exceed MaxId().
+  explicit StaticTextMaze(const TextMaze& maze) {
+    CHECK_EQ(maze.Area().size.height, H);
+    CHECK_EQ(maze.Area().size.width, W);
+    for (Layer layer : {TextMaze::kEntityLayer, TextMaze::kVariationsLayer}) {
+      maze.VisitRows(layer, [this, layer](int i, int, const char* cells,
+                                          int count) {
+        std::copy_n(cells, count, &cells_[layer][Index(i, 0)]);
+      });
+    }
+    Area().Visit([this, &maze](int i, int j) {
+      SetCellId({i, j}, maze.GetCellId({i, j}));
+    });
+  }
+
+  // Returns a TextMaze with the same layers and ids.
+  TextMaze ToTextMaze() const {
+    TextMaze result({H, W}, MaxId());
+    for (Layer layer : {TextMaze::kEntityLayer, TextMaze::kVariationsLayer}) {
+      result.VisitMutableRows(layer, [this, layer](int i, int, char* cells,
+                                                   int count) {
+        std::copy_n(&cells_[layer][Index(i, 0)], count, cells);
+      });
+    }
+    Area().Visit([this, &result](int i, int j) {
+      result.SetCellId({i, j}, ids_[Index(i, j)]);
+    });
+    return result;
+  }
+
+  static constexpr Rectangle Area() { return {{0, 0}, {H, W}}; }
+
+  // Largest id the id layer can hold.
+  static constexpr unsigned int MaxId() {
+    return std::numeric_limits<Id>::max();
+  }
+
+  // See TextMaze::VisitIntersection.
+  template <typename F>
+  void VisitIntersection(Layer layer, const Rectangle& rect, F&& f) const {
+    const auto& cells = cells_[layer];
+    Overlap(Area(), rect).Visit([&cells, &f](int i, int j) {
+      f(i, j, cells[Index(i, j)]);
+    });
+  }
+
+  // See TextMaze::VisitMutableIntersection.
+  template <typename F>
+  void VisitMutableIntersection(Layer layer, const Rectangle& rect, F&& f) {
+    auto& cells = cells_[layer];
+    Overlap(Area(), rect).Visit([&cells, &f](int i, int j) {
+      f(i, j, &cells[Index(i, j)]);
+    });
+  }
+
+  template <typename F>
+  void Visit(Layer layer, F&& f) const {
+    VisitIntersection(layer, Area(), std::forward<F>(f));
+  }
+
+  template <typename F>
+  void VisitMutable(Layer layer, F&& f) {
+    VisitMutableIntersection(layer, Area(), std::forward<F>(f));
+  }
+
+  // See TextMaze::VisitRowsIntersection.
+  template <typename F>
+  void VisitRowsIntersection(Layer layer, const Rectangle& rect, F&& f) const {
+    const Rectangle overlap = Overlap(Area(), rect);
+    for (int i = overlap.pos.row; i < overlap.pos.row + overlap.size.height;
+         ++i) {
+      f(i, overlap.pos.col, &cells_[layer][Index(i, overlap.pos.col)],
+        overlap.size.width);
+    }
+  }
+
+  // See TextMaze::VisitMutableRowsIntersection.
+  template <typename F>
+  void VisitMutableRowsIntersection(Layer layer, const Rectangle& rect, F&& f) {
+    const Rectangle overlap = Overlap(Area(), rect);
+    for (int i = overlap.pos.row; i < overlap.pos.row + overlap.size.height;
+         ++i) {
+      f(i, overlap.pos.col, &cells_[layer][Index(i, overlap.pos.col)],
+        overlap.size.width);
+    }
+  }
+
+  template <typename F>
+  void VisitRows(Layer layer, F&& f) const {
+    VisitRowsIntersection(layer, Area(), std::forward<F>(f));
+  }
+
+  template <typename F>
+  void VisitMutableRows(Layer layer, F&& f) {
+    VisitMutableRowsIntersection(layer, Area(), std::forward<F>(f));
+  }
+
+  // See TextMaze::VisitMutableRowsWithIdsIntersection. 'ids' always points at
+  // const Id.
+  template <typename F>
+  void VisitMutableRowsWithIdsIntersection(Layer layer, const Rectangle& rect,
+                                           F&& f) {
+    VisitMutableRowsIntersection(
+        layer, rect, [this, &f](int i, int j, char* cells, int count) {
+          f(i, j, cells, &ids_[Index(i, j)], count);
+        });
+  }
+
+  // Like VisitMutableIntersection but calls f(i, j, cell, id), where 'id' is
+  // the id at (i, j) as an unsigned int.
+  template <typename F>
+  void VisitMutableWithIdsIntersection(Layer layer, const Rectangle& rect,
+                                       F&& f) {
+    VisitMutableRowsWithIdsIntersection(
+        layer, rect,
+        [&f](int i, int j, char* cells, const auto* ids, int count) {
+          for (int k = 0; k < count; ++k) {
+            f(i, j + k, cells + k, static_cast<unsigned int>(ids[k]));
+          }
+        });
+  }
+
+  // Returns the character at 'pos', or '\0' if 'pos' is out of bounds.
+  char GetCell(Layer layer, Pos pos) const {
+    return Area().InBounds(pos) ? cells_[layer][Index(pos.row, pos.col)]
+                                : '\0';
+  }
+
+  // Sets the character at 'pos' if 'pos' is in bounds.
+  void SetCell(Layer layer, Pos pos, char value) {
+    if (Area().InBounds(pos)) {
+      cells_[layer][Index(pos.row, pos.col)] = value;
+    }
+  }
+
+  void FillRect(Layer layer, const Rectangle& rect, char value) {
+    VisitMutableIntersection(layer, rect,
+                             [value](int, int, char* c) { *c = value; });
+  }
+
+  // Returns the id at 'pos', or 0 if 'pos' is out of bounds.
+  unsigned int GetCellId(Pos pos) const {
+    return Area().InBounds(pos) ? ids_[Index(pos.row, pos.col)] : 0;
+  }
+
+  // Sets the id at 'pos' if 'pos' is in bounds. 'id' shall not exceed MaxId().
+  void SetCellId(Pos pos, unsigned int id) {
+    if (id > MaxId()) {
+      IdOutOfRange(id);
+    }
+    if (Area().InBounds(pos)) {
+      ids_[Index(pos.row, pos.col)] = id;
+    }
+  }
+
+  // See TextMaze::BorderedLayer.
+  BorderedGrid<char> BorderedLayer(Layer layer, char border) const {
+    BorderedGrid<char> grid(Area().size, border, border);
+    for (int i = 0; i < H; ++i) {
+      std::copy_n(&cells_[layer][Index(i, 0)], W, &grid[grid.Index(i, 0)]);
+    }
+    return grid;
+  }
+
+  // See TextMaze::AssignLayer.
+  void AssignLayer(Layer layer, const BorderedGrid<char>& grid) {
+    CHECK_EQ(grid.size().height, H);
+    CHECK_EQ(grid.size().width, W);
+    for (int i = 0; i < H; ++i) {
+      std::copy_n(&grid[grid.Index(i, 0)], W, &cells_[layer][Index(i, 0)]);
+    }
+  }
+
+  // Returns the text of 'layer' in the format of TextMaze::Text.
+  std::string Text(Layer layer) const {
+    std::string text;
+    text.reserve(H * (W + 1));
+    for (int i = 0; i < H; ++i) {
+      text.append(&cells_[layer][Index(i, 0)], W);
+      text.push_back('\n');
+    }
+    return text;
+  }
+
+ private:
+  static constexpr int Index(int i, int j) { return i * W + j; }
+
+  [[noreturn]] static void IdOutOfRange(unsigned int id);
+
+  std::array<std::array<char, H * W>, 2> cells_;
+  std::array<Id, H * W> ids_;
+};
+
+template <int H, int W>
+void StaticTextMaze<H, W>::IdOutOfRange(unsigned int id) {
+  LOG(FATAL) << "Id " << id << " exceeds the maximum id " << MaxId() << ".";
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_STATIC_TEXT_MAZE_H_
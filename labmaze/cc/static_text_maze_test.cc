@@ -0,0 +1,139 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/static_text_maze.h"
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using SmallMaze = StaticTextMaze<15, 17>;
+
+static_assert(std::is_trivially_copyable<SmallMaze>::value,
+              "StaticTextMaze shall not own heap storage.");
+
+TextMaze MakeMaze() {
+  RandomMazeParams params;
+  params.height = 15;
+  params.width = 17;
+  params.objects_per_room = 1;
+  const RandomMaze random_maze(params, 3);
+  // Rebuilds the maze, as RandomMaze releases its id layer.
+  return FromCharGrid(CharGrid(random_maze.EntityLayer()),
+                      CharGrid(random_maze.VariationsLayer()));
+}
+
+TEST(StaticTextMazeTest, Defaults) {
+  SmallMaze maze;
+  TextMaze text_maze({15, 17});
+  EXPECT_EQ(text_maze.Text(TextMaze::kEntityLayer),
+            maze.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(text_maze.Text(TextMaze::kVariationsLayer),
+            maze.Text(TextMaze::kVariationsLayer));
+  EXPECT_EQ(0, maze.GetCellId({3, 4}));
+  EXPECT_EQ('\0', maze.GetCell(TextMaze::kEntityLayer, {15, 0}));
+}
+
+TEST(StaticTextMazeTest, TextMazeRoundTrip) {
+  TextMaze text_maze = MakeMaze();
+  text_maze.SetCellId({2, 3}, 7);
+  const SmallMaze maze(text_maze);
+  EXPECT_EQ(text_maze.Text(TextMaze::kEntityLayer),
+            maze.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(text_maze.Text(TextMaze::kVariationsLayer),
+            maze.Text(TextMaze::kVariationsLayer));
+  EXPECT_EQ(7, maze.GetCellId({2, 3}));
+
+  const TextMaze copy = maze.ToTextMaze();
+  EXPECT_EQ(text_maze.Text(TextMaze::kEntityLayer),
+            copy.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(text_maze.Text(TextMaze::kVariationsLayer),
+            copy.Text(TextMaze::kVariationsLayer));
+  EXPECT_EQ(7, copy.GetCellId({2, 3}));
+}
+
+TEST(StaticTextMazeTest, FindRoomsMatchesTextMaze) {
+  const TextMaze text_maze = MakeMaze();
+  const auto expected = FindRooms(text_maze, {'*'});
+  const auto actual = FindRooms(SmallMaze(text_maze), {'*'});
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i].size(), actual[i].size());
+    for (std::size_t j = 0; j < expected[i].size(); ++j) {
+      EXPECT_EQ(expected[i][j], actual[i][j]);
+    }
+  }
+}
+
+TEST(StaticTextMazeTest, GenerationMatchesTextMaze) {
+  const Rectangle room{{3, 5}, {5, 5}};
+  TextMaze text_maze({15, 17});
+  SmallMaze maze;
+  text_maze.FillRect(TextMaze::kEntityLayer, room, ' ');
+  maze.FillRect(TextMaze::kEntityLayer, room, ' ');
+  room.Visit([&text_maze, &maze](int i, int j) {
+    text_maze.SetCellId({i, j}, 1);
+    maze.SetCellId({i, j}, 1);
+  });
+
+  std::mt19937_64 text_maze_rng(5);
+  std::mt19937_64 rng(5);
+  FillSpaceWithMaze(2, 0, &text_maze, &text_maze_rng);
+  FillSpaceWithMaze(2, 0, &maze, &rng);
+  RandomConnectRegions('D', 0.1, &text_maze, &text_maze_rng);
+  RandomConnectRegions('D', 0.1, &maze, &rng);
+  RemoveDeadEnds(' ', '*', {}, &text_maze);
+  RemoveDeadEnds(' ', '*', {}, &maze);
+  RemoveAllHorseshoeBends('*', {}, &text_maze);
+  RemoveAllHorseshoeBends('*', {}, &maze);
+  AddNEntitiesToEachRoom({room}, 2, 'G', ' ', &text_maze, &text_maze_rng);
+  AddNEntitiesToEachRoom({room}, 2, 'G', ' ', &maze, &rng);
+  EXPECT_EQ(text_maze.Text(TextMaze::kEntityLayer),
+            maze.Text(TextMaze::kEntityLayer));
+
+  const auto expected_path =
+      FindRandomPath({4, 6}, {1, 1}, {'*'}, &text_maze, &text_maze_rng);
+  const auto path = FindRandomPath({4, 6}, {1, 1}, {'*'}, &maze, &rng);
+  ASSERT_EQ(expected_path.size(), path.size());
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    EXPECT_EQ(expected_path[i], path[i]);
+  }
+}
+
+TEST(StaticTextMazeDeathTest, WrongExtents) {
+  EXPECT_DEATH(SmallMaze(TextMaze({15, 16})), "");
+}
+
+TEST(StaticTextMazeDeathTest, IdOutOfRange) {
+  SmallMaze maze;
+  maze.SetCellId({1, 1}, SmallMaze::MaxId());
+  EXPECT_EQ(SmallMaze::MaxId(), maze.GetCellId({1, 1}));
+  EXPECT_DEATH(maze.SetCellId({1, 1}, SmallMaze::MaxId() + 1),
+               "exceeds the maximum id");
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
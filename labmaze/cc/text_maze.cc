@@ -15,20 +15,142 @@
 
 #include "labmaze/cc/text_maze.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "labmaze/cc/logging.h"
+
 namespace deepmind {
 namespace labmaze {
 
-TextMaze::TextMaze(Size extents) : area_{{0, 0}, extents} {
-  std::string level_layer(area_.size.height * (area_.size.width + 1), '*');
-  std::string variations_layer(area_.size.height * (area_.size.width + 1), '.');
+TextMaze::TextMaze(Size extents)
+    : area_{{0, 0}, extents},
+      id_bytes_(0),
+      max_id_(std::numeric_limits<unsigned int>::max()),
+      id_capacity_(0) {
+  text_[kEntityLayer] = DefaultText('*');
+}
+
+TextMaze::TextMaze(Size extents, unsigned int max_id)
+    : area_{{0, 0}, extents},
+      id_bytes_(0),
+      max_id_(max_id > 0 ? max_id : std::numeric_limits<unsigned int>::max()),
+      id_capacity_(0) {
+  text_[kEntityLayer] = DefaultText('*');
+  if (max_id > 0) {
+    WidenIds(max_id);
+  }
+}
+
+std::string TextMaze::DefaultText(char value) const {
+  std::string text(area_.size.height * (area_.size.width + 1), value);
+  for (int i = 0; i < area_.size.height; ++i) {
+    text[ToTextIdx(i, area_.size.width)] = '\n';
+  }
+  return text;
+}
+
+const std::string& TextMaze::Text(Layer layer) const {
+  const auto& text = text_[layer];
+  if (layer == kEntityLayer || !text.empty()) {
+    return text;
+  }
+  if (default_text_.empty()) {
+    default_text_ = DefaultText('.');
+  }
+  return default_text_;
+}
+
+BorderedGrid<char> TextMaze::BorderedLayer(Layer layer, char border) const {
+  BorderedGrid<char> grid(area_.size, border, '.');
+  const auto& text = text_[layer];
+  if (!text.empty()) {
+    for (int i = 0; i < area_.size.height; ++i) {
+      std::copy_n(text.begin() + ToTextIdx(i, 0), area_.size.width,
+                  &grid[grid.Index(i, 0)]);
+    }
+  }
+  return grid;
+}
+
+void TextMaze::AssignLayer(Layer layer, const BorderedGrid<char>& grid) {
+  CHECK_EQ(grid.size().height, area_.size.height);
+  CHECK_EQ(grid.size().width, area_.size.width);
+  auto& text = MutableText(layer);
   for (int i = 0; i < area_.size.height; ++i) {
-    int text_idx = ToTextIdx(i, area_.size.width);
-    level_layer[text_idx] = '\n';
-    variations_layer[text_idx] = '\n';
+    std::copy_n(&grid[grid.Index(i, 0)], area_.size.width,
+                text.begin() + ToTextIdx(i, 0));
   }
-  text_[kEntityLayer] = std::move(level_layer);
-  text_[kVariationsLayer] = std::move(variations_layer);
-  ids_.assign(area_.size.height * area_.size.width, 0);
+}
+
+TiledGrid<char> TextMaze::TiledLayer(Layer layer, char border) const {
+  TiledGrid<char> grid(area_.size, border, border);
+  VisitRows(layer, [&grid](int i, int j, const char* cells, int count) {
+    for (int k = 0; k < count; ++k) {
+      grid[grid.Index(i, j + k)] = cells[k];
+    }
+  });
+  return grid;
+}
+
+void TextMaze::ReleaseIds() {
+  ids8_ = {};
+  ids16_ = {};
+  ids32_ = {};
+  id_bytes_ = 0;
+  max_id_ = std::numeric_limits<unsigned int>::max();
+  id_capacity_ = 0;
+}
+
+void TextMaze::WidenIds(unsigned int id) {
+  if (id > max_id_) {
+    IdOutOfRange(id);
+  }
+  const std::size_t num_cells = area_.Area();
+  if (id <= std::numeric_limits<std::uint8_t>::max()) {
+    if (id_bytes_ == 0) {
+      ids8_.assign(num_cells, 0);
+      id_bytes_ = 1;
+    }
+    id_capacity_ = std::min<unsigned int>(
+        max_id_, std::numeric_limits<std::uint8_t>::max());
+  } else if (id <= std::numeric_limits<std::uint16_t>::max()) {
+    if (id_bytes_ < 2) {
+      if (id_bytes_ == 1) {
+        ids16_.assign(ids8_.begin(), ids8_.end());
+      } else {
+        ids16_.assign(num_cells, 0);
+      }
+      ids8_ = {};
+      id_bytes_ = 2;
+    }
+    id_capacity_ = std::min<unsigned int>(
+        max_id_, std::numeric_limits<std::uint16_t>::max());
+  } else {
+    if (id_bytes_ == 1) {
+      ids32_.assign(ids8_.begin(), ids8_.end());
+    } else if (id_bytes_ == 2) {
+      ids32_.assign(ids16_.begin(), ids16_.end());
+    } else if (id_bytes_ == 0) {
+      ids32_.assign(num_cells, 0);
+    }
+    ids8_ = {};
+    ids16_ = {};
+    id_bytes_ = 4;
+    id_capacity_ = max_id_;
+  }
+}
+
+void TextMaze::IdOutOfRange(unsigned int id) const {
+  LOG(FATAL) << "Id " << id << " exceeds the maximum id " << max_id_ << ".";
 }
 
 enum OrthoRotation {
@@ -102,29 +224,316 @@ static OrthoRotation CalcOrthoRotation(int rotation) {
       modRotation < 0 ? modRotation + kNumOrthoRotations : modRotation);
 }
 
-TextMaze TextMaze::Rotate(int rotation) const {
-  // There are four possible rotations. Ignore the one that's identity.
+namespace internal {
+
+RotationMap MakeRotationMap(int rotation, Size extents) {
   const OrthoRotation ortho = CalcOrthoRotation(rotation);
   const RotationMatrix2D& r = ROTATION_MATRICES_2D[ortho];
+  const bool even = rotation % 2 == 0;
+  const Size rotated_extents{even ? extents.height : extents.width,
+                             even ? extents.width : extents.height};
+  return {rotated_extents,
+          {r[2][0] * (rotated_extents.height - 1),
+           r[2][1] * (rotated_extents.width - 1)},
+          {r[0][0], r[0][1]},
+          {r[1][0], r[1][1]}};
+}
 
-  const Size extents{
-      rotation % 2 == 0 ? area_.size.height : area_.size.width,
-      rotation % 2 == 0 ? area_.size.width : area_.size.height};
-  TextMaze m(extents);
+}  // namespace internal
+
+TextMaze TextMaze::Rotate(int rotation) const {
+  const internal::RotationMap map =
+      internal::MakeRotationMap(rotation, area_.size);
+  // A maze whose id layer widens on demand is rotated into another such maze.
+  TextMaze m = id_capacity_ < max_id_ ? TextMaze(map.extents)
+                                      : TextMaze(map.extents, max_id_);
+  const bool has_variations = HasVariations();
 
   // Fill in the new maze with the rotated values.
   Visit(kEntityLayer, [&](int i, int j, char entityValue) {
     const Pos oldPos{i, j};
-    const Pos newPos{
-      r[0][0] * i + r[1][0] * j + r[2][0] * (extents.height - 1),
-      r[0][1] * i + r[1][1] * j + r[2][1] * (extents.width - 1)
-    };
+    const Pos newPos = map.Apply(i, j);
     m.SetCell(kEntityLayer, newPos, entityValue);
-    m.SetCell(kVariationsLayer, newPos, GetCell(kVariationsLayer, oldPos));
+    if (has_variations) {
+      m.SetCell(kVariationsLayer, newPos, GetCell(kVariationsLayer, oldPos));
+    }
     m.SetCellId(newPos, GetCellId(oldPos));
   });
   return m;
 }
 
+namespace {
+
+// Serialized layout:
+//   version byte, varint height, varint width,
+//   wall bitmap of the entity layer (row-major, least significant bit first),
+//   runs of the non-wall entity cells,
+//   runs of the variations layer.
+// Runs are a varint dictionary size, the dictionary characters, then pairs of
+// (varint run length, dictionary index byte) until all cells are covered.
+constexpr unsigned char kSerializationVersion = 1;
+constexpr char kWall = '*';
+
+void PutVarint(std::uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+bool GetVarint(const std::string& data, std::size_t* pos,
+               std::uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *pos < data.size(); shift += 7) {
+    const auto byte = static_cast<unsigned char>(data[(*pos)++]);
+    *value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+// Appends the runs of the cells of 'layer' for which 'selected(c)' is true.
+template <typename F>
+void PutRuns(const TextMaze& maze, TextMaze::Layer layer, F&& selected,
+             std::string* out) {
+  std::array<int, 256> index;
+  index.fill(-1);
+  std::string dictionary;
+  maze.Visit(layer, [&index, &dictionary, &selected](int, int, char c) {
+    auto& idx = index[static_cast<unsigned char>(c)];
+    if (idx < 0 && selected(c)) {
+      idx = dictionary.size();
+      dictionary.push_back(c);
+    }
+  });
+  PutVarint(dictionary.size(), out);
+  out->append(dictionary);
+
+  std::uint64_t run = 0;
+  char run_char = '\0';
+  auto put_run = [&index, &run, &run_char, out]() {
+    PutVarint(run, out);
+    out->push_back(
+        static_cast<char>(index[static_cast<unsigned char>(run_char)]));
+  };
+  maze.Visit(layer, [&run, &run_char, &selected, &put_run](int, int, char c) {
+    if (!selected(c)) return;
+    if (run > 0 && c != run_char) {
+      put_run();
+      run = 0;
+    }
+    run_char = c;
+    ++run;
+  });
+  if (run > 0) put_run();
+}
+
+// Reads runs from 'data' and writes them to the cells pointed at by 'cells'.
+bool GetRuns(const std::string& data, std::size_t* pos,
+             const std::vector<char*>& cells) {
+  std::uint64_t dictionary_size;
+  if (!GetVarint(data, pos, &dictionary_size) || dictionary_size > 256 ||
+      data.size() - *pos < dictionary_size) {
+    return false;
+  }
+  const std::string dictionary = data.substr(*pos, dictionary_size);
+  *pos += dictionary_size;
+  std::size_t cell = 0;
+  while (cell < cells.size()) {
+    std::uint64_t run;
+    if (!GetVarint(data, pos, &run) || run == 0 ||
+        run > cells.size() - cell || *pos >= data.size()) {
+      return false;
+    }
+    const auto idx = static_cast<unsigned char>(data[(*pos)++]);
+    if (idx >= dictionary.size()) return false;
+    for (; run > 0; --run) {
+      *cells[cell++] = dictionary[idx];
+    }
+  }
+  return true;
+}
+
+// Calls f(idx) for every idx, in ascending order, where lhs[idx] != rhs[idx].
+// Both strings must have the same size. Equal blocks are skipped with one
+// comparison each.
+template <typename F>
+void VisitMismatches(const std::string& lhs, const std::string& rhs, F&& f) {
+  const char* a = lhs.data();
+  const char* b = rhs.data();
+  const std::size_t size = lhs.size();
+  std::size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    const __m128i block_a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i block_b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    unsigned int mismatches =
+        ~_mm_movemask_epi8(_mm_cmpeq_epi8(block_a, block_b)) & 0xFFFF;
+    while (mismatches != 0) {
+      f(i + __builtin_ctz(mismatches));
+      mismatches &= mismatches - 1;
+    }
+  }
+#else
+  for (; i + 8 <= size; i += 8) {
+    std::uint64_t block_a, block_b;
+    std::memcpy(&block_a, a + i, 8);
+    std::memcpy(&block_b, b + i, 8);
+    if (block_a == block_b) continue;
+    for (std::size_t j = i; j < i + 8; ++j) {
+      if (a[j] != b[j]) f(j);
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    if (a[i] != b[i]) f(i);
+  }
+}
+
+}  // namespace
+
+std::string TextMaze::Serialize() const {
+  std::string out;
+  out.push_back(static_cast<char>(kSerializationVersion));
+  PutVarint(area_.size.height, &out);
+  PutVarint(area_.size.width, &out);
+
+  const std::size_t bitmap_pos = out.size();
+  out.resize(bitmap_pos + (area_.Area() + 7) / 8, '\0');
+  int cell = 0;
+  Visit(kEntityLayer, [&out, &cell, bitmap_pos](int, int, char c) {
+    if (c == kWall) {
+      out[bitmap_pos + cell / 8] |= static_cast<char>(1 << (cell % 8));
+    }
+    ++cell;
+  });
+
+  PutRuns(*this, kEntityLayer, [](char c) { return c != kWall; }, &out);
+  PutRuns(*this, kVariationsLayer, [](char) { return true; }, &out);
+  return out;
+}
+
+bool TextMaze::Deserialize(const std::string& data, TextMaze* maze) {
+  std::size_t pos = 0;
+  if (data.empty() ||
+      static_cast<unsigned char>(data[pos++]) != kSerializationVersion) {
+    return false;
+  }
+  std::uint64_t height, width;
+  if (!GetVarint(data, &pos, &height) || !GetVarint(data, &pos, &width) ||
+      height > (1 << 20) || width > (1 << 20) ||
+      (data.size() - pos) * 8 < height * width) {
+    return false;
+  }
+  TextMaze result(Size{static_cast<int>(height), static_cast<int>(width)});
+
+  const std::size_t bitmap_pos = pos;
+  pos += (height * width + 7) / 8;
+  std::vector<char*> open_cells;
+  int cell = 0;
+  result.VisitMutable(
+      kEntityLayer, [&data, &open_cells, &cell, bitmap_pos](int, int, char* c) {
+        if ((data[bitmap_pos + cell / 8] >> (cell % 8)) & 1) {
+          *c = kWall;
+        } else {
+          open_cells.push_back(c);
+        }
+        ++cell;
+      });
+  if (!GetRuns(data, &pos, open_cells)) return false;
+
+  std::vector<char*> variation_cells;
+  variation_cells.reserve(height * width);
+  result.VisitMutable(kVariationsLayer,
+                      [&variation_cells](int, int, char* c) {
+                        variation_cells.push_back(c);
+                      });
+  if (!GetRuns(data, &pos, variation_cells) || pos != data.size()) {
+    return false;
+  }
+  *maze = std::move(result);
+  return true;
+}
+
+// Diff layout:
+//   varint height, varint width, then for each layer:
+//   varint number of changes, then pairs of (varint gap, new character), where
+//   gap is the number of unchanged text positions since the previous change.
+std::string TextMaze::Diff(const TextMaze& target) const {
+  CHECK_EQ(area_.size.height, target.area_.size.height);
+  CHECK_EQ(area_.size.width, target.area_.size.width);
+  std::string out;
+  PutVarint(area_.size.height, &out);
+  PutVarint(area_.size.width, &out);
+  std::vector<std::size_t> changes;
+  for (auto layer : {kEntityLayer, kVariationsLayer}) {
+    if (text_[layer].empty() && target.text_[layer].empty()) {
+      PutVarint(0, &out);
+      continue;
+    }
+    // Only an unallocated variations layer needs its default text.
+    const std::string default_text =
+        text_[layer].empty() || target.text_[layer].empty() ? DefaultText('.')
+                                                            : std::string();
+    const std::string& text =
+        text_[layer].empty() ? default_text : text_[layer];
+    const std::string& target_text =
+        target.text_[layer].empty() ? default_text : target.text_[layer];
+    changes.clear();
+    VisitMismatches(text, target_text,
+                    [&changes](std::size_t idx) { changes.push_back(idx); });
+    PutVarint(changes.size(), &out);
+    std::size_t next = 0;
+    for (auto idx : changes) {
+      PutVarint(idx - next, &out);
+      out.push_back(target_text[idx]);
+      next = idx + 1;
+    }
+  }
+  return out;
+}
+
+bool TextMaze::ApplyDiff(const std::string& diff) {
+  std::size_t pos = 0;
+  std::uint64_t height, width;
+  if (!GetVarint(diff, &pos, &height) || !GetVarint(diff, &pos, &width) ||
+      height != static_cast<std::uint64_t>(area_.size.height) ||
+      width != static_cast<std::uint64_t>(area_.size.width)) {
+    return false;
+  }
+  // Validate the whole diff before changing any cell.
+  std::array<std::vector<std::pair<std::size_t, char>>, 2> changes;
+  const std::size_t text_size = area_.size.height * (width + 1);
+  for (auto layer : {kEntityLayer, kVariationsLayer}) {
+    std::uint64_t count;
+    if (!GetVarint(diff, &pos, &count) || count > text_size) return false;
+    changes[layer].reserve(count);
+    std::uint64_t next = 0;
+    for (std::uint64_t k = 0; k < count; ++k) {
+      std::uint64_t gap;
+      if (!GetVarint(diff, &pos, &gap) || gap >= text_size - next ||
+          pos >= diff.size()) {
+        return false;
+      }
+      const std::size_t idx = next + gap;
+      if (idx % (width + 1) == width) return false;  // New-line position.
+      changes[layer].emplace_back(idx, diff[pos++]);
+      next = idx + 1;
+    }
+  }
+  if (pos != diff.size()) return false;
+  for (auto layer : {kEntityLayer, kVariationsLayer}) {
+    if (changes[layer].empty()) continue;
+    auto& text = MutableText(layer);
+    for (const auto& change : changes[layer]) {
+      text[change.first] = change.second;
+    }
+  }
+  return true;
+}
+
 }  // namespace labmaze
 }  // namespace deepmind
@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -116,8 +118,209 @@ inline bool IsSeparate(const Rectangle& lhs, const Rectangle& rhs) {
           rhs.pos.col + rhs.size.width <= lhs.pos.col);
 }
 
+// A row-major grid of 'size' cells surrounded by a one-cell border, so that the
+// four neighbours of every cell inside the grid can be read and written without
+// bounds checks. Cells are addressed by flat indices with a row stride of
+// size.width + 2.
+template <typename T>
+class BorderedGrid {
+ public:
+  // Creates a grid with all cells set to 'fill' and all border cells set to
+  // 'border'.
+  BorderedGrid(Size size, T border, T fill)
+      : size_(size),
+        stride_(size.width + 2),
+        cells_((size.height + 2) * stride_, border) {
+    for (int i = 0; i < size.height; ++i) {
+      std::fill_n(cells_.begin() + Index(i, 0), size.width, fill);
+    }
+  }
+
+  const Size& size() const { return size_; }
+  int stride() const { return stride_; }
+
+  // Returns the flat index of cell (row, col). 'row' and 'col' may be one
+  // outside the grid to address border cells.
+  int Index(int row, int col) const { return (row + 1) * stride_ + col + 1; }
+
+  // Inverse of Index.
+  Pos ToPos(int index) const {
+    return {index / stride_ - 1, index % stride_ - 1};
+  }
+
+  // Index offsets of the neighbours above, below, left and right of a cell, in
+  // the order of Rectangle::VisitNeighbours.
+  std::array<int, 4> NeighbourOffsets() const {
+    return {{-stride_, stride_, -1, 1}};
+  }
+
+  // Returns the indices of the neighbours of the cell at 'index', which shall
+  // be inside the grid, in the order of NeighbourOffsets.
+  std::array<int, 4> Neighbours(int index) const {
+    return {{index - stride_, index + stride_, index - 1, index + 1}};
+  }
+
+  T& operator[](int index) { return cells_[index]; }
+  const T& operator[](int index) const { return cells_[index]; }
+
+ private:
+  Size size_;
+  int stride_;
+  std::vector<T> cells_;
+};
+
+namespace internal {
+
+// Neighbour index offsets of the cells of a tile of 2^kTileBits x 2^kTileBits
+// cells, in the order of Rectangle::VisitNeighbours, by position in the tile.
+// Steps off the top or bottom of a tile also move by 'tile_rows' rows of
+// tiles, which depends on the width of the grid.
+template <int kTileBits>
+struct TileNeighbours {
+  static constexpr int kTileSize = 1 << kTileBits;
+  static constexpr int kInTileMask = kTileSize - 1;
+  static constexpr int kTileArea = kTileSize * kTileSize;
+
+  constexpr TileNeighbours() : offsets(), tile_rows() {
+    for (int k = 0; k < kTileArea; ++k) {
+      const int row = k >> kTileBits;
+      const int col = k & kInTileMask;
+      offsets[k][0] = row != 0 ? -kTileSize : kTileArea - kTileSize;
+      offsets[k][1] = row != kInTileMask ? kTileSize : kTileSize - kTileArea;
+      offsets[k][2] = col != 0 ? -1 : kInTileMask - kTileArea;
+      offsets[k][3] = col != kInTileMask ? 1 : kTileArea - kInTileMask;
+      tile_rows[k][0] = row != 0 ? 0 : -1;
+      tile_rows[k][1] = row != kInTileMask ? 0 : 1;
+    }
+  }
+
+  int offsets[kTileArea][4];
+  int tile_rows[kTileArea][2];
+};
+
+}  // namespace internal
+
+// A grid with the interface of BorderedGrid, except for NeighbourOffsets, that
+// stores its cells in 8x8 tiles instead of rows. Each tile is contiguous and
+// tiles are stored row-major, so vertical neighbours usually share a cache
+// line or two instead of being a row apart. This suits searches on large mazes
+// whose frontier moves in all directions. The border is padded up to whole
+// tiles.
+template <typename T>
+class TiledGrid {
+ public:
+  static constexpr int kTileBits = 3;
+  static constexpr int kTileSize = 1 << kTileBits;
+
+  // Creates a grid with all cells set to 'fill' and all border cells set to
+  // 'border'.
+  TiledGrid(Size size, T border, T fill)
+      : size_(size),
+        tiles_per_row_((size.width + 2 + kTileSize - 1) / kTileSize),
+        tile_row_stride_(tiles_per_row_ * kTileSize * kTileSize),
+        tiles_per_row_shift_(kMaxTileBits + CeilLog2(tiles_per_row_)),
+        tiles_per_row_reciprocal_(
+            (std::uint64_t{1} << tiles_per_row_shift_) / tiles_per_row_ + 1),
+        cells_((size.height + 2 + kTileSize - 1) / kTileSize *
+                   tile_row_stride_,
+               border) {
+    for (int i = 0; i < size.height; ++i) {
+      for (int j = 0; j < size.width; ++j) {
+        cells_[Index(i, j)] = fill;
+      }
+    }
+  }
+
+  const Size& size() const { return size_; }
+
+  // Returns the flat index of cell (row, col). 'row' and 'col' may be one
+  // outside the grid to address border cells.
+  int Index(int row, int col) const {
+    ++row;
+    ++col;
+    return (row >> kTileBits) * tile_row_stride_ +
+           ((col >> kTileBits) << (2 * kTileBits)) +
+           ((row & kInTileMask) << kTileBits) + (col & kInTileMask);
+  }
+
+  // Inverse of Index.
+  Pos ToPos(int index) const {
+    const int tile = index >> (2 * kTileBits);
+    // tile / tiles_per_row_ without a division, which would dominate
+    // FloodFill.
+    const int tile_row = (tile * tiles_per_row_reciprocal_) >>
+                         tiles_per_row_shift_;
+    const int tile_col = tile - tile_row * tiles_per_row_;
+    return {(tile_row << kTileBits) + ((index >> kTileBits) & kInTileMask) - 1,
+            (tile_col << kTileBits) + (index & kInTileMask) - 1};
+  }
+
+  // Returns the indices of the neighbours of the cell at 'index', which shall
+  // be inside the grid, in the order of Rectangle::VisitNeighbours.
+  std::array<int, 4> Neighbours(int index) const {
+    const int k = index & (kTileArea - 1);
+    const auto& offsets = kNeighbours.offsets[k];
+    const auto& tile_rows = kNeighbours.tile_rows[k];
+    return {{index + offsets[0] + tile_rows[0] * tile_row_stride_,
+             index + offsets[1] + tile_rows[1] * tile_row_stride_,
+             index + offsets[2], index + offsets[3]}};
+  }
+
+  T& operator[](int index) { return cells_[index]; }
+  const T& operator[](int index) const { return cells_[index]; }
+
+ private:
+  static constexpr int kInTileMask = kTileSize - 1;
+  static constexpr int kTileArea = kTileSize * kTileSize;
+  // Tile numbers are below 2^kMaxTileBits as indices are ints.
+  static constexpr int kMaxTileBits = 31 - 2 * kTileBits;
+  // Shared by all grids, so that it stays in the cache.
+  static constexpr internal::TileNeighbours<kTileBits> kNeighbours{};
+
+  static int CeilLog2(int value) {
+    int log2 = 0;
+    while ((1 << log2) < value) {
+      ++log2;
+    }
+    return log2;
+  }
+
+  Size size_;
+  int tiles_per_row_;
+  int tile_row_stride_;
+  // Round-up reciprocal of tiles_per_row_, which divides exactly any tile
+  // number by multiplying and shifting.
+  int tiles_per_row_shift_;
+  std::uint64_t tiles_per_row_reciprocal_;
+  std::vector<T> cells_;
+};
+
+template <typename T>
+constexpr internal::TileNeighbours<TiledGrid<T>::kTileBits>
+    TiledGrid<T>::kNeighbours;
+
+namespace internal {
+
+// The cell mapping of TextMaze::Rotate: cell (i, j) of the source maze moves to
+// Apply(i, j) in the rotated maze of 'extents'.
+struct RotationMap {
+  Size extents;
+  Pos origin;
+  Vec row_step;
+  Vec col_step;
+
+  Pos Apply(int i, int j) const { return origin + i * row_step + j * col_step; }
+};
+
+// Returns the mapping of 'rotation' clockwise rotations of a maze of 'extents'.
+RotationMap MakeRotationMap(int rotation, Size extents);
+
+}  // namespace internal
+
 // Wrapper around strings that represent the entity layer and variations layer,
 // allowing mutable access to characters (cells) in these strings.
+// The variations layer is only allocated once it is first modified, and the id
+// layer is stored with the narrowest integer type that holds its largest id.
 class TextMaze {
  public:
   // Selects which layer to apply operations to.
@@ -127,13 +330,24 @@ class TextMaze {
   // 'extents'. Each layer is constructed as a new-line separated block of text.
   // Each layer starts filled with a default character. For the entity layer it
   // is '*' and for the variations layer it is '.'.
+  // All ids start as 0. The id layer is allocated when the first id is set and
+  // widened as larger ids are set, so mazes without ids carry no id layer.
   explicit TextMaze(Size extents);
 
+  // As above, but ids shall not exceed 'max_id' and are stored in the
+  // narrowest type that holds it from the start. A 'max_id' of 0 allocates
+  // nothing and widens on demand, as above.
+  TextMaze(Size extents, unsigned int max_id);
+
   // Calls f(i, j, cell) for each cell (i, j) in the intersection of the maze
   // and rect.
   template <typename F>
   void VisitIntersection(Layer layer, const Rectangle& rect, F&& f) const {
     const auto& text = text_[layer];
+    if (text.empty()) {
+      Overlap(Area(), rect).Visit([&f](int i, int j) { f(i, j, '.'); });
+      return;
+    }
     Overlap(Area(), rect).Visit([this, &text, &f](int i, int j) {
       f(i, j, text[ToTextIdx(i, j)]);
     });
@@ -142,7 +356,7 @@ class TextMaze {
   // Mutable variant of VisitIntersection.
   template <typename F>
   void VisitMutableIntersection(Layer layer, const Rectangle& rect, F&& f) {
-    auto& text = text_[layer];
+    auto& text = MutableText(layer);
     Overlap(Area(), rect).Visit([this, &text, &f](int i, int j) {
       f(i, j, &text[ToTextIdx(i, j)]);
     });
@@ -160,11 +374,98 @@ class TextMaze {
     VisitMutableIntersection(layer, Area(), std::forward<F>(f));
   }
 
+  // Calls f(i, j, cells, count) for each row i of the intersection of the maze
+  // and 'rect', where 'cells' points at the 'count' contiguous cells of 'layer'
+  // starting at column j. Unlike VisitIntersection, the inner loop is left to
+  // 'f', which lets the compiler vectorize bulk passes.
+  template <typename F>
+  void VisitRowsIntersection(Layer layer, const Rectangle& rect, F&& f) const {
+    const Rectangle overlap = Overlap(Area(), rect);
+    if (overlap.Area() == 0) {
+      return;
+    }
+    const int col = overlap.pos.col;
+    const int count = overlap.size.width;
+    const auto& text = text_[layer];
+    const std::string default_row = text.empty() ? std::string(count, '.') : "";
+    for (int i = overlap.pos.row; i < overlap.pos.row + overlap.size.height;
+         ++i) {
+      f(i, col, text.empty() ? default_row.data() : &text[ToTextIdx(i, col)],
+        count);
+    }
+  }
+
+  // Mutable variant of VisitRowsIntersection.
+  template <typename F>
+  void VisitMutableRowsIntersection(Layer layer, const Rectangle& rect, F&& f) {
+    const Rectangle overlap = Overlap(Area(), rect);
+    if (overlap.Area() == 0) {
+      return;
+    }
+    const int col = overlap.pos.col;
+    auto& text = MutableText(layer);
+    for (int i = overlap.pos.row; i < overlap.pos.row + overlap.size.height;
+         ++i) {
+      f(i, col, &text[ToTextIdx(i, col)], overlap.size.width);
+    }
+  }
+
+  // Calls f(i, j, cells, count) for each row i of the maze, with j = 0.
+  template <typename F>
+  void VisitRows(Layer layer, F&& f) const {
+    VisitRowsIntersection(layer, Area(), std::forward<F>(f));
+  }
+
+  // Mutable variant of VisitRows.
+  template <typename F>
+  void VisitMutableRows(Layer layer, F&& f) {
+    VisitMutableRowsIntersection(layer, Area(), std::forward<F>(f));
+  }
+
+  // Like VisitMutableRowsIntersection but calls f(i, j, cells, ids, count),
+  // where 'ids' points at the 'count' ids starting at (i, j). Depending on
+  // MaxId(), 'ids' is a pointer to const std::uint8_t, std::uint16_t or
+  // std::uint32_t, so 'f' is typically a generic lambda. The maze shall have an
+  // id layer, or none yet, in which case it is allocated.
+  template <typename F>
+  void VisitMutableRowsWithIdsIntersection(Layer layer, const Rectangle& rect,
+                                           F&& f) {
+    switch (id_bytes_) {
+      case 1:
+        VisitMutableRowsWithIds(layer, rect, ids8_, f);
+        break;
+      case 2:
+        VisitMutableRowsWithIds(layer, rect, ids16_, f);
+        break;
+      case 4:
+        VisitMutableRowsWithIds(layer, rect, ids32_, f);
+        break;
+      default:
+        WidenIds(0);
+        VisitMutableRowsWithIds(layer, rect, ids8_, f);
+    }
+  }
+
+  // Like VisitMutableIntersection but calls f(i, j, cell, id), where 'id' is
+  // the id at (i, j) as an unsigned int. The maze shall have an id layer.
+  template <typename F>
+  void VisitMutableWithIdsIntersection(Layer layer, const Rectangle& rect,
+                                       F&& f) {
+    VisitMutableRowsWithIdsIntersection(
+        layer, rect,
+        [&f](int i, int j, char* cells, const auto* ids, int count) {
+          for (int k = 0; k < count; ++k) {
+            f(i, j + k, cells + k, static_cast<unsigned int>(ids[k]));
+          }
+        });
+  }
+
   // Returns the character at position pos in layer layer, or '\0' of pos is out
   // of bounds of the maze.
   char GetCell(Layer layer, Pos pos) const {
     if (Area().InBounds(pos)) {
-      return text_[layer][ToTextIdx(pos.row, pos.col)];
+      const auto& text = text_[layer];
+      return text.empty() ? '.' : text[ToTextIdx(pos.row, pos.col)];
     } else {
       return '\0';
     }
@@ -174,7 +475,7 @@ class TextMaze {
   // within bounds of the maze; otherwise there is no effect.
   void SetCell(Layer layer, Pos pos, char value) {
     if (Area().InBounds(pos)) {
-      text_[layer][ToTextIdx(pos.row, pos.col)] = value;
+      MutableText(layer)[ToTextIdx(pos.row, pos.col)] = value;
     }
   }
 
@@ -186,23 +487,58 @@ class TextMaze {
     });
   }
 
-  // Returns the id at position pos, or 0 of pos is out of bounds of the maze.
+  // Returns the id at position pos, or 0 of pos is out of bounds of the maze
+  // or the maze has no id layer.
   unsigned int GetCellId(Pos pos) const {
-    if (Area().InBounds(pos)) {
-      return ids_[ToIdIdx(pos.row, pos.col)];
-    } else {
+    if (!Area().InBounds(pos)) {
       return 0;
     }
+    const int idx = ToIdIdx(pos.row, pos.col);
+    switch (id_bytes_) {
+      case 1:
+        return ids8_[idx];
+      case 2:
+        return ids16_[idx];
+      case 4:
+        return ids32_[idx];
+      default:
+        return 0;
+    }
   }
 
-  // Sets the character at position 'pos' in layer 'layer' to 'value' if pos is
-  // within bounds of the maze; otherwise there is no effect.
+  // Sets the id at position 'pos' to 'id' if pos is within bounds of the maze;
+  // otherwise there is no effect. 'id' shall not exceed MaxId().
   void SetCellId(Pos pos, unsigned int id) {
-    if (Area().InBounds(pos)) {
-      ids_[ToIdIdx(pos.row, pos.col)] = id;
+    if (id > id_capacity_) {
+      WidenIds(id);
+    }
+    if (!Area().InBounds(pos)) {
+      return;
+    }
+    const int idx = ToIdIdx(pos.row, pos.col);
+    switch (id_bytes_) {
+      case 1:
+        ids8_[idx] = id;
+        break;
+      case 2:
+        ids16_[idx] = id;
+        break;
+      case 4:
+        ids32_[idx] = id;
+        break;
     }
   }
 
+  // Largest id that may be set.
+  unsigned int MaxId() const { return max_id_; }
+
+  // Returns whether the id layer is allocated. Without one all ids read as 0.
+  bool HasIds() const { return id_bytes_ != 0; }
+
+  // Frees the id layer. Afterwards all ids read as 0, and the id layer is
+  // allocated again and widened on demand when ids are set.
+  void ReleaseIds();
+
   // Perform 'rotation' number of clockwise rotations on the maze.
   // If 'rotation' is negative, rotate counterclockwise instead.
   // A 'rotation' of any multiple of 4 returns a copy of the passed in maze.
@@ -219,8 +555,49 @@ class TextMaze {
     });
   }
 
-  // Returns text associated with the 'layer'.
-  const std::string& Text(Layer layer) const { return text_[layer]; }
+  // Returns a compact binary encoding of the entity and variations layers.
+  // Walls ('*') are packed at one bit per cell; the remaining entity cells and
+  // the variations layer are run-length encoded over a per-layer dictionary.
+  // Ids are not serialized.
+  std::string Serialize() const;
+
+  // Decodes the output of Serialize into '*maze', whose id layer is allocated
+  // when ids are first set.
+  // Returns false, leaving '*maze' unchanged, if 'data' is malformed.
+  static bool Deserialize(const std::string& data, TextMaze* maze);
+
+  // Returns a compact encoding of the cells of both layers that differ between
+  // this maze and 'target', which must have the same extents. Applying the
+  // result to this maze with ApplyDiff turns its layers into those of 'target'.
+  // Ids are not compared.
+  std::string Diff(const TextMaze& target) const;
+
+  // Overwrites the cells listed in 'diff', as produced by Diff. Returns false,
+  // leaving the maze unchanged, if 'diff' is malformed or was computed for a
+  // maze of different extents.
+  bool ApplyDiff(const std::string& diff);
+
+  // Returns text associated with the 'layer'. The reference is valid until the
+  // layer is modified or the maze is destroyed. Reading an unallocated
+  // variations layer builds its text in the maze, so the first such call must
+  // not race with other calls on the same maze.
+  const std::string& Text(Layer layer) const;
+
+  // Returns a copy of 'layer' surrounded by a border of 'border' characters,
+  // for bounds-check-free neighbour access. Choosing a wall character as
+  // 'border' makes the outside of the maze behave like walls.
+  BorderedGrid<char> BorderedLayer(Layer layer, char border) const;
+
+  // Copies the cells of 'grid', which shall have the extents of the maze, into
+  // 'layer'.
+  void AssignLayer(Layer layer, const BorderedGrid<char>& grid);
+
+  // Returns a copy of 'layer' in a TiledGrid whose border cells are 'border'.
+  TiledGrid<char> TiledLayer(Layer layer, char border) const;
+
+  // Returns whether the variations layer has been allocated, which happens on
+  // its first modification.
+  bool HasVariations() const { return !text_[kVariationsLayer].empty(); }
 
   // Area representing mutable cells of the grid.
   const Rectangle& Area() const { return area_; }
@@ -235,9 +612,52 @@ class TextMaze {
   // is within bounds.
   int ToIdIdx(int i, int j) const { return i * area_.size.width + j; }
 
+  // Returns the text of 'layer', allocating the variations layer if needed.
+  std::string& MutableText(Layer layer) {
+    auto& text = text_[layer];
+    if (layer == kVariationsLayer && text.empty()) {
+      if (default_text_.empty()) {
+        text = DefaultText('.');
+      } else {
+        text.swap(default_text_);
+      }
+    }
+    return text;
+  }
+
+  // Returns a layer text filled with 'value'.
+  std::string DefaultText(char value) const;
+
+  template <typename Id, typename F>
+  void VisitMutableRowsWithIds(Layer layer, const Rectangle& rect,
+                               const std::vector<Id>& ids, F& f) {
+    VisitMutableRowsIntersection(
+        layer, rect, [this, &ids, &f](int i, int j, char* cells, int count) {
+          f(i, j, cells, &ids[ToIdIdx(i, j)], count);
+        });
+  }
+
+  // Makes the id layer, allocating it if needed, wide enough to hold 'id'.
+  // Dies if 'id' exceeds MaxId().
+  void WidenIds(unsigned int id);
+
+  [[noreturn]] void IdOutOfRange(unsigned int id) const;
+
   Rectangle area_;
+  // The variations layer text is empty until allocated.
   std::array<std::string, 2> text_;
-  std::vector<unsigned int> ids_;
+  // Text of the unallocated variations layer, built by the first Text() call
+  // that reads it and moved into 'text_' when the layer is allocated.
+  mutable std::string default_text_;
+  // Only the vector of width 'id_bytes_' is used. 'id_bytes_' is 0 if there is
+  // no id layer.
+  std::vector<std::uint8_t> ids8_;
+  std::vector<std::uint16_t> ids16_;
+  std::vector<std::uint32_t> ids32_;
+  int id_bytes_;
+  unsigned int max_id_;
+  // Largest id the id layer holds without widening; at most 'max_id_'.
+  unsigned int id_capacity_;
 };
 
 }  // namespace labmaze
@@ -0,0 +1,104 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+// Returns a maze of size 'size' x 'size' with rooms and entities.
+TextMaze MakeMaze(int size) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = size / 4;
+  params.spawns_per_room = 1;
+  params.objects_per_room = 1;
+  return RandomMaze(params, 1).Maze();
+}
+
+void SetBytesCounters(const TextMaze& maze, const std::string& data,
+                      benchmark::State* state) {
+  state->counters["bytes_per_maze"] = data.size();
+  state->counters["text_bytes_per_maze"] =
+      maze.Text(TextMaze::kEntityLayer).size() +
+      maze.Text(TextMaze::kVariationsLayer).size();
+}
+
+void BM_Serialize(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  std::string data;
+  for (auto _ : state) {
+    data = maze.Serialize();
+    benchmark::DoNotOptimize(data);
+  }
+  SetBytesCounters(maze, data, &state);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Serialize)->Arg(11)->Arg(31)->Arg(101);
+
+void BM_Deserialize(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  const std::string data = maze.Serialize();
+  TextMaze decoded({1, 1});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TextMaze::Deserialize(data, &decoded));
+  }
+  SetBytesCounters(maze, data, &state);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Deserialize)->Arg(11)->Arg(31)->Arg(101);
+
+// Builds a wall map of the entity layer one cell at a time.
+void BM_WallMapVisit(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  std::vector<int> walls(maze.Area().Area());
+  for (auto _ : state) {
+    maze.Visit(TextMaze::kEntityLayer, [&walls, &maze](int i, int j, char c) {
+      walls[i * maze.Area().size.width + j] = c == '*' ? -2 : -1;
+    });
+    benchmark::DoNotOptimize(walls.data());
+  }
+  state.SetItemsProcessed(state.iterations() * maze.Area().Area());
+}
+BENCHMARK(BM_WallMapVisit)->Arg(11)->Arg(31)->Arg(101);
+
+// Builds the same wall map one row at a time.
+void BM_WallMapVisitRows(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  std::vector<int> walls(maze.Area().Area());
+  for (auto _ : state) {
+    maze.VisitRows(TextMaze::kEntityLayer,
+                   [&walls, &maze](int i, int j, const char* cells, int count) {
+                     int* row = &walls[i * maze.Area().size.width + j];
+                     for (int k = 0; k < count; ++k) {
+                       row[k] = cells[k] == '*' ? -2 : -1;
+                     }
+                   });
+    benchmark::DoNotOptimize(walls.data());
+  }
+  state.SetItemsProcessed(state.iterations() * maze.Area().Area());
+}
+BENCHMARK(BM_WallMapVisitRows)->Arg(11)->Arg(31)->Arg(101);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
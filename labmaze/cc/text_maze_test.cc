@@ -15,6 +15,10 @@
 
 #include "labmaze/cc/text_maze.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace deepmind {
@@ -397,6 +401,344 @@ TEST(TextMazeTest, Paste) {
   }
 }
 
+TEST(TextMazeTest, SerializeRoundTrip) {
+  TextMaze maze({5, 7});
+  maze.FillRect(TextMaze::kEntityLayer, {{1, 1}, {3, 5}}, ' ');
+  maze.SetCell(TextMaze::kEntityLayer, {2, 2}, 'P');
+  maze.SetCell(TextMaze::kEntityLayer, {3, 5}, 'G');
+  maze.FillRect(TextMaze::kVariationsLayer, {{1, 1}, {3, 3}}, 'A');
+  maze.FillRect(TextMaze::kVariationsLayer, {{1, 4}, {3, 2}}, 'B');
+
+  const std::string data = maze.Serialize();
+  EXPECT_LT(data.size(), maze.Text(TextMaze::kEntityLayer).size() +
+                            maze.Text(TextMaze::kVariationsLayer).size());
+
+  TextMaze decoded({1, 1});
+  ASSERT_TRUE(TextMaze::Deserialize(data, &decoded));
+  EXPECT_EQ(5, decoded.Area().size.height);
+  EXPECT_EQ(7, decoded.Area().size.width);
+  EXPECT_EQ(maze.Text(TextMaze::kEntityLayer),
+            decoded.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(maze.Text(TextMaze::kVariationsLayer),
+            decoded.Text(TextMaze::kVariationsLayer));
+}
+
+TEST(TextMazeTest, SerializeAllCharacters) {
+  TextMaze maze({16, 16});
+  int value = 0;
+  maze.VisitMutable(TextMaze::kEntityLayer, [&value](int, int, char* c) {
+    *c = static_cast<char>(value++);
+  });
+  maze.VisitMutable(TextMaze::kVariationsLayer, [&value](int, int, char* c) {
+    *c = static_cast<char>(value--);
+  });
+  TextMaze decoded({1, 1});
+  ASSERT_TRUE(TextMaze::Deserialize(maze.Serialize(), &decoded));
+  EXPECT_EQ(maze.Text(TextMaze::kEntityLayer),
+            decoded.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(maze.Text(TextMaze::kVariationsLayer),
+            decoded.Text(TextMaze::kVariationsLayer));
+}
+
+TEST(TextMazeTest, DeserializeMalformed) {
+  TextMaze maze({3, 3});
+  maze.SetCell(TextMaze::kEntityLayer, {1, 1}, ' ');
+  const std::string data = maze.Serialize();
+
+  TextMaze decoded({1, 1});
+  EXPECT_FALSE(TextMaze::Deserialize("", &decoded));
+  EXPECT_FALSE(TextMaze::Deserialize(data.substr(0, data.size() - 1),
+                                     &decoded));
+  EXPECT_FALSE(TextMaze::Deserialize(data + '\0', &decoded));
+  std::string bad_version = data;
+  bad_version[0] = 2;
+  EXPECT_FALSE(TextMaze::Deserialize(bad_version, &decoded));
+  EXPECT_EQ(1, decoded.Area().size.height);
+  EXPECT_EQ(1, decoded.Area().size.width);
+}
+
+TEST(TextMazeTest, DiffRoundTrip) {
+  TextMaze source({9, 37});
+  TextMaze target({9, 37});
+  target.SetCell(TextMaze::kEntityLayer, {0, 0}, 'P');
+  target.SetCell(TextMaze::kEntityLayer, {4, 17}, ' ');
+  target.SetCell(TextMaze::kEntityLayer, {4, 18}, ' ');
+  target.SetCell(TextMaze::kEntityLayer, {8, 36}, 'G');
+  target.FillRect(TextMaze::kVariationsLayer, {{2, 30}, {3, 3}}, 'B');
+
+  const std::string diff = source.Diff(target);
+  EXPECT_LT(diff.size(), 40);
+  ASSERT_TRUE(source.ApplyDiff(diff));
+  EXPECT_EQ(target.Text(TextMaze::kEntityLayer),
+            source.Text(TextMaze::kEntityLayer));
+  EXPECT_EQ(target.Text(TextMaze::kVariationsLayer),
+            source.Text(TextMaze::kVariationsLayer));
+
+  const std::string empty_diff = source.Diff(target);
+  EXPECT_EQ(4, empty_diff.size());
+  ASSERT_TRUE(source.ApplyDiff(empty_diff));
+  EXPECT_EQ(target.Text(TextMaze::kEntityLayer),
+            source.Text(TextMaze::kEntityLayer));
+}
+
+TEST(TextMazeTest, DiffEveryCell) {
+  TextMaze source({7, 5});
+  TextMaze target({7, 5});
+  char value = 'a';
+  target.VisitMutable(TextMaze::kEntityLayer,
+                      [&value](int, int, char* c) { *c = value++; });
+  ASSERT_TRUE(source.ApplyDiff(source.Diff(target)));
+  EXPECT_EQ(target.Text(TextMaze::kEntityLayer),
+            source.Text(TextMaze::kEntityLayer));
+}
+
+TEST(TextMazeTest, ApplyDiffMalformed) {
+  TextMaze source({3, 3});
+  TextMaze target({3, 3});
+  target.SetCell(TextMaze::kEntityLayer, {1, 1}, ' ');
+  const std::string diff = source.Diff(target);
+
+  TextMaze other_size({3, 5});
+  EXPECT_FALSE(other_size.ApplyDiff(diff));
+  EXPECT_FALSE(source.ApplyDiff(diff.substr(0, diff.size() - 1)));
+  EXPECT_FALSE(source.ApplyDiff(diff + 'x'));
+  EXPECT_EQ('*', source.GetCell(TextMaze::kEntityLayer, {1, 1}));
+
+  // A change at the position of a new-line character.
+  std::string newline_diff = {3, 3, 1, 3, ' ', 0};
+  EXPECT_FALSE(source.ApplyDiff(newline_diff));
+}
+
+TEST(TextMazeTest, IdWidths) {
+  for (unsigned int max_id : {1u, 255u, 256u, 65535u, 65536u, 4294967295u}) {
+    TextMaze maze({3, 4}, max_id);
+    EXPECT_EQ(max_id, maze.MaxId());
+    EXPECT_EQ(0, maze.GetCellId({2, 3}));
+    maze.SetCellId({2, 3}, max_id);
+    maze.SetCellId({0, 0}, max_id - 1);
+    EXPECT_EQ(max_id, maze.GetCellId({2, 3}));
+    EXPECT_EQ(max_id - 1, maze.GetCellId({0, 0}));
+    EXPECT_EQ(0, maze.GetCellId({1, 1}));
+
+    TextMaze rotated = maze.Rotate(1);
+    EXPECT_EQ(max_id, rotated.MaxId());
+    EXPECT_EQ(max_id - 1, rotated.GetCellId({0, 2}));
+  }
+}
+
+TEST(TextMazeTest, IdsWidenOnDemand) {
+  TextMaze maze({3, 4});
+  EXPECT_EQ(std::numeric_limits<unsigned int>::max(), maze.MaxId());
+  EXPECT_EQ(0, maze.GetCellId({1, 1}));
+  maze.SetCellId({0, 0}, 7);
+  maze.SetCellId({0, 1}, 300);
+  maze.SetCellId({2, 3}, 70000);
+  EXPECT_EQ(7, maze.GetCellId({0, 0}));
+  EXPECT_EQ(300, maze.GetCellId({0, 1}));
+  EXPECT_EQ(70000, maze.GetCellId({2, 3}));
+  EXPECT_EQ(0, maze.GetCellId({1, 1}));
+
+  TextMaze rotated = maze.Rotate(1);
+  EXPECT_EQ(7, rotated.GetCellId({0, 2}));
+  EXPECT_EQ(70000, rotated.GetCellId({3, 0}));
+
+  TextMaze unset({2, 3});
+  unset.VisitMutableRowsWithIdsIntersection(
+      TextMaze::kEntityLayer, unset.Area(),
+      [](int, int, char*, const auto* ids, int count) {
+        for (int k = 0; k < count; ++k) EXPECT_EQ(0, ids[k]);
+      });
+}
+
+TEST(TextMazeTest, ZeroMaxIdWidensOnDemand) {
+  TextMaze maze({3, 4}, 0);
+  EXPECT_FALSE(maze.HasIds());
+  EXPECT_EQ(std::numeric_limits<unsigned int>::max(), maze.MaxId());
+  maze.SetCellId({1, 1}, 300);
+  EXPECT_TRUE(maze.HasIds());
+  EXPECT_EQ(300, maze.GetCellId({1, 1}));
+}
+
+TEST(TextMazeTest, ReleaseIds) {
+  TextMaze maze({3, 4}, 255);
+  maze.SetCellId({1, 1}, 7);
+  maze.ReleaseIds();
+  EXPECT_FALSE(maze.HasIds());
+  EXPECT_EQ(0, maze.GetCellId({1, 1}));
+
+  // Ids may be set again, without the former maximum.
+  maze.SetCellId({1, 1}, 1000);
+  EXPECT_EQ(1000, maze.GetCellId({1, 1}));
+  TextMaze copy = maze;
+  copy.ReleaseIds();
+  copy.SetCellId({0, 0}, 1);
+  EXPECT_EQ(1, copy.GetCellId({0, 0}));
+}
+
+TEST(TextMazeTest, DeserializedMazeWidensIds) {
+  TextMaze maze({3, 4});
+  maze.SetCell(TextMaze::kEntityLayer, {1, 1}, ' ');
+  TextMaze restored({1, 1});
+  ASSERT_TRUE(TextMaze::Deserialize(maze.Serialize(), &restored));
+  EXPECT_FALSE(restored.HasIds());
+  restored.SetCellId({1, 1}, 70000);
+  EXPECT_EQ(70000, restored.GetCellId({1, 1}));
+}
+
+TEST(TextMazeDeathTest, IdOutOfRange) {
+  TextMaze maze({3, 4}, 255);
+  EXPECT_DEATH(maze.SetCellId({1, 1}, 256), "exceeds the maximum id");
+}
+
+TEST(TextMazeTest, LazyVariations) {
+  TextMaze maze({2, 3});
+  EXPECT_FALSE(maze.HasVariations());
+  EXPECT_EQ("...\n...\n", maze.Text(TextMaze::kVariationsLayer));
+  EXPECT_EQ('.', maze.GetCell(TextMaze::kVariationsLayer, {1, 2}));
+  maze.Visit(TextMaze::kVariationsLayer,
+             [](int, int, char c) { EXPECT_EQ('.', c); });
+  EXPECT_FALSE(maze.Rotate(1).HasVariations());
+
+  TextMaze target({2, 3});
+  EXPECT_EQ(4, maze.Diff(target).size());
+  EXPECT_FALSE(maze.HasVariations());
+
+  maze.SetCell(TextMaze::kVariationsLayer, {1, 2}, 'A');
+  EXPECT_TRUE(maze.HasVariations());
+  EXPECT_EQ("...\n..A\n", maze.Text(TextMaze::kVariationsLayer));
+  ASSERT_TRUE(target.ApplyDiff(target.Diff(maze)));
+  EXPECT_EQ("...\n..A\n", target.Text(TextMaze::kVariationsLayer));
+}
+
+TEST(TextMazeTest, VisitRowsIntersection) {
+  TextMaze maze({3, 4});
+  maze.VisitMutableRowsIntersection(
+      TextMaze::kEntityLayer, {{1, 2}, {5, 5}},
+      [](int i, int j, char* cells, int count) {
+        EXPECT_EQ(2, j);
+        EXPECT_EQ(2, count);
+        cells[0] = '0' + i;
+        cells[1] = 'a' + i;
+      });
+  EXPECT_EQ("****\n**1b\n**2c\n", maze.Text(TextMaze::kEntityLayer));
+
+  std::string visited;
+  maze.VisitRows(TextMaze::kEntityLayer,
+                 [&visited](int i, int j, const char* cells, int count) {
+                   EXPECT_EQ(0, j);
+                   EXPECT_EQ(4, count);
+                   visited.append(cells, count);
+                 });
+  EXPECT_EQ("******1b**2c", visited);
+
+  int num_rows = 0;
+  maze.VisitRowsIntersection(TextMaze::kVariationsLayer, {{-1, -1}, {2, 2}},
+                             [&num_rows](int i, int j, const char* cells,
+                                         int count) {
+                               EXPECT_EQ(0, i);
+                               EXPECT_EQ(0, j);
+                               EXPECT_EQ(std::string("."),
+                                         std::string(cells, count));
+                               ++num_rows;
+                             });
+  EXPECT_EQ(1, num_rows);
+  EXPECT_FALSE(maze.HasVariations());
+
+  maze.VisitRowsIntersection(TextMaze::kEntityLayer, {{5, 5}, {1, 1}},
+                             [](int, int, const char*, int) { FAIL(); });
+}
+
+TEST(TextMazeTest, VisitRowsWithIds) {
+  for (unsigned int max_id : {200u, 60000u, 100000u}) {
+    TextMaze maze({2, 3}, max_id);
+    maze.SetCellId({0, 1}, 7);
+    maze.SetCellId({1, 2}, max_id);
+    maze.VisitMutableRowsWithIdsIntersection(
+        TextMaze::kVariationsLayer, {{0, 1}, {2, 2}},
+        [](int i, int j, char* cells, const auto* ids, int count) {
+          EXPECT_EQ(1, j);
+          for (int k = 0; k < count; ++k) {
+            cells[k] = ids[k] == 0 ? '0' : 'x';
+          }
+        });
+    EXPECT_EQ(".x0\n.0x\n", maze.Text(TextMaze::kVariationsLayer));
+  }
+}
+
+TEST(TextMazeTest, VisitRowsWithoutIdsAllocatesThem) {
+  TextMaze maze({2, 3}, 0);
+  int visited = 0;
+  maze.VisitMutableRowsWithIdsIntersection(
+      TextMaze::kEntityLayer, maze.Area(),
+      [&visited](int, int, char*, const auto* ids, int count) {
+        for (int k = 0; k < count; ++k) {
+          visited += ids[k] == 0;
+        }
+      });
+  EXPECT_EQ(6, visited);
+  EXPECT_TRUE(maze.HasIds());
+}
+
+TEST(TextMazeTest, BorderedLayer) {
+  TextMaze maze({2, 3});
+  maze.SetCell(TextMaze::kEntityLayer, {0, 0}, 'A');
+  maze.SetCell(TextMaze::kEntityLayer, {1, 2}, 'B');
+  auto grid = maze.BorderedLayer(TextMaze::kEntityLayer, '*');
+  EXPECT_EQ(5, grid.stride());
+  EXPECT_EQ('A', grid[grid.Index(0, 0)]);
+  EXPECT_EQ('B', grid[grid.Index(1, 2)]);
+  const auto offsets = grid.NeighbourOffsets();
+  for (int idx : {grid.Index(0, 0), grid.Index(1, 2)}) {
+    EXPECT_EQ(grid.ToPos(idx).row, grid.ToPos(idx + offsets[1]).row - 1);
+    EXPECT_EQ(grid.ToPos(idx).col, grid.ToPos(idx + offsets[3]).col - 1);
+  }
+  EXPECT_EQ('*', grid[grid.Index(0, 0) + offsets[0]]);
+  EXPECT_EQ('*', grid[grid.Index(0, 0) + offsets[2]]);
+  EXPECT_EQ('*', grid[grid.Index(1, 2) + offsets[1]]);
+  EXPECT_EQ('*', grid[grid.Index(1, 2) + offsets[3]]);
+
+  grid[grid.Index(1, 0)] = 'C';
+  maze.AssignLayer(TextMaze::kEntityLayer, grid);
+  EXPECT_EQ("A**\nC*B\n", maze.Text(TextMaze::kEntityLayer));
+
+  EXPECT_FALSE(maze.HasVariations());
+  EXPECT_EQ('.', maze.BorderedLayer(TextMaze::kVariationsLayer, '*')[
+                     grid.Index(1, 1)]);
+}
+
+TEST(TextMazeTest, TiledLayer) {
+  TextMaze maze({9, 20});
+  maze.SetCell(TextMaze::kEntityLayer, {0, 0}, 'A');
+  maze.SetCell(TextMaze::kEntityLayer, {8, 19}, 'B');
+  maze.SetCell(TextMaze::kEntityLayer, {6, 7}, 'C');
+  const auto grid = maze.TiledLayer(TextMaze::kEntityLayer, '#');
+  std::vector<int> indices;
+  for (int i = -1; i <= 9; ++i) {
+    for (int j = -1; j <= 20; ++j) {
+      const int idx = grid.Index(i, j);
+      indices.push_back(idx);
+      EXPECT_EQ((Pos{i, j}), grid.ToPos(idx));
+      const char expected =
+          maze.Area().InBounds({i, j})
+              ? maze.GetCell(TextMaze::kEntityLayer, {i, j})
+              : '#';
+      EXPECT_EQ(expected, grid[idx]);
+      if (maze.Area().InBounds({i, j})) {
+        const auto neighbours = grid.Neighbours(idx);
+        EXPECT_EQ(grid.Index(i - 1, j), neighbours[0]);
+        EXPECT_EQ(grid.Index(i + 1, j), neighbours[1]);
+        EXPECT_EQ(grid.Index(i, j - 1), neighbours[2]);
+        EXPECT_EQ(grid.Index(i, j + 1), neighbours[3]);
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  EXPECT_EQ(indices.end(), std::adjacent_find(indices.begin(), indices.end()));
+  // Cells of a tile are contiguous.
+  EXPECT_EQ(grid.Index(-1, -1) + TiledGrid<char>::kTileSize,
+            grid.Index(0, -1));
+}
+
 }  // namespace
 }  // namespace labmaze
 }  // namespace deepmind
@@ -0,0 +1,180 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+#include "labmaze/cc/weighted_flood_fill.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/logging.h"
+
+namespace deepmind {
+namespace labmaze {
+
+CharCostMap MakeCharCostMap(const std::vector<std::pair<char, int>>& costs,
+                            int default_cost) {
+  CharCostMap result;
+  result.fill(default_cost);
+  for (const auto& cost : costs) {
+    result[static_cast<unsigned char>(cost.first)] = cost.second;
+  }
+  return result;
+}
+
+WeightedFloodFill::WeightedFloodFill(const TextMaze& maze,
+                                     TextMaze::Layer layer, Pos goal,
+                                     const CharCostMap& costs)
+    : area_(maze.Area()),
+      goal_(goal),
+      costs_(area_.size, -1, -1),
+      distances_(area_.size, -1, -1) {
+  int max_cost = 0;
+  maze.VisitRows(layer, [this, &costs, &max_cost](int i, int j,
+                                                  const char* cells,
+                                                  int count) {
+    int* row = &costs_[costs_.Index(i, j)];
+    for (int k = 0; k < count; ++k) {
+      const int cost = costs[static_cast<unsigned char>(cells[k])];
+      CHECK_NE(cost, 0) << "Open cells shall cost more than 0.";
+      CHECK_LE(cost, kMaxCellCost) << "Cell cost exceeds kMaxCellCost.";
+      row[k] = cost < 0 ? -1 : cost;
+      max_cost = std::max(max_cost, cost);
+    }
+  });
+  Fill(max_cost);
+}
+
+WeightedFloodFill::WeightedFloodFill(const TextMaze& maze, Pos goal,
+                                     const CharCostMap& entity_costs,
+                                     const CharCostMap& variation_costs)
+    : area_(maze.Area()),
+      goal_(goal),
+      costs_(area_.size, -1, -1),
+      distances_(area_.size, -1, -1) {
+  maze.VisitRows(TextMaze::kEntityLayer, [this, &entity_costs](
+                                             int i, int j, const char* cells,
+                                             int count) {
+    int* row = &costs_[costs_.Index(i, j)];
+    for (int k = 0; k < count; ++k) {
+      row[k] = entity_costs[static_cast<unsigned char>(cells[k])];
+      CHECK_LE(row[k], kMaxCellCost) << "Cell cost exceeds kMaxCellCost.";
+    }
+  });
+  int max_cost = 0;
+  maze.VisitRows(TextMaze::kVariationsLayer, [this, &variation_costs,
+                                              &max_cost](int i, int j,
+                                                         const char* cells,
+                                                         int count) {
+    int* row = &costs_[costs_.Index(i, j)];
+    for (int k = 0; k < count; ++k) {
+      const int cost = variation_costs[static_cast<unsigned char>(cells[k])];
+      // Both costs are at most kMaxCellCost, so the sum cannot overflow.
+      CHECK_LE(cost, kMaxCellCost) << "Cell cost exceeds kMaxCellCost.";
+      row[k] = row[k] < 0 || cost < 0 ? -1 : row[k] + cost;
+      CHECK_NE(row[k], 0) << "Open cells shall cost more than 0.";
+      CHECK_LE(row[k], kMaxCellCost) << "Cell cost exceeds kMaxCellCost.";
+      max_cost = std::max(max_cost, row[k]);
+    }
+  });
+  Fill(max_cost);
+}
+
+void WeightedFloodFill::Fill(int max_cost) {
+  if (!area_.InBounds(goal_)) {
+    return;
+  }
+  const int goal_idx = costs_.Index(goal_.row, goal_.col);
+  if (costs_[goal_idx] < 0) {
+    return;
+  }
+
+  // Cells waiting at distance d are in buckets[d % buckets.size()]. As every
+  // cost is at most max_cost, the cells waiting at any time span fewer
+  // distances than there are buckets. A cell is queued again each time its
+  // distance falls; its stale entries are skipped.
+  std::vector<std::vector<int>> buckets(max_cost + 1);
+  buckets[0].push_back(goal_idx);
+  distances_[goal_idx] = 0;
+  std::size_t queued = 1;
+  for (int distance = 0; queued > 0; ++distance) {
+    auto& bucket = buckets[distance % buckets.size()];
+    queued -= bucket.size();
+    for (int idx : bucket) {
+      if (distances_[idx] != distance) {
+        continue;
+      }
+      connected_.push_back(costs_.ToPos(idx));
+      // Routes from the neighbours pay for entering this cell.
+      CHECK_LE(distance, std::numeric_limits<int>::max() - costs_[idx])
+          << "Distances overflow int.";
+      const int next = distance + costs_[idx];
+      for (int neighbour : costs_.Neighbours(idx)) {
+        if (costs_[neighbour] < 0) {
+          continue;
+        }
+        int& neighbour_distance = distances_[neighbour];
+        if (neighbour_distance == -1 || next < neighbour_distance) {
+          neighbour_distance = next;
+          buckets[next % buckets.size()].push_back(neighbour);
+          ++queued;
+        }
+      }
+    }
+    bucket.clear();
+  }
+}
+
+int WeightedFloodFill::DistanceFrom(Pos start) const {
+  return area_.InBounds(start) ? distances_[distances_.Index(start.row,
+                                                             start.col)]
+                               : -1;
+}
+
+std::vector<Pos> WeightedFloodFill::ShortestPathFrom(
+    Pos start, std::mt19937_64* rng) const {
+  std::vector<Pos> result;
+  int distance = DistanceFrom(start);
+  if (distance == -1) {
+    return result;
+  }
+  result.push_back(start);
+  int idx = distances_.Index(start.row, start.col);
+  // Every step of a cheapest route enters a cell whose distance is that of
+  // the cell left less its own cost; costs are positive, so the route ends.
+  while (distance > 0) {
+    int next_idx = idx;
+    int choice = 0;
+    for (int neighbour : distances_.Neighbours(idx)) {
+      const int cost = costs_[neighbour];
+      if (cost > 0 && distances_[neighbour] >= 0 &&
+          distances_[neighbour] == distance - cost) {
+        ++choice;
+        if (choice == 1 ||
+            std::uniform_int_distribution<>(1, choice)(*rng) == 1) {
+          next_idx = neighbour;
+        }
+      }
+    }
+    distance -= costs_[next_idx];
+    idx = next_idx;
+    result.push_back(distances_.ToPos(idx));
+  }
+  return result;
+}
+
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,110 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Cheapest routes to a goal over cells with different costs of entering.
+
+#ifndef LABMAZE_CC_WEIGHTED_FLOOD_FILL_H_
+#define LABMAZE_CC_WEIGHTED_FLOOD_FILL_H_
+
+#include <array>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+
+// The cost of entering a cell, indexed by its character as an unsigned char.
+// A negative cost marks a wall.
+using CharCostMap =
+    std::array<int, std::numeric_limits<unsigned char>::max() + 1>;
+
+// The largest cost of entering a cell. The bucket queue of WeightedFloodFill
+// holds one bucket per unit of the largest cost, so costs are kept small.
+constexpr int kMaxCellCost = 1 << 16;
+
+// Returns a CharCostMap where the characters in 'costs' have their cost and
+// all others have 'default_cost'.
+CharCostMap MakeCharCostMap(const std::vector<std::pair<char, int>>& costs,
+                            int default_cost);
+
+// Weighted counterpart of FloodFill: the distance of a route is the sum of the
+// costs of the cells it enters, including the goal but not its start. With a
+// cost of 1 for all open cells, distances are those of FloodFill.
+//
+// Distances are found by Dijkstra's algorithm with a bucket queue indexed by
+// distance modulo one more than the largest cost, which takes constant time
+// per cell and suits small integer costs.
+class WeightedFloodFill {
+ public:
+  // Finds the cheapest routes to 'goal' over 'layer' of 'maze', where entering
+  // a cell costs 'costs' of its character. The costs of open cells shall be
+  // positive and at most kMaxCellCost, and distances shall fit in an int.
+  WeightedFloodFill(const TextMaze& maze, TextMaze::Layer layer, Pos goal,
+                    const CharCostMap& costs);
+
+  // As above, where entering a cell costs the sum of 'entity_costs' of its
+  // entity character and 'variation_costs' of its variation character. A cell
+  // is a wall if either cost is negative. The sum shall be at most
+  // kMaxCellCost.
+  WeightedFloodFill(const TextMaze& maze, Pos goal,
+                    const CharCostMap& entity_costs,
+                    const CharCostMap& variation_costs);
+
+  // If the goal is reachable from 'start', returns the least distance of a
+  // route between them. Otherwise returns -1.
+  int DistanceFrom(Pos start) const;
+
+  // The goal filled from.
+  Pos Goal() const { return goal_; }
+
+  // The extents of the maze filled.
+  const Rectangle& Area() const { return area_; }
+
+  // If the goal is reachable from 'start', returns a cheapest route from
+  // 'start' to the goal including both end points. Otherwise returns an empty
+  // vector. Where the route has several cheapest branches, each has an equal
+  // chance of being chosen according to 'rng'.
+  std::vector<Pos> ShortestPathFrom(Pos start, std::mt19937_64* rng) const;
+
+  // Calls f(i, j, distance) for all points connected to the goal, in order of
+  // increasing distance.
+  template <typename F>
+  void Visit(F&& f) const {
+    for (const auto& p : connected_) {
+      f(p.row, p.col, distances_[distances_.Index(p.row, p.col)]);
+    }
+  }
+
+ private:
+  // Fills from goal_ over the costs already read into costs_.
+  void Fill(int max_cost);
+
+  Rectangle area_;
+  Pos goal_;
+  // Cost of entering each cell; -1 for walls and the border.
+  BorderedGrid<int> costs_;
+  // Distance of each cell; -1 for cells not reached.
+  BorderedGrid<int> distances_;
+  std::vector<Pos> connected_;
+};
+
+}  // namespace labmaze
+}  // namespace deepmind
+
+#endif  // LABMAZE_CC_WEIGHTED_FLOOD_FILL_H_
@@ -0,0 +1,123 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+//
+// Compares WeightedFloodFill with Dijkstra's algorithm over a binary heap on
+// the same costs, and with an unweighted FloodFill.
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+#include "labmaze/cc/weighted_flood_fill.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+TextMaze MakeMaze(int size) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = size / 8;
+  params.max_variations = 4;
+  params.extra_connection_probability = 0.05;
+  params.simplify = false;
+  return RandomMaze(params, 1).Maze();
+}
+
+const CharCostMap& EntityCosts() {
+  static const CharCostMap costs = MakeCharCostMap({{'*', -1}}, 0);
+  return costs;
+}
+
+const CharCostMap& VariationCosts() {
+  static const CharCostMap costs =
+      MakeCharCostMap({{'A', 2}, {'B', 5}, {'C', 9}, {'D', 3}}, 1);
+  return costs;
+}
+
+// Fills a maze state.range(0) cells square from a corner.
+void BM_WeightedFloodFill(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  for (auto _ : state) {
+    const WeightedFloodFill fill(maze, {1, 1}, EntityCosts(),
+                                 VariationCosts());
+    benchmark::DoNotOptimize(fill.DistanceFrom({2, 1}));
+  }
+}
+BENCHMARK(BM_WeightedFloodFill)
+    ->Arg(101)
+    ->Arg(1001)
+    ->Unit(benchmark::kMillisecond);
+
+// As BM_WeightedFloodFill, with a binary heap instead of buckets.
+void BM_BinaryHeapDijkstra(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  const Size size = maze.Area().size;
+  BorderedGrid<int> costs(size, -1, -1);
+  maze.Visit(TextMaze::kEntityLayer, [&](int i, int j, char cell) {
+    const int cost = EntityCosts()[static_cast<unsigned char>(cell)];
+    costs[costs.Index(i, j)] = cost;
+  });
+  maze.Visit(TextMaze::kVariationsLayer, [&](int i, int j, char cell) {
+    int& cost = costs[costs.Index(i, j)];
+    if (cost >= 0) cost += VariationCosts()[static_cast<unsigned char>(cell)];
+  });
+  using Entry = std::pair<int, int>;
+  for (auto _ : state) {
+    BorderedGrid<int> distances(size, -1, -1);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    const int goal = costs.Index(1, 1);
+    distances[goal] = 0;
+    queue.push({0, goal});
+    while (!queue.empty()) {
+      const Entry entry = queue.top();
+      queue.pop();
+      if (distances[entry.second] != entry.first) continue;
+      const int next = entry.first + costs[entry.second];
+      for (int neighbour : costs.Neighbours(entry.second)) {
+        int& distance = distances[neighbour];
+        if (costs[neighbour] >= 0 && (distance == -1 || next < distance)) {
+          distance = next;
+          queue.push({next, neighbour});
+        }
+      }
+    }
+    benchmark::DoNotOptimize(distances[costs.Index(2, 1)]);
+  }
+}
+BENCHMARK(BM_BinaryHeapDijkstra)
+    ->Arg(101)
+    ->Arg(1001)
+    ->Unit(benchmark::kMillisecond);
+
+// An unweighted FloodFill of the same mazes.
+void BM_FloodFill(benchmark::State& state) {
+  const TextMaze maze = MakeMaze(state.range(0));
+  for (auto _ : state) {
+    const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+    benchmark::DoNotOptimize(fill.DistanceFrom({2, 1}));
+  }
+}
+BENCHMARK(BM_FloodFill)->Arg(101)->Arg(1001)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
@@ -0,0 +1,227 @@
+// Copyright 2019 DeepMind Technologies Limited.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ============================================================================
+
+
+#include "labmaze/cc/weighted_flood_fill.h"
+
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "labmaze/cc/algorithm.h"
+#include "labmaze/cc/char_grid.h"
+#include "labmaze/cc/flood_fill.h"
+#include "labmaze/cc/random_maze.h"
+#include "labmaze/cc/text_maze.h"
+
+namespace deepmind {
+namespace labmaze {
+namespace {
+
+using ::testing::ElementsAre;
+
+TextMaze MakeMaze(int size, int seed) {
+  RandomMazeParams params;
+  params.height = size;
+  params.width = size;
+  params.max_rooms = 6;
+  params.extra_connection_probability = 0.2;
+  params.max_variations = 4;
+  params.simplify = false;
+  return RandomMaze(params, seed).Maze();
+}
+
+// Returns the distance to 'goal' of every cell of 'maze', where entering a
+// cell costs 'cost(pos)' or is impossible if negative, by Dijkstra's algorithm
+// with a binary heap.
+std::vector<int> ReferenceDistances(const TextMaze& maze, Pos goal,
+                                    const std::function<int(Pos)>& cost) {
+  const Rectangle& area = maze.Area();
+  const int width = area.size.width;
+  std::vector<int> distances(area.Area(), -1);
+  using Entry = std::pair<int, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  if (cost(goal) >= 0) queue.push({0, goal.row * width + goal.col});
+  while (!queue.empty()) {
+    const Entry entry = queue.top();
+    queue.pop();
+    if (distances[entry.second] >= 0) continue;
+    distances[entry.second] = entry.first;
+    const Pos pos = {entry.second / width, entry.second % width};
+    area.VisitNeighbours(pos, [&](int i, int j) {
+      const int index = i * width + j;
+      if (cost({i, j}) >= 0 && distances[index] < 0) {
+        queue.push({entry.first + cost(pos), index});
+      }
+    });
+  }
+  return distances;
+}
+
+// Checks that 'path' runs from 'start' to 'goal' through neighbouring cells
+// whose costs add up to 'distance'.
+void ExpectRoute(Pos start, Pos goal, int distance,
+                 const std::function<int(Pos)>& cost,
+                 const std::vector<Pos>& path) {
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(start, path.front());
+  EXPECT_EQ(goal, path.back());
+  int total = 0;
+  for (std::size_t k = 1; k < path.size(); ++k) {
+    EXPECT_EQ(1, std::abs(path[k].row - path[k - 1].row) +
+                     std::abs(path[k].col - path[k - 1].col));
+    EXPECT_LT(0, cost(path[k]));
+    total += cost(path[k]);
+  }
+  EXPECT_EQ(distance, total);
+}
+
+TEST(WeightedFloodFillTest, Simple) {
+  TextMaze maze = FromCharGrid(CharGrid("     \n"
+                                        " *** \n"
+                                        "     \n"));
+  for (int col = 1; col < 4; ++col) {
+    maze.SetCell(TextMaze::kVariationsLayer, {0, col}, 'B');
+  }
+  const WeightedFloodFill fill(maze, {0, 4}, MakeCharCostMap({{'*', -1}}, 1),
+                               MakeCharCostMap({{'.', 0}, {'B', 4}}, 0));
+  EXPECT_EQ((Pos{0, 4}), fill.Goal());
+  EXPECT_EQ(0, fill.DistanceFrom({0, 4}));
+  EXPECT_EQ(6, fill.DistanceFrom({0, 2}));
+  EXPECT_EQ(7, fill.DistanceFrom({1, 0}));
+  EXPECT_EQ(8, fill.DistanceFrom({0, 0}));
+  EXPECT_EQ(-1, fill.DistanceFrom({1, 1}));
+  EXPECT_EQ(-1, fill.DistanceFrom({3, 0}));
+  std::mt19937_64 rng(1);
+  EXPECT_THAT(fill.ShortestPathFrom({0, 0}, &rng),
+              ElementsAre(Pos{0, 0}, Pos{1, 0}, Pos{2, 0}, Pos{2, 1},
+                          Pos{2, 2}, Pos{2, 3}, Pos{2, 4}, Pos{1, 4},
+                          Pos{0, 4}));
+  EXPECT_THAT(fill.ShortestPathFrom({0, 4}, &rng), ElementsAre(Pos{0, 4}));
+  EXPECT_TRUE(fill.ShortestPathFrom({1, 1}, &rng).empty());
+
+  // The same costs from the variations layer alone, which has no walls.
+  const WeightedFloodFill variations(maze, TextMaze::kVariationsLayer, {0, 4},
+                                     MakeCharCostMap({{'B', 5}}, 1));
+  EXPECT_EQ(4, variations.DistanceFrom({0, 2}));
+  EXPECT_EQ(6, variations.DistanceFrom({0, 0}));
+  EXPECT_EQ(4, variations.DistanceFrom({1, 1}));
+}
+
+TEST(WeightedFloodFillTest, UnitCostsMatchFloodFill) {
+  const TextMaze maze = MakeMaze(41, 1);
+  const WeightedFloodFill weighted(maze, TextMaze::kEntityLayer, {1, 1},
+                                   MakeCharCostMap({{'*', -1}}, 1));
+  const FloodFill fill(maze, TextMaze::kEntityLayer, {1, 1}, {'*'});
+  maze.Area().Visit([&](int i, int j) {
+    EXPECT_EQ(fill.DistanceFrom({i, j}), weighted.DistanceFrom({i, j}));
+  });
+  int count = 0;
+  int last = 0;
+  weighted.Visit([&](int i, int j, int distance) {
+    EXPECT_EQ(fill.DistanceFrom({i, j}), distance);
+    EXPECT_LE(last, distance);
+    last = distance;
+    ++count;
+  });
+  int expected_count = 0;
+  fill.Visit([&expected_count](int, int, int) { ++expected_count; });
+  EXPECT_EQ(expected_count, count);
+}
+
+TEST(WeightedFloodFillTest, MatchesDijkstra) {
+  const CharCostMap entity_costs = MakeCharCostMap({{'*', -1}}, 0);
+  const CharCostMap variation_costs =
+      MakeCharCostMap({{'.', 1}, {'A', 2}, {'B', 5}, {'C', 9}, {'D', 3}}, 1);
+  const auto cost = [](const TextMaze& maze, Pos pos) {
+    if (!maze.Area().InBounds(pos) ||
+        maze.GetCell(TextMaze::kEntityLayer, pos) == '*') {
+      return -1;
+    }
+    switch (maze.GetCell(TextMaze::kVariationsLayer, pos)) {
+      case 'A': return 2;
+      case 'B': return 5;
+      case 'C': return 9;
+      case 'D': return 3;
+      default: return 1;
+    }
+  };
+  std::mt19937_64 rng(2);
+  for (int seed = 0; seed < 5; ++seed) {
+    const TextMaze maze = MakeMaze(51, seed);
+    const std::function<int(Pos)> maze_cost = [&maze, &cost](Pos pos) {
+      return cost(maze, pos);
+    };
+    const Pos goal = {2 * seed + 1, 49 - 2 * seed};
+    const WeightedFloodFill fill(maze, goal, entity_costs, variation_costs);
+    const std::vector<int> expected =
+        ReferenceDistances(maze, goal, maze_cost);
+    maze.Area().Visit([&](int i, int j) {
+      const int distance = fill.DistanceFrom({i, j});
+      ASSERT_EQ(expected[i * 51 + j], distance);
+      if (distance >= 0 && (i + j) % 7 == 0) {
+        ExpectRoute({i, j}, goal, distance, maze_cost,
+                    fill.ShortestPathFrom({i, j}, &rng));
+      }
+    });
+  }
+}
+
+TEST(WeightedFloodFillTest, GoalIsWall) {
+  const TextMaze maze = FromCharGrid(CharGrid(" * \n"));
+  const WeightedFloodFill fill(maze, TextMaze::kEntityLayer, {0, 1},
+                               MakeCharCostMap({{'*', -1}}, 1));
+  EXPECT_EQ(-1, fill.DistanceFrom({0, 0}));
+  EXPECT_EQ(-1, fill.DistanceFrom({0, 1}));
+  std::mt19937_64 rng(1);
+  EXPECT_TRUE(fill.ShortestPathFrom({0, 0}, &rng).empty());
+  int count = 0;
+  fill.Visit([&count](int, int, int) { ++count; });
+  EXPECT_EQ(0, count);
+}
+
+TEST(WeightedFloodFillDeathTest, FreeCell) {
+  const TextMaze maze = FromCharGrid(CharGrid(" * \n"));
+  EXPECT_DEATH(WeightedFloodFill(maze, TextMaze::kEntityLayer, {0, 0},
+                                 MakeCharCostMap({{'*', -1}}, 0)),
+               "cost more than 0");
+}
+
+TEST(WeightedFloodFillTest, LargestCost) {
+  const TextMaze maze = FromCharGrid(CharGrid("   \n"));
+  const WeightedFloodFill fill(maze, TextMaze::kEntityLayer, {0, 0},
+                               MakeCharCostMap({}, kMaxCellCost));
+  EXPECT_EQ(2 * kMaxCellCost, fill.DistanceFrom({0, 2}));
+}
+
+TEST(WeightedFloodFillDeathTest, CostAboveLimit) {
+  const TextMaze maze = FromCharGrid(CharGrid("   \n"), CharGrid(".a.\n"));
+  EXPECT_DEATH(WeightedFloodFill(maze, TextMaze::kEntityLayer, {0, 0},
+                                 MakeCharCostMap({}, kMaxCellCost + 1)),
+               "exceeds kMaxCellCost");
+  // Each cost is within the limit, but not their sum.
+  EXPECT_DEATH(WeightedFloodFill(maze, {0, 0}, MakeCharCostMap({}, 1),
+                                 MakeCharCostMap({{'a', kMaxCellCost}}, 1)),
+               "exceeds kMaxCellCost");
+}
+
+}  // namespace
+}  // namespace labmaze
+}  // namespace deepmind
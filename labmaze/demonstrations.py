@@ -0,0 +1,110 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Reader of expert demonstration files.
+
+Demonstration files hold shortest paths from spawn points to objects of
+generated mazes, as written by the `generate_demonstrations` tool. Actions are
+the directions of `labmaze.directions`: UP, DOWN, LEFT and RIGHT. See
+labmaze/cc/demonstrations.h for the file format.
+"""
+
+import collections
+import json
+
+import numpy as np
+
+# A path from `start` to `goal`, both (row, column), in the maze generated from
+# `seed`. `actions` is a uint8 array of the direction of each step.
+Demonstration = collections.namedtuple(
+    'Demonstration', ['seed', 'start', 'goal', 'actions'])
+
+_HEADER_MAGIC = b'LMDEMOS1'
+_FOOTER_MAGIC = b'LMDEMEND'
+_FOOTER = np.dtype([('index_offset', '<u8'), ('num_records', '<u8'),
+                    ('magic', 'S8')])
+_RECORD_HEADER = np.dtype([('seed', '<u8'), ('start', '<u2', 2),
+                           ('goal', '<u2', 2), ('num_actions', '<u4'),
+                           ('encoding', 'u1'), ('size', '<u4')])
+_PACKED = 0
+_RUN_LENGTH = 1
+
+
+def decode_actions(encoding, codes, num_actions):
+  """Returns the uint8 actions of a record from its encoded bytes."""
+  if encoding == _PACKED:
+    actions = (codes[:, np.newaxis] >> np.arange(0, 8, 2, dtype=np.uint8)) & 3
+    return actions.ravel()[:num_actions]
+  elif encoding == _RUN_LENGTH:
+    actions = np.repeat(codes & 3, (codes >> 2).astype(np.int64) + 1)
+    if len(actions) != num_actions:
+      raise ValueError('Run lengths do not add up to the number of actions.')
+    return actions
+  raise ValueError('Unknown action encoding: {}'.format(encoding))
+
+
+class DemonstrationReader(object):
+  """Random access to the demonstrations of a complete file.
+
+  The file is memory-mapped; records are decoded as they are accessed.
+  """
+
+  def __init__(self, path):
+    self._data = np.memmap(path, dtype=np.uint8, mode='r')
+    if (len(self._data) < len(_HEADER_MAGIC) + 4 + _FOOTER.itemsize or
+        self._data[:len(_HEADER_MAGIC)].tobytes() != _HEADER_MAGIC):
+      raise ValueError('Not a demonstrations file: {}'.format(path))
+    footer = self._data[-_FOOTER.itemsize:].view(_FOOTER)[0]
+    if footer['magic'] != _FOOTER_MAGIC:
+      raise ValueError('Incomplete demonstrations file: {}'.format(path))
+    index_offset = int(footer['index_offset'])
+    num_records = int(footer['num_records'])
+    self._index = self._data[index_offset:index_offset + 8 * num_records].view(
+        '<u8')
+    metadata_size = int(self._data[8:12].view('<u4')[0])
+    self._metadata = json.loads(self._data[12:12 + metadata_size].tobytes())
+
+  @property
+  def metadata(self):
+    """The dict of maze parameters the demonstrations were generated with.
+
+    Its keys are arguments of `labmaze.RandomMaze`.
+    """
+    return self._metadata
+
+  def __len__(self):
+    return len(self._index)
+
+  def __getitem__(self, index):
+    offset = int(self._index[index])
+    end = offset + _RECORD_HEADER.itemsize
+    header = self._data[offset:end].view(_RECORD_HEADER)[0]
+    codes = self._data[end:end + int(header['size'])]
+    return Demonstration(
+        seed=int(header['seed']),
+        start=tuple(int(x) for x in header['start']),
+        goal=tuple(int(x) for x in header['goal']),
+        actions=decode_actions(int(header['encoding']), codes,
+                               int(header['num_actions'])))
+
+  def __iter__(self):
+    for index in range(len(self)):
+      yield self[index]
+
+  def maze(self, index):
+    """Returns the `labmaze.RandomMaze` of the demonstration at `index`."""
+    from labmaze import random_maze  # pylint: disable=g-import-not-at-top
+    return random_maze.RandomMaze(random_seed=self[index].seed,
+                                  **self._metadata)
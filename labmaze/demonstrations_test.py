@@ -0,0 +1,84 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Tests for labmaze.demonstrations."""
+
+import os
+import struct
+
+from absl.testing import absltest
+from labmaze import demonstrations
+import numpy as np
+
+
+def _record(seed, start, goal, num_actions, encoding, codes):
+  return struct.pack('<Q4HIBI', seed, start[0], start[1], goal[0], goal[1],
+                     num_actions, encoding, len(codes)) + codes
+
+
+class DemonstrationsTest(absltest.TestCase):
+
+  def _write_file(self, records, metadata=b'{"height": 11, "width": 13}'):
+    data = b'LMDEMOS1' + struct.pack('<I', len(metadata)) + metadata
+    offsets = []
+    for record in records:
+      offsets.append(len(data))
+      data += record
+    footer = struct.pack('<QQ', len(data), len(records)) + b'LMDEMEND'
+    data += struct.pack('<{}Q'.format(len(offsets)), *offsets) + footer
+    path = os.path.join(absltest.get_default_test_tmpdir(), 'demos.bin')
+    with open(path, 'wb') as f:
+      f.write(data)
+    return path
+
+  def testReadDemonstrations(self):
+    path = self._write_file([
+        # Packed: UP, RIGHT, DOWN, LEFT, RIGHT.
+        _record(7, (1, 1), (3, 5), 5, 0, bytes([0 | 3 << 2 | 1 << 4 | 2 << 6,
+                                                3])),
+        # Run-length: 64 times RIGHT, then 2 times DOWN.
+        _record(2**40, (9, 1), (1, 1), 66, 1, bytes([3 | 63 << 2, 1 | 1 << 2])),
+        _record(8, (5, 5), (5, 5), 0, 0, b''),
+    ])
+    reader = demonstrations.DemonstrationReader(path)
+    self.assertEqual(reader.metadata, {'height': 11, 'width': 13})
+    self.assertLen(reader, 3)
+
+    first = reader[0]
+    self.assertEqual(first.seed, 7)
+    self.assertEqual(first.start, (1, 1))
+    self.assertEqual(first.goal, (3, 5))
+    np.testing.assert_array_equal(first.actions, [0, 3, 1, 2, 3])
+    self.assertEqual(first.actions.dtype, np.uint8)
+
+    second = reader[1]
+    self.assertEqual(second.seed, 2**40)
+    np.testing.assert_array_equal(second.actions, [3] * 64 + [1] * 2)
+
+    self.assertEmpty(reader[2].actions)
+    self.assertEqual([d.seed for d in reader], [7, 2**40, 8])
+
+  def testIncompleteFile(self):
+    path = self._write_file([_record(7, (1, 1), (1, 2), 1, 0, b'\x03')])
+    with open(path, 'rb') as f:
+      data = f.read()
+    with open(path, 'wb') as f:
+      f.write(data[:-1])
+    with self.assertRaises(ValueError):
+      demonstrations.DemonstrationReader(path)
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,28 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Directions of steps between neighbouring cells.
+
+Policy fields, maze graph edges and demonstration actions all use these
+values, which match `Direction` in labmaze/cc/direction.h.
+"""
+
+UP = 0
+DOWN = 1
+LEFT = 2
+RIGHT = 3
+
+# The (row, column) step in each direction.
+STEPS = ((-1, 0), (1, 0), (0, -1), (0, 1))
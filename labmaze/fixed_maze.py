@@ -19,6 +19,7 @@ import itertools
 from labmaze import base
 from labmaze import defaults
 from labmaze import text_grid
+from labmaze.cc.python import _text_maze
 import numpy as np
 
 _EMPTY_CELL = ' '
@@ -107,7 +108,22 @@ class FixedMazeWithRandomGoals(base.BaseMaze):
 
     self._height, self._width = self._entity_layer.shape
     self._random_state = random_state or np.random
+    self._find_cells()
 
+    if num_spawns is not None:
+      self._num_spawns = num_spawns
+    else:
+      self._num_spawns = len(self._required_spawns)
+
+    if num_objects is not None:
+      self._num_objects = num_objects
+    else:
+      self._num_objects = len(self._required_objects)
+
+    self.regenerate()
+
+  def _find_cells(self):
+    """Finds the cells of the layout that spawns and objects may be drawn to."""
     self._empty_cells = []
     self._required_spawns = []
     self._required_objects = []
@@ -121,23 +137,17 @@ class FixedMazeWithRandomGoals(base.BaseMaze):
         elif self._entity_layer[y, x] == self._object_token:
           self._required_objects.append((y, x))
 
-    if num_spawns is not None:
-      self._num_spawns = num_spawns
-    else:
-      self._num_spawns = len(self._required_spawns)
-
-    if num_objects is not None:
-      self._num_objects = num_objects
-    else:
-      self._num_objects = len(self._required_objects)
-
-    self.regenerate()
-
-  def regenerate(self):
+  def _place(self, spawns, objects):
+    """Places spawns and objects in the cells of the layout."""
     for (y, x) in itertools.chain(
         self._empty_cells, self._required_spawns, self._required_objects):
       self._entity_layer[y, x] = _EMPTY_CELL
+    for (y, x) in spawns:
+      self._entity_layer[y, x] = self._spawn_token
+    for (y, x) in objects:
+      self._entity_layer[y, x] = self._object_token
 
+  def regenerate(self):
     if self._required_spawns:
       chosen_spawn_indices = self._random_state.choice(
           len(self._required_spawns),
@@ -163,10 +173,43 @@ class FixedMazeWithRandomGoals(base.BaseMaze):
       spawns += extras[:extra_spawns]
       objects += extras[extra_spawns:]
 
-    for (y, x) in spawns:
-      self._entity_layer[y, x] = self._spawn_token
-    for (y, x) in objects:
-      self._entity_layer[y, x] = self._object_token
+    self._place(spawns, objects)
+
+  def __getstate__(self):
+    """Returns the pickled state, with the layers in compact binary form.
+
+    The entity layer is pickled as the layout it was constructed from, along
+    with the cells of the current spawns and objects, so the cells they may be
+    drawn from need not be pickled.
+    """
+    state = self.__dict__.copy()
+    layout = state.pop('_entity_layer').copy()
+    state['_spawns'] = np.argwhere(layout == self._spawn_token).tolist()
+    state['_objects'] = np.argwhere(layout == self._object_token).tolist()
+    for (y, x) in state.pop('_empty_cells'):
+      layout[y, x] = _EMPTY_CELL
+    for (y, x) in state.pop('_required_spawns'):
+      layout[y, x] = self._spawn_token
+    for (y, x) in state.pop('_required_objects'):
+      layout[y, x] = self._object_token
+    state['_layers'] = _text_maze.serialize(
+        str(layout), str(state.pop('_variations_layer')))
+    if state['_random_state'] is np.random:
+      state['_random_state'] = None  # Modules cannot be pickled.
+    return state
+
+  def __setstate__(self, state):
+    state = state.copy()
+    entity_layer, variations_layer = _text_maze.deserialize(
+        state.pop('_layers'))
+    spawns = state.pop('_spawns')
+    objects = state.pop('_objects')
+    self.__dict__.update(state)
+    self._random_state = self._random_state or np.random
+    self._entity_layer = text_grid.TextGrid(entity_layer)
+    self._variations_layer = text_grid.TextGrid(variations_layer)
+    self._find_cells()
+    self._place(spawns, objects)
 
   @property
   def entity_layer(self):
@@ -15,6 +15,8 @@
 
 """Tests for labmaze.fixed_maze."""
 
+import pickle
+
 from absl.testing import absltest
 from absl.testing import parameterized
 from labmaze import fixed_maze
@@ -129,6 +131,24 @@ class FixedMazeWithRandomGoalsTest(parameterized.TestCase):
                                   required_spawns=_MAZE_2_SPAWNS,
                                   required_objects=_MAZE_2_OBJECTS)
 
+  def testPickle(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_MAZE_2,
+        num_spawns=2, spawn_token=_SPAWN_TOKEN,
+        num_objects=3, object_token=_OBJECT_TOKEN,
+        random_state=np.random.RandomState(234))
+    restored = pickle.loads(pickle.dumps(maze))
+    np.testing.assert_array_equal(restored.entity_layer, maze.entity_layer)
+    np.testing.assert_array_equal(restored.variations_layer,
+                                  maze.variations_layer)
+    for _ in range(3):
+      maze.regenerate()
+      restored.regenerate()
+      np.testing.assert_array_equal(restored.entity_layer, maze.entity_layer)
+      self.assert_consistent_maze(restored, 2, 3,
+                                  required_spawns=_MAZE_2_SPAWNS,
+                                  required_objects=_MAZE_2_OBJECTS)
+
 
 if __name__ == '__main__':
   absltest.main()
@@ -0,0 +1,67 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+"""Compact differences between the layers of mazes of equal extents.
+
+A diff lists only the cells of the entity and variations layers that differ
+between two mazes, so that a sequence of mazes that change little between
+each other, such as a fixed layout with regenerated goals, can be stored or
+sent as its first maze and a diff per change. Ids are not compared.
+"""
+
+from labmaze import text_grid
+from labmaze.cc.python import _text_maze
+
+
+def _native_maze(maze):
+  return _text_maze.TextMaze(entity_layer=str(maze.entity_layer),
+                             variations_layer=str(maze.variations_layer))
+
+
+def diff(maze, target):
+  """Returns the cells of `target` that differ from those of `maze`.
+
+  Args:
+    maze: A `BaseMaze` object.
+    target: A `BaseMaze` object with the extents of `maze`.
+
+  Returns:
+    A bytes object that `apply_diff` turns the layers of `maze` into those of
+    `target` with.
+
+  Raises:
+    ValueError: If the mazes have different extents.
+  """
+  return _native_maze(maze).diff(_native_maze(target))
+
+
+def apply_diff(maze, data):
+  """Returns the layers of a maze with a diff applied.
+
+  Args:
+    maze: A `BaseMaze` object.
+    data: A diff returned by `diff` for a maze with the extents of `maze`.
+
+  Returns:
+    A tuple of the entity layer and the variations layer of `maze` with the
+    cells in `data` overwritten, as `TextGrid` objects. `maze` is unchanged.
+
+  Raises:
+    ValueError: If `data` is malformed or was computed for mazes of different
+      extents.
+  """
+  native_maze = _native_maze(maze)
+  native_maze.apply_diff(data)
+  return (text_grid.TextGrid(native_maze.entity_layer),
+          text_grid.TextGrid(native_maze.variations_layer))
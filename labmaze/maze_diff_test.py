@@ -0,0 +1,79 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+"""Tests for labmaze.maze_diff."""
+
+import copy
+
+from absl.testing import absltest
+from labmaze import fixed_maze
+from labmaze import maze_diff
+import numpy as np
+
+_ENTITY_LAYER = ('*********\n'
+                 '*       *\n'
+                 '* ***** *\n'
+                 '*       *\n'
+                 '*********\n')
+
+_VARIATIONS_LAYER = ('.........\n'
+                     '.AAA.BBB.\n'
+                     '.........\n'
+                     '.AAA.BBB.\n'
+                     '.........\n')
+
+
+class MazeDiffTest(absltest.TestCase):
+
+  def _maze(self, seed):
+    return fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_ENTITY_LAYER, variations_layer=_VARIATIONS_LAYER,
+        num_spawns=1, num_objects=2,
+        random_state=np.random.RandomState(seed))
+
+  def testRoundTrip(self):
+    maze = self._maze(1)
+    target = copy.deepcopy(maze)
+    for _ in range(3):
+      target.regenerate()
+      data = maze_diff.diff(maze, target)
+      self.assertIsInstance(data, bytes)
+      entity_layer, variations_layer = maze_diff.apply_diff(maze, data)
+      self.assertEqual(str(entity_layer), str(target.entity_layer))
+      self.assertEqual(str(variations_layer), str(target.variations_layer))
+
+  def testDiffOfVariations(self):
+    maze = self._maze(2)
+    target = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=str(maze.entity_layer),
+        variations_layer=_VARIATIONS_LAYER.replace('B', 'C'))
+    data = maze_diff.diff(maze, target)
+    self.assertLess(len(maze_diff.diff(maze, maze)), len(data))
+    entity_layer, variations_layer = maze_diff.apply_diff(maze, data)
+    self.assertEqual(str(entity_layer), str(maze.entity_layer))
+    self.assertEqual(str(variations_layer), str(target.variations_layer))
+
+  def testInvalidDiffs(self):
+    maze = self._maze(4)
+    small = fixed_maze.FixedMazeWithRandomGoals(entity_layer='***\n* *\n***\n')
+    with self.assertRaises(ValueError):
+      maze_diff.diff(maze, small)
+    with self.assertRaises(ValueError):
+      maze_diff.apply_diff(maze, maze_diff.diff(small, small))
+    with self.assertRaises(ValueError):
+      maze_diff.apply_diff(maze, b'\xff\xff\xff')
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,88 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Export of mazes as graphs in compressed sparse row (CSR) form.
+
+The nodes of the graph of a maze are its open cells, numbered in row-major
+order, and its edges join neighbouring open cells both ways. The graph of
+several mazes is the disjoint union of their graphs, with the nodes of each
+maze numbered after those of the mazes before it, as batched by graph neural
+network libraries.
+
+The graph is returned as a dict of NumPy arrays that share the memory of the
+native graph, so no copies are made:
+
+  graph_offsets: [num_mazes + 1] int32. The nodes of maze k are
+      graph_offsets[k] to graph_offsets[k + 1] - 1.
+  row_offsets: [num_nodes + 1] int32. The neighbours of node n are
+      neighbours[row_offsets[n]:row_offsets[n + 1]].
+  neighbours: [num_edges] int32, ascending for each node.
+  node_cells: [num_nodes, 2] int32 (row, column) of each node in its maze.
+  cell_offsets: [num_mazes + 1] int32. The cells of maze k start at
+      cell_offsets[k] of cell_nodes.
+  cell_nodes: [total cells] int32 node of each cell in row-major order, or -1
+      for walls.
+
+and, if requested:
+
+  node_variations: [num_nodes] uint8 variations layer character of each node.
+  edge_directions: [num_edges] uint8 direction of each edge, one of UP, DOWN,
+      LEFT and RIGHT of `labmaze.directions`.
+  node_distances: [num_nodes] int32 shortest distance of each node from the
+      source cell of its maze, or -1 if it cannot be reached.
+"""
+
+from labmaze import directions as directions_lib
+from labmaze.cc.python import _maze_graph
+
+# Re-exported from `labmaze.directions`.
+UP = directions_lib.UP
+DOWN = directions_lib.DOWN
+LEFT = directions_lib.LEFT
+RIGHT = directions_lib.RIGHT
+
+
+def export_graphs(mazes, wall_chars='*', variations=False, directions=False,
+                  distance_sources=None, num_threads=0):
+  """Returns the graph of a batch of mazes.
+
+  Args:
+    mazes: A sequence of `BaseMaze` objects.
+    wall_chars: The entity layer characters of cells that are not nodes.
+    variations: Whether to export the `node_variations` feature.
+    directions: Whether to export the `edge_directions` feature.
+    distance_sources: If not None, a (row, column) cell for each maze from
+      which to export the `node_distances` feature.
+    num_threads: The number of threads to use, or 0 to use all cores.
+
+  Returns:
+    A dict of NumPy arrays, as described in the module docstring.
+  """
+  return _maze_graph.export_graphs(
+      entity_layers=[str(maze.entity_layer) for maze in mazes],
+      variations_layers=[str(maze.variations_layer) for maze in mazes],
+      wall_chars=wall_chars, variations=variations, directions=directions,
+      distance_sources=[tuple(source) for source in distance_sources or ()],
+      num_threads=num_threads)
+
+
+def export_graph(maze, wall_chars='*', variations=False, directions=False,
+                 distance_source=None):
+  """Returns the graph of a single maze, as `export_graphs` does."""
+  return export_graphs(
+      [maze], wall_chars=wall_chars, variations=variations,
+      directions=directions,
+      distance_sources=None if distance_source is None else [distance_source],
+      num_threads=1)
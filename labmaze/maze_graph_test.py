@@ -0,0 +1,71 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Tests for labmaze.maze_graph."""
+
+from absl.testing import absltest
+from labmaze import fixed_maze
+from labmaze import maze_graph
+import numpy as np
+
+_MAZE = (' * \n'
+         '   \n')
+_VARIATIONS = ('A.B\n'
+               '..C\n')
+
+
+class MazeGraphTest(absltest.TestCase):
+
+  def testExportGraph(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_MAZE, variations_layer=_VARIATIONS,
+        num_spawns=0, num_objects=0)
+    graph = maze_graph.export_graph(maze, variations=True, directions=True,
+                                    distance_source=(0, 2))
+    np.testing.assert_array_equal(graph['graph_offsets'], [0, 5])
+    np.testing.assert_array_equal(graph['row_offsets'], [0, 1, 2, 4, 6, 8])
+    np.testing.assert_array_equal(graph['neighbours'],
+                                  [2, 4, 0, 3, 2, 4, 1, 3])
+    np.testing.assert_array_equal(graph['node_cells'],
+                                  [[0, 0], [0, 2], [1, 0], [1, 1], [1, 2]])
+    np.testing.assert_array_equal(graph['cell_nodes'], [0, -1, 1, 2, 3, 4])
+    np.testing.assert_array_equal(graph['node_variations'],
+                                  [ord(c) for c in 'AB..C'])
+    np.testing.assert_array_equal(
+        graph['edge_directions'],
+        [maze_graph.DOWN, maze_graph.DOWN, maze_graph.UP, maze_graph.RIGHT,
+         maze_graph.LEFT, maze_graph.RIGHT, maze_graph.UP, maze_graph.LEFT])
+    np.testing.assert_array_equal(graph['node_distances'], [4, 0, 3, 2, 1])
+
+  def testExportGraphs(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_MAZE, num_spawns=0, num_objects=0)
+    graph = maze_graph.export_graphs([maze, maze, maze], num_threads=2)
+    self.assertNotIn('node_distances', graph)
+    np.testing.assert_array_equal(graph['graph_offsets'], [0, 5, 10, 15])
+    np.testing.assert_array_equal(graph['cell_offsets'], [0, 6, 12, 18])
+    self.assertLen(graph['neighbours'], 24)
+    np.testing.assert_array_equal(graph['neighbours'][16:],
+                                  [12, 14, 10, 13, 12, 14, 11, 13])
+
+  def testArraysOutliveEachOther(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_MAZE, num_spawns=0, num_objects=0)
+    neighbours = maze_graph.export_graph(maze)['neighbours']
+    np.testing.assert_array_equal(neighbours, [2, 4, 0, 3, 2, 4, 1, 3])
+
+
+if __name__ == '__main__':
+  absltest.main()
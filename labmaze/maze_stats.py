@@ -0,0 +1,87 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Summary statistics of batches of mazes, for bucketing them by difficulty.
+
+The statistics of a batch are returned as a structured NumPy array with one
+record per maze and the fields:
+
+  open_cells: int32 number of open cells.
+  wall_density: float64 fraction of all cells that are walls.
+  dead_ends: int32 number of open cells with exactly one open neighbour.
+  junctions: int32 number of open cells outside rooms with three or more open
+      neighbours.
+  corridor_lengths: [corridor_bins] int32 histogram of corridor lengths;
+      bin n counts the corridors of n cells, and the last bin those of
+      corridor_bins - 1 cells or more. A corridor is a maximal chain of open
+      cells outside rooms that have exactly two open neighbours each.
+  rooms: int32 number of rooms, as found by `FindRooms`.
+  room_cells: int32 number of cells in rooms.
+  components: int32 number of connected components of open cells.
+  largest_component: int32 number of cells in the largest component.
+  spawn_goal_distance: int32 distance from the first spawn point in row-major
+      order to the nearest object, or -1 if there is none.
+  branching_factor: float64 mean number of open neighbours of open cells less
+      one.
+"""
+
+from labmaze import defaults
+from labmaze.cc.python import _maze_stats
+import numpy as np
+
+
+def stats_dtype(corridor_bins=16):
+  """Returns the dtype of the records of `compute_stats`."""
+  return np.dtype([
+      ('open_cells', np.int32),
+      ('wall_density', np.float64),
+      ('dead_ends', np.int32),
+      ('junctions', np.int32),
+      ('corridor_lengths', np.int32, (corridor_bins,)),
+      ('rooms', np.int32),
+      ('room_cells', np.int32),
+      ('components', np.int32),
+      ('largest_component', np.int32),
+      ('spawn_goal_distance', np.int32),
+      ('branching_factor', np.float64),
+  ])
+
+
+def compute_stats(mazes, wall_chars='*', spawn_token=defaults.SPAWN_TOKEN,
+                  object_token=defaults.OBJECT_TOKEN, corridor_bins=16,
+                  num_threads=0):
+  """Returns the statistics of a batch of mazes.
+
+  Args:
+    mazes: A sequence of `BaseMaze` objects.
+    wall_chars: The entity layer characters of walls.
+    spawn_token: The entity layer character of spawn points.
+    object_token: The entity layer character of objects.
+    corridor_bins: The number of bins of the corridor length histogram.
+    num_threads: The number of threads to use, or 0 to use all cores.
+
+  Returns:
+    A [len(mazes)] structured NumPy array of dtype `stats_dtype(corridor_bins)`,
+    as described in the module docstring.
+  """
+  columns = _maze_stats.compute_stats(
+      entity_layers=[str(maze.entity_layer) for maze in mazes],
+      wall_chars=wall_chars, spawn_token=spawn_token,
+      object_token=object_token, corridor_bins=corridor_bins,
+      num_threads=num_threads)
+  result = np.empty(len(mazes), dtype=stats_dtype(corridor_bins))
+  for name in result.dtype.names:
+    result[name] = columns[name]
+  return result
@@ -0,0 +1,65 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Tests for labmaze.maze_stats."""
+
+from absl.testing import absltest
+from labmaze import fixed_maze
+from labmaze import maze_stats
+from labmaze import random_maze
+import numpy as np
+
+_CORRIDOR = ('*****\n'
+             '*  P*\n'
+             '* ***\n'
+             '*  G*\n'
+             '*****\n')
+
+
+class MazeStatsTest(absltest.TestCase):
+
+  def testCorridor(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_CORRIDOR, num_spawns=0, num_objects=0)
+    stats = maze_stats.compute_stats([maze], corridor_bins=4)
+    self.assertEqual(stats.dtype, maze_stats.stats_dtype(4))
+    self.assertLen(stats, 1)
+    self.assertEqual(stats['open_cells'][0], 7)
+    self.assertAlmostEqual(stats['wall_density'][0], 18 / 25)
+    self.assertEqual(stats['dead_ends'][0], 2)
+    self.assertEqual(stats['junctions'][0], 0)
+    # The corridor of 5 cells falls in the last bin.
+    np.testing.assert_array_equal(stats['corridor_lengths'][0], [0, 0, 0, 1])
+    self.assertEqual(stats['rooms'][0], 0)
+    self.assertEqual(stats['components'][0], 1)
+    self.assertEqual(stats['largest_component'][0], 7)
+    self.assertEqual(stats['spawn_goal_distance'][0], 6)
+    self.assertAlmostEqual(stats['branching_factor'][0], 12 / 7 - 1)
+
+  def testBatch(self):
+    mazes = [random_maze.RandomMaze(height=21, width=21, random_seed=seed)
+             for seed in range(5)]
+    stats = maze_stats.compute_stats(mazes, num_threads=2)
+    self.assertLen(stats, 5)
+    for k, maze in enumerate(mazes):
+      single = maze_stats.compute_stats([maze])
+      for name in stats.dtype.names:
+        np.testing.assert_array_equal(stats[name][k], single[name][0])
+      self.assertEqual(stats['open_cells'][k],
+                       np.sum(maze.entity_layer != '*'))
+
+
+if __name__ == '__main__':
+  absltest.main()
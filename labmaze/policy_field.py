@@ -0,0 +1,67 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Fields of optimal actions towards a goal cell of a maze.
+
+A field holds, for every cell of a maze, the direction of the first step of a
+shortest path to the goal, so that an expert policy costs one array lookup per
+step. It is returned as a dict of NumPy arrays:
+
+  directions: [height, width] uint8 direction of each cell, one of UP, DOWN,
+      LEFT and RIGHT. 0 for the goal, walls and cells that cannot reach it.
+  packed_directions: [ceil(height * width / 4)] uint8. The same directions at
+      2 bits per cell; cell k in row-major order is in bits 2 * (k % 4) and
+      2 * (k % 4) + 1 of byte k // 4.
+
+and, if requested:
+
+  ties: [height, width] uint8 set of all optimal directions of each cell, with
+      direction d in bit d. Empty for the goal, walls and cells that cannot
+      reach it.
+  packed_ties: [ceil(height * width / 2)] uint8. The same sets at 4 bits per
+      cell; cell k is in bits 4 * (k % 2) to 4 * (k % 2) + 3 of byte k // 2.
+"""
+
+from labmaze import directions
+from labmaze.cc.python import _policy_field
+
+# Re-exported from `labmaze.directions`.
+UP = directions.UP
+DOWN = directions.DOWN
+LEFT = directions.LEFT
+RIGHT = directions.RIGHT
+STEPS = directions.STEPS
+
+
+def policy_field(maze, goal, wall_chars='*', with_ties=False,
+                 random_seed=None):
+  """Returns the field of optimal actions towards a goal.
+
+  Args:
+    maze: A `BaseMaze` object.
+    goal: The (row, column) goal cell.
+    wall_chars: The entity layer characters of cells that cannot be entered.
+    with_ties: Whether to return the `ties` and `packed_ties` arrays.
+    random_seed: If None, cells with several optimal directions take the
+      first of them in the order UP, DOWN, LEFT and RIGHT. Otherwise they take
+      one picked at random with this seed.
+
+  Returns:
+    A dict of NumPy arrays, as described in the module docstring.
+  """
+  return _policy_field.policy_field(
+      entity_layer=str(maze.entity_layer), goal=tuple(goal),
+      wall_chars=wall_chars, with_ties=with_ties,
+      random_ties=random_seed is not None, random_seed=random_seed or 0)
@@ -0,0 +1,63 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Tests for labmaze.policy_field."""
+
+from absl.testing import absltest
+from labmaze import fixed_maze
+from labmaze import policy_field
+import numpy as np
+
+_MAZE = ('   \n'
+         ' * \n'
+         '   \n')
+
+
+class PolicyFieldTest(absltest.TestCase):
+
+  def testPolicyField(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_MAZE, num_spawns=0, num_objects=0)
+    field = policy_field.policy_field(maze, (2, 2), with_ties=True)
+    down, right = policy_field.DOWN, policy_field.RIGHT
+    np.testing.assert_array_equal(field['directions'],
+                                  [[down, right, down],
+                                   [down, 0, down],
+                                   [right, right, 0]])
+    np.testing.assert_array_equal(
+        field['ties'],
+        [[1 << down | 1 << right, 1 << right, 1 << down],
+         [1 << down, 0, 1 << down],
+         [1 << right, 1 << right, 0]])
+    self.assertLen(field['packed_directions'], 3)
+    self.assertLen(field['packed_ties'], 5)
+    unpacked = (field['packed_directions'][:, None] >> [0, 2, 4, 6]) & 3
+    np.testing.assert_array_equal(unpacked.ravel()[:9],
+                                  field['directions'].ravel())
+
+  def testRandomTiesFollowShortestPaths(self):
+    maze = fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_MAZE, num_spawns=0, num_objects=0)
+    field = policy_field.policy_field(maze, (2, 2), random_seed=1)
+    self.assertNotIn('ties', field)
+    row, col = 0, 0
+    for _ in range(4):
+      step = policy_field.STEPS[field['directions'][row, col]]
+      row, col = row + step[0], col + step[1]
+    self.assertEqual((row, col), (2, 2))
+
+
+if __name__ == '__main__':
+  absltest.main()
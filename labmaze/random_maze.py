@@ -19,6 +19,7 @@ from labmaze import base
 from labmaze import defaults
 from labmaze import text_grid
 from labmaze.cc.python import _random_maze
+from labmaze.cc.python import _text_maze
 import numpy as np
 
 
@@ -95,31 +96,64 @@ class RandomMaze(base.BaseMaze):
     self._max_rooms = max_rooms
     self._room_min_size = room_min_size
     self._room_max_size = room_max_size
+    self._retry_count = retry_count
+    self._extra_connection_probability = extra_connection_probability
     self._max_variations = max_variations
+    self._has_doors = has_doors
+    self._simplify = simplify
     self._spawns_per_room = spawns_per_room
     self._spawn_token = spawn_token
     self._objects_per_room = objects_per_room
     self._object_token = object_token
 
     self._native_maze = _random_maze.RandomMaze(
-        height=height, width=width, max_rooms=max_rooms,
-        room_min_size=room_min_size, room_max_size=room_max_size,
-        retry_count=retry_count,
-        extra_connection_probability=extra_connection_probability,
-        max_variations=max_variations,
-        has_doors=has_doors, simplify=simplify,
-        spawns_per_room=spawns_per_room, spawn_token=spawn_token,
-        objects_per_room=objects_per_room, object_token=object_token,
-        random_seed=random_seed)
+        random_seed=random_seed, **self._native_params())
+    self._update_from_native_maze()
+
+  def _update_from_native_maze(self):
     self._entity_layer = text_grid.TextGrid(self._native_maze.entity_layer)
     self._variations_layer = (
         text_grid.TextGrid(self._native_maze.variations_layer))
+    self._num_rooms = self._native_maze.num_rooms
+    self._region_doors = self._native_maze.region_doors
+
+  def _native_params(self):
+    return dict(
+        height=self._height, width=self._width, max_rooms=self._max_rooms,
+        room_min_size=self._room_min_size, room_max_size=self._room_max_size,
+        retry_count=self._retry_count,
+        extra_connection_probability=self._extra_connection_probability,
+        max_variations=self._max_variations,
+        has_doors=self._has_doors, simplify=self._simplify,
+        spawns_per_room=self._spawns_per_room, spawn_token=self._spawn_token,
+        objects_per_room=self._objects_per_room,
+        object_token=self._object_token)
+
+  def __getstate__(self):
+    """Returns the pickled state, with the layers and generator compact."""
+    state = self.__dict__.copy()
+    state['_prng_state'] = state.pop('_native_maze').prng_state
+    state['_layers'] = _text_maze.serialize(
+        str(state.pop('_entity_layer')), str(state.pop('_variations_layer')))
+    return state
+
+  def __setstate__(self, state):
+    state = state.copy()
+    entity_layer, variations_layer = _text_maze.deserialize(
+        state.pop('_layers'))
+    prng_state = state.pop('_prng_state')
+    self.__dict__.update(state)
+    # The native maze is restored from the generator state and the layers
+    # without generating a maze.
+    self._native_maze = _random_maze.RandomMaze.restore(
+        prng_state=prng_state, entity_layer=entity_layer,
+        variations_layer=variations_layer, **self._native_params())
+    self._entity_layer = text_grid.TextGrid(entity_layer)
+    self._variations_layer = text_grid.TextGrid(variations_layer)
 
   def regenerate(self):
     self._native_maze.regenerate()
-    self._entity_layer = text_grid.TextGrid(self._native_maze.entity_layer)
-    self._variations_layer = (
-        text_grid.TextGrid(self._native_maze.variations_layer))
+    self._update_from_native_maze()
 
   @property
   def entity_layer(self):
@@ -129,6 +163,26 @@ class RandomMaze(base.BaseMaze):
   def variations_layer(self):
     return self._variations_layer
 
+  @property
+  def num_rooms(self):
+    """Number of rooms, which are the regions with ids 1 to `num_rooms`."""
+    return self._num_rooms
+
+  @property
+  def region_doors(self):
+    """The open doors between regions of the maze.
+
+    These are the edges of the graph whose nodes are the region ids of the
+    rooms and corridors, so room connectivity can be read off without searching
+    the maze.
+
+    Returns:
+      A list of `(id_0, id_1, (row, col), (d_row, d_col))` tuples, one per door,
+      where the door at `(row, col)` joins region `id_0` on one side to region
+      `id_1` in direction `(d_row, d_col)`.
+    """
+    return self._region_doors
+
   @property
   def height(self):
     return self._height
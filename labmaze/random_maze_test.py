@@ -15,7 +15,9 @@
 
 """Tests for labmaze.RandomMaze."""
 
+import collections
 import copy
+import pickle
 
 from absl.testing import absltest
 import labmaze
@@ -140,6 +142,53 @@ class RandomMazeTest(absltest.TestCase):
       old_maze = copy.deepcopy(maze.entity_layer)
       old_variations = copy.deepcopy(maze.variations_layer)
 
+  def testRegionDoors(self):
+    maze = labmaze.RandomMaze(height=31, width=31, max_rooms=8,
+                              extra_connection_probability=0.1,
+                              random_seed=12345)
+    for _ in range(5):
+      maze.regenerate()
+      self.assertGreater(maze.num_rooms, 0)
+      # The doors are open and connect all regions, so every room can be
+      # reached from room 1 through the graph alone.
+      neighbours = collections.defaultdict(set)
+      for id_0, id_1, (row, col), (d_row, d_col) in maze.region_doors:
+        self.assertLess(id_0, id_1)
+        self.assertNotEqual(maze.entity_layer[row, col], '*')
+        self.assertNotEqual(maze.entity_layer[row - d_row, col - d_col], '*')
+        self.assertNotEqual(maze.entity_layer[row + d_row, col + d_col], '*')
+        neighbours[id_0].add(id_1)
+        neighbours[id_1].add(id_0)
+      reached = {1}
+      frontier = [1]
+      while frontier:
+        for neighbour in neighbours[frontier.pop()] - reached:
+          reached.add(neighbour)
+          frontier.append(neighbour)
+      self.assertEqual(reached, set(neighbours))
+      self.assertTrue(set(range(1, maze.num_rooms + 1)) <= reached)
+
+  def testPickle(self):
+    maze = labmaze.RandomMaze(height=21, width=31, spawns_per_room=1,
+                              objects_per_room=1, random_seed=12345)
+    maze.regenerate()
+    data = pickle.dumps(maze)
+    # The generator state is 16 bytes rather than a 6 KB text dump.
+    self.assertLess(len(data), 2000)
+    restored = pickle.loads(data)
+    self.assertEqual(str(restored.entity_layer), str(maze.entity_layer))
+    self.assertEqual(str(restored.variations_layer),
+                     str(maze.variations_layer))
+    self.assertEqual(restored.height, maze.height)
+    self.assertEqual(restored.spawn_token, maze.spawn_token)
+    self.assertEqual(restored.region_doors, maze.region_doors)
+    for _ in range(3):
+      maze.regenerate()
+      restored.regenerate()
+      self.assertEqual(str(restored.entity_layer), str(maze.entity_layer))
+      self.assertEqual(str(restored.variations_layer),
+                       str(maze.variations_layer))
+
   def testGoldenMazeRegeneration(self):
     # This test makes sure that regeneration logic is not operating on an
     # old, dirty maze object.
@@ -0,0 +1,61 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Cheapest distances to a goal over cells with different traversal costs.
+
+Entering a cell costs the cost of its variations layer character plus the
+cost of its entity layer character, so that, for instance, the floors of a
+room style can be made slow. The distance of a route is the sum of the costs
+of the cells it enters, including the goal but not its start; with all costs
+at their defaults it is the number of steps.
+"""
+
+from labmaze.cc.python import _weighted_flood_fill
+
+# The largest cost of entering a cell, summed over both layers; matches
+# kMaxCellCost in labmaze/cc/weighted_flood_fill.h.
+MAX_CELL_COST = 1 << 16
+
+
+def weighted_distances(maze, goal, variation_costs=None, entity_costs=None,
+                       wall_chars='*', default_cost=1):
+  """Returns the least distance to a goal from every cell of a maze.
+
+  The cost of entering a cell, its entity and variation costs together, shall
+  be at most `MAX_CELL_COST`.
+
+  Args:
+    maze: A `BaseMaze` object.
+    goal: The (row, column) goal cell.
+    variation_costs: A dict from variations layer characters to the positive
+      cost of entering cells with them. Other characters cost `default_cost`.
+    entity_costs: A dict from entity layer characters to a non-negative cost
+      added for entering cells with them. Other characters add nothing.
+    wall_chars: The entity layer characters of cells that cannot be entered.
+    default_cost: The positive cost of variations layer characters not in
+      `variation_costs`.
+
+  Returns:
+    A [height, width] int32 NumPy array of the distance from each cell to the
+    goal, or -1 for walls and cells that cannot reach it.
+
+  Raises:
+    ValueError: If a cost is out of range or keyed by more than one character.
+  """
+  return _weighted_flood_fill.weighted_distances(
+      entity_layer=str(maze.entity_layer),
+      variations_layer=str(maze.variations_layer), goal=tuple(goal),
+      wall_chars=wall_chars, entity_costs=entity_costs or {},
+      variation_costs=variation_costs or {}, default_cost=default_cost)
@@ -0,0 +1,73 @@
+# Copyright 2019 DeepMind Technologies Limited.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""Tests for labmaze.weighted_flood_fill."""
+
+from absl.testing import absltest
+from labmaze import fixed_maze
+from labmaze import weighted_flood_fill
+import numpy as np
+
+_ENTITY_LAYER = ('     \n'
+                 ' *** \n'
+                 '     \n')
+
+_VARIATIONS_LAYER = ('.BBB.\n'
+                     '.....\n'
+                     '.....\n')
+
+
+class WeightedFloodFillTest(absltest.TestCase):
+
+  def _maze(self):
+    return fixed_maze.FixedMazeWithRandomGoals(
+        entity_layer=_ENTITY_LAYER, variations_layer=_VARIATIONS_LAYER,
+        num_spawns=0, num_objects=0)
+
+  def testUnitCosts(self):
+    distances = weighted_flood_fill.weighted_distances(self._maze(), (0, 4))
+    self.assertEqual(distances.dtype, np.int32)
+    np.testing.assert_array_equal(distances,
+                                  [[4, 3, 2, 1, 0],
+                                   [5, -1, -1, -1, 1],
+                                   [6, 5, 4, 3, 2]])
+
+  def testVariationCosts(self):
+    distances = weighted_flood_fill.weighted_distances(
+        self._maze(), (0, 4), variation_costs={'B': 5})
+    np.testing.assert_array_equal(distances,
+                                  [[8, 9, 6, 1, 0],
+                                   [7, -1, -1, -1, 1],
+                                   [6, 5, 4, 3, 2]])
+
+  def testInvalidCosts(self):
+    with self.assertRaises(ValueError):
+      weighted_flood_fill.weighted_distances(
+          self._maze(), (0, 4), variation_costs={'B': 0})
+    with self.assertRaises(ValueError):
+      weighted_flood_fill.weighted_distances(
+          self._maze(), (0, 4), entity_costs={'  ': 1})
+    with self.assertRaises(ValueError):
+      weighted_flood_fill.weighted_distances(
+          self._maze(), (0, 4),
+          default_cost=weighted_flood_fill.MAX_CELL_COST + 1)
+    with self.assertRaises(ValueError):
+      weighted_flood_fill.weighted_distances(
+          self._maze(), (0, 4),
+          entity_costs={' ': weighted_flood_fill.MAX_CELL_COST})
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -125,7 +125,12 @@ setuptools.setup(
     license='Apache 2.0',
     ext_modules=[
         BazelExtension('//labmaze/cc/python:_defaults'),
+        BazelExtension('//labmaze/cc/python:_maze_graph'),
+        BazelExtension('//labmaze/cc/python:_maze_stats'),
+        BazelExtension('//labmaze/cc/python:_policy_field'),
         BazelExtension('//labmaze/cc/python:_random_maze'),
+        BazelExtension('//labmaze/cc/python:_text_maze'),
+        BazelExtension('//labmaze/cc/python:_weighted_flood_fill'),
     ],
     cmdclass=dict(build_ext=BuildBazelExtension),
     packages=setuptools.find_packages(),